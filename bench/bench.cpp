@@ -0,0 +1,415 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   bench.cpp
+
+   nslfem-spring1d benchmark harness.
+
+   Generates synthetic models (see Generator.h) of increasing size,
+   runs parse, assemble, solve and post-processing on each of them
+   and writes the time and counters of each phase as CSV (and
+   optionally JSON).  In compare mode the results are checked
+   against a stored baseline and regressions are flagged.
+
+   Usage: see help() or `bin/nslfem-bench --help'.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#include <unistd.h>
+
+#include "FEM.h"
+#include "Generator.h"
+#include "Profiler.h"
+
+namespace {
+
+// =========================================================
+// Settings
+// ---------------------------------------------------------
+
+struct Settings {
+  std::vector<nsl::Generator::Topology> topologies;
+  std::size_t minNodes      = 100;
+  std::size_t maxNodes      = 100000;
+  std::size_t maxSolveNodes = 1000000; // Larger models are only parsed
+  int repeat                = 1;
+  std::string csvFile;
+  std::string jsonFile;
+  std::string compareFile;
+  double threshold          = 0.10;    // Allowed slowdown: 10%
+  double noiseFloor         = 1e-3;    // Shorter phases are not compared [s]
+  std::string tmpDir        = "/tmp";
+};
+
+// =========================================================
+// Results
+// ---------------------------------------------------------
+
+/**
+   Measurement of a single phase.
+*/
+struct Result {
+  std::string topology;
+  std::size_t nodes;
+  std::size_t springs;
+  std::string phase;
+  double seconds;
+  std::uint64_t flops;
+  std::uint64_t bytes;
+
+  std::string key() const
+  {
+    std::ostringstream os;
+    os << topology << "/" << nodes << "/" << phase;
+    return os.str();
+  }
+};
+
+// The measured phases (names of the Profiler phases)
+const char *phases[] = { "parse", "assemble", "solve", "post-process" };
+
+/**
+   Print help text.
+ */
+void help()
+{
+  std::cout
+    << "Usage: nslfem-bench [options]" << std::endl
+    << std::endl
+    << "Options:" << std::endl
+    << std::endl
+    << "  -h, --help                  Print this help text" << std::endl
+    << "  --topology=<t>              chain, bundle, tree, grid or random" << std::endl
+    << "                              (repeatable; default: all)" << std::endl
+    << "  --min-nodes=<n>             Smallest model (default: 100)" << std::endl
+    << "  --max-nodes=<n>             Largest model (default: 100000); sizes grow by 10x" << std::endl
+    << "  --max-solve-nodes=<n>       Only parse larger models (default: 1000000)" << std::endl
+    << "  --repeat=<n>                Repetitions, the fastest one is reported (default: 1)" << std::endl
+    << "  --csv=<file>                Write the results as CSV to <file> (default: stdout)" << std::endl
+    << "  --json=<file>               Write the results as JSON to <file>" << std::endl
+    << "  --compare=<baseline.csv>    Flag regressions against a baseline CSV file" << std::endl
+    << "  --threshold=<fraction>      Allowed slowdown in compare mode (default: 0.10)" << std::endl
+    << "  --tmpdir=<dir>              Directory for the generated models (default: /tmp)" << std::endl
+    ;
+}
+
+/**
+   Value of an option of the form --name=value.
+*/
+bool option(const char *arg, const char *name, std::string &value)
+{
+  std::size_t n = strlen(name);
+  if (strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+
+  value = arg + n + 1;
+  return true;
+}
+
+/**
+   Parse the command-line arguments.
+*/
+Settings parseArguments(int argc, char* argv[])
+{
+  Settings settings;
+  std::string value;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      const char *arg = argv[i];
+
+      if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
+	{
+	  help();
+	  exit(EXIT_SUCCESS);
+	}
+      else if (option(arg, "--topology", value))
+	{
+	  nsl::Generator::Topology topology;
+	  if (!nsl::Generator::parseTopology(value, topology))
+	    {
+	      std::cerr << "ERROR: Unknown topology: " << value << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  settings.topologies.push_back(topology);
+	}
+      else if (option(arg, "--min-nodes", value))       settings.minNodes      = std::stoul(value);
+      else if (option(arg, "--max-nodes", value))       settings.maxNodes      = std::stoul(value);
+      else if (option(arg, "--max-solve-nodes", value)) settings.maxSolveNodes = std::stoul(value);
+      else if (option(arg, "--repeat", value))          settings.repeat        = std::max(1, std::stoi(value));
+      else if (option(arg, "--csv", value))             settings.csvFile       = value;
+      else if (option(arg, "--json", value))            settings.jsonFile      = value;
+      else if (option(arg, "--compare", value))         settings.compareFile   = value;
+      else if (option(arg, "--threshold", value))       settings.threshold     = std::stod(value);
+      else if (option(arg, "--tmpdir", value))          settings.tmpDir        = value;
+      else
+	{
+	  std::cerr << "ERROR: Unknown option: " << arg << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+    }
+
+  if (settings.topologies.empty())
+    for (int t = nsl::Generator::CHAIN; t <= nsl::Generator::RANDOM; ++t)
+      settings.topologies.push_back((nsl::Generator::Topology) t);
+
+  return settings;
+}
+
+// =========================================================
+// Benchmark
+// ---------------------------------------------------------
+
+/**
+   Run all phases once on the given model file.
+
+   The output of the program (input file list etc.) is suppressed.
+*/
+void runOnce(const std::string &file, bool solve)
+{
+  std::streambuf *cout = std::cout.rdbuf();
+  std::ostringstream null;
+  std::cout.rdbuf(null.rdbuf());
+
+  {
+    nsl::FEM fem(std::vector<std::string>(1, file));
+
+    if (solve)
+      {
+	fem.solve();
+
+	nsl::ScopedTimer timer("post-process");
+	nsl::ElementResults results;
+	fem.calculateElementResults(results);
+	fem.getGlobalForceVector();
+      }
+  }
+
+  std::cout.rdbuf(cout);
+}
+
+/**
+   Benchmark a single model; the fastest of settings.repeat runs is
+   reported for each phase.
+*/
+void benchmark(const Settings &settings, nsl::Generator::Topology topology,
+	       std::size_t nodes, std::vector<Result> &results)
+{
+  nsl::Generator generator(topology, nodes);
+
+  // Write the model
+  std::ostringstream file;
+  file << settings.tmpDir << "/nslfem-bench-" << getpid() << ".fem";
+  {
+    std::ofstream out(file.str());
+    if (!out.good())
+      {
+	std::cerr << "ERROR: Could not write: " << file.str() << std::endl;
+	exit(EXIT_FAILURE);
+      }
+    generator.write(out);
+  }
+
+  bool solve = nodes <= settings.maxSolveNodes;
+
+  std::vector<Result> best;
+  for (int r = 0; r < settings.repeat; ++r)
+    {
+      nsl::Profiler::reset();
+      runOnce(file.str(), solve);
+
+      for (std::size_t p = 0; p < sizeof(phases) / sizeof(phases[0]); ++p)
+	{
+	  if (!solve && p > 0) break;
+
+	  Result result;
+	  result.topology = nsl::Generator::topologyName(topology);
+	  result.nodes    = generator.numberOfNodes();
+	  result.springs  = generator.numberOfSprings();
+	  result.phase    = phases[p];
+	  result.seconds  = nsl::Profiler::phaseSeconds(phases[p]);
+	  result.flops    = nsl::Profiler::phaseCounter(phases[p], nsl::Profiler::FLOPS);
+	  result.bytes    = nsl::Profiler::phaseCounter(phases[p], nsl::Profiler::BYTES);
+
+	  if (r == 0)
+	    best.push_back(result);
+	  else if (result.seconds < best[p].seconds)
+	    best[p] = result;
+	}
+    }
+
+  std::remove(file.str().c_str());
+
+  results.insert(results.end(), best.begin(), best.end());
+
+  // Progress
+  std::cerr << "  " << nsl::Generator::topologyName(topology) << " " << nodes
+	    << (solve ? "" : " (parse only)") << std::endl;
+}
+
+// =========================================================
+// Output
+// ---------------------------------------------------------
+
+/**
+   Write the results as CSV.
+*/
+void writeCSV(std::ostream &os, const std::vector<Result> &results)
+{
+  os << "topology,nodes,springs,phase,seconds,flops,bytes" << std::endl;
+  for (const auto &r : results)
+    os << r.topology << "," << r.nodes << "," << r.springs << ","
+       << r.phase << "," << r.seconds << "," << r.flops << "," << r.bytes << std::endl;
+}
+
+/**
+   Write the results as JSON.
+*/
+void writeJSON(std::ostream &os, const std::vector<Result> &results)
+{
+  os << "[";
+  for (std::size_t i = 0; i < results.size(); ++i)
+    {
+      const Result &r = results[i];
+      os << (i > 0 ? "," : "") << std::endl
+	 << "  { \"topology\": \"" << r.topology << "\""
+	 << ", \"nodes\": " << r.nodes
+	 << ", \"springs\": " << r.springs
+	 << ", \"phase\": \"" << r.phase << "\""
+	 << ", \"seconds\": " << r.seconds
+	 << ", \"flops\": " << r.flops
+	 << ", \"bytes\": " << r.bytes << " }";
+    }
+  os << std::endl << "]" << std::endl;
+}
+
+/**
+   Read results from a CSV file written by writeCSV().
+*/
+std::vector<Result> readCSV(const std::string &file)
+{
+  std::ifstream in(file);
+  if (!in.good())
+    {
+      std::cerr << "ERROR: Could not open baseline: " << file << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  std::vector<Result> results;
+  std::string line;
+  std::getline(in, line); // header
+  while (std::getline(in, line))
+    {
+      std::istringstream is(line);
+      std::string field;
+      std::vector<std::string> fields;
+      while (std::getline(is, field, ','))
+	fields.push_back(field);
+      if (fields.size() != 7) continue;
+
+      Result r;
+      r.topology = fields[0];
+      r.nodes    = std::stoul(fields[1]);
+      r.springs  = std::stoul(fields[2]);
+      r.phase    = fields[3];
+      r.seconds  = std::stod(fields[4]);
+      r.flops    = std::stoull(fields[5]);
+      r.bytes    = std::stoull(fields[6]);
+      results.push_back(r);
+    }
+
+  return results;
+}
+
+/**
+   Compare the results with a baseline.
+
+   Returns the number of regressions: phases which took longer than
+   (1 + threshold) times the baseline.  Phases shorter than the noise
+   floor in both runs are ignored.
+*/
+int compare(const Settings &settings, const std::vector<Result> &results)
+{
+  std::map<std::string, Result> baseline;
+  for (const auto &r : readCSV(settings.compareFile))
+    baseline[r.key()] = r;
+
+  int regressions = 0;
+  std::cerr << std::endl << "Comparison with " << settings.compareFile << ":" << std::endl << std::endl;
+  for (const auto &r : results)
+    {
+      std::map<std::string, Result>::const_iterator it = baseline.find(r.key());
+      if (it == baseline.end()) continue;
+
+      double base = it->second.seconds;
+      double ratio = base > 0 ? r.seconds / base : 1;
+      bool significant = std::max(r.seconds, base) >= settings.noiseFloor;
+      bool regression = significant && ratio > 1 + settings.threshold;
+      if (regression) ++regressions;
+
+      std::cerr << "  " << (regression ? "REGRESSION " : "           ") << r.key()
+		<< ": " << base << " s -> " << r.seconds << " s"
+		<< " (x" << ratio << ")" << std::endl;
+    }
+  std::cerr << std::endl << regressions << " regression(s)" << std::endl;
+
+  return regressions;
+}
+
+} // namespace
+
+/**
+   Main.
+ */
+int main(int argc, char* argv[])
+{
+  Settings settings = parseArguments(argc, argv);
+
+  nsl::Profiler::enable();
+
+  // Run the benchmarks
+  std::cerr << "Benchmarks:" << std::endl << std::endl;
+  std::vector<Result> results;
+  for (auto topology : settings.topologies)
+    for (std::size_t nodes = std::max<std::size_t>(1, settings.minNodes); 
+	 nodes <= settings.maxNodes; nodes *= 10)
+      benchmark(settings, topology, nodes, results);
+
+  // Write the results
+  if (settings.csvFile.empty())
+    writeCSV(std::cout, results);
+  else
+    {
+      std::ofstream out(settings.csvFile);
+      writeCSV(out, results);
+    }
+
+  if (!settings.jsonFile.empty())
+    {
+      std::ofstream out(settings.jsonFile);
+      writeJSON(out, results);
+    }
+
+  // Compare with the baseline
+  if (!settings.compareFile.empty() && compare(settings, results) > 0)
+    return EXIT_FAILURE;
+
+  return EXIT_SUCCESS;
+}
+
+/* fin */
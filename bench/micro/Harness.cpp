@@ -0,0 +1,188 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Harness.cpp
+
+   Class: Harness
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+
+#include "Harness.h"
+
+namespace nsl {
+
+// =========================================================
+// Class Harness
+// ---------------------------------------------------------
+
+Harness::Harness(std::size_t warmup, std::size_t samples)
+  : _warmup(warmup), _samples(samples < 1 ? 1 : samples), _usePerfCounters(true)
+{}
+
+void Harness::setWarmup(std::size_t warmup)
+{
+  _warmup = warmup;
+}
+
+void Harness::setSamples(std::size_t samples)
+{
+  _samples = samples < 1 ? 1 : samples;
+}
+
+/**
+   Switch the hardware counters on or off.
+*/
+void Harness::setPerfCounters(bool on)
+{
+  _usePerfCounters = on;
+}
+
+/**
+   Run a benchmark and store its result.
+*/
+const Harness::Result &Harness::run(const std::string &name,
+				    std::function<void ()> setup,
+				    std::function<void ()> body,
+				    std::size_t batch)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  if (batch < 1) batch = 1;
+
+  PerfCounters counters;
+  bool perf = _usePerfCounters && counters.available();
+
+  std::vector<double> times, cycles, instructions, cacheMisses;
+
+  for (std::size_t s = 0; s < _warmup + _samples; ++s)
+    {
+      if (setup) setup();
+
+      if (perf) counters.start();
+      Clock::time_point t0 = Clock::now();
+      for (std::size_t b = 0; b < batch; ++b) body();
+      Clock::time_point t1 = Clock::now();
+      if (perf) counters.stop();
+
+      if (s < _warmup) continue;
+
+      times.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / batch);
+      if (perf)
+	{
+	  cycles.push_back(double(counters.value(PerfCounters::CYCLES)) / batch);
+	  instructions.push_back(double(counters.value(PerfCounters::INSTRUCTIONS)) / batch);
+	  cacheMisses.push_back(double(counters.value(PerfCounters::CACHE_MISSES)) / batch);
+	}
+    }
+
+  Result result;
+  result.name         = name;
+  result.samples      = _samples;
+  result.batch        = batch;
+  result.medianNs     = median(times);
+  result.madNs        = mad(times);
+  result.cycles       = perf ? median(cycles)       : -1;
+  result.instructions = perf ? median(instructions) : -1;
+  result.cacheMisses  = perf ? median(cacheMisses)  : -1;
+
+  _results.push_back(result);
+  return _results.back();
+}
+
+const std::vector<Harness::Result> &Harness::results() const
+{
+  return _results;
+}
+
+/**
+   Human readable table of all results.
+*/
+void Harness::printTable(std::ostream &os) const
+{
+  os << std::left << std::setw(36) << "benchmark"
+     << std::right
+     << std::setw(14) << "median [ns]"
+     << std::setw(12) << "MAD [ns]"
+     << std::setw(14) << "cycles"
+     << std::setw(14) << "instructions"
+     << std::setw(14) << "cache-misses"
+     << std::endl;
+
+  for (const Result &r : _results)
+    {
+      os << std::left << std::setw(36) << r.name
+	 << std::right << std::fixed << std::setprecision(1)
+	 << std::setw(14) << r.medianNs
+	 << std::setw(12) << r.madNs;
+      if (r.cycles < 0)
+	os << std::setw(14) << "-" << std::setw(14) << "-" << std::setw(14) << "-";
+      else
+	os << std::setw(14) << r.cycles
+	   << std::setw(14) << r.instructions
+	   << std::setw(14) << r.cacheMisses;
+      os << std::endl;
+    }
+  os.unsetf(std::ios::floatfield);
+}
+
+/**
+   All results as CSV.  Unavailable counters are left empty.
+*/
+void Harness::writeCSV(std::ostream &os) const
+{
+  os << "benchmark,samples,batch,median_ns,mad_ns,cycles,instructions,cache_misses" << std::endl;
+  for (const Result &r : _results)
+    {
+      os << r.name << ',' << r.samples << ',' << r.batch << ','
+	 << r.medianNs << ',' << r.madNs << ',';
+      if (r.cycles >= 0)
+	os << r.cycles << ',' << r.instructions << ',' << r.cacheMisses;
+      else
+	os << ",,";
+      os << std::endl;
+    }
+}
+
+/**
+   Median of a set of values; 0 for an empty set.
+*/
+double Harness::median(std::vector<double> values)
+{
+  if (values.empty()) return 0;
+
+  std::size_t n = values.size();
+  std::nth_element(values.begin(), values.begin() + n / 2, values.end());
+  double upper = values[n / 2];
+  if (n % 2) return upper;
+
+  double lower = *std::max_element(values.begin(), values.begin() + n / 2);
+  return 0.5 * (lower + upper);
+}
+
+/**
+   Median absolute deviation from the median.
+*/
+double Harness::mad(const std::vector<double> &values)
+{
+  double m = median(values);
+
+  std::vector<double> deviations;
+  deviations.reserve(values.size());
+  for (double v : values) deviations.push_back(std::fabs(v - m));
+
+  return median(deviations);
+}
+
+} // namespace nsl
+
+/* fin */
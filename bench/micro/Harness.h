@@ -0,0 +1,99 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Harness.h
+
+   Class: Harness
+
+   Microbenchmark harness for single kernels.
+
+   A benchmark consists of a setup function, which is run before
+   every sample and is not measured, and a body, which is run
+   `batch' times per sample.  After a number of warmup samples the
+   time per call of the body is measured for a number of samples
+   and summarised by the median and the median absolute deviation
+   (MAD), which are both robust against outliers caused by
+   interrupts or frequency changes.  When hardware counters are
+   available (see PerfCounters.h) the median of the cycles,
+   instructions and cache misses per call are reported as well.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Harness__
+#define __Harness__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <functional>
+
+#include "PerfCounters.h"
+
+namespace nsl {
+
+// =========================================================
+// class Harness
+// ---------------------------------------------------------
+
+class Harness {
+
+ public:
+  struct Result {
+    std::string name;
+    std::size_t samples;
+    std::size_t batch;
+    double medianNs;                   // Time per call [ns]
+    double madNs;                      // Median absolute deviation [ns]
+    double cycles;                     // Per call, -1: not available
+    double instructions;
+    double cacheMisses;
+  };
+
+ private:
+  std::size_t _warmup;
+  std::size_t _samples;
+  bool _usePerfCounters;
+  std::vector<Result> _results;
+
+ public:
+  Harness(std::size_t warmup = 3, std::size_t samples = 21);
+
+  void setWarmup(std::size_t warmup);
+  void setSamples(std::size_t samples);
+  void setPerfCounters(bool on);
+
+  const Result &run(const std::string &name,
+		    std::function<void ()> setup,
+		    std::function<void ()> body,
+		    std::size_t batch = 1);
+
+  const std::vector<Result> &results() const;
+
+  void printTable(std::ostream &os) const;
+  void writeCSV(std::ostream &os) const;
+
+  static double median(std::vector<double> values);
+  static double mad(const std::vector<double> &values);
+};
+
+/**
+   Prevents the compiler from optimising away the computation of a
+   value which is not used otherwise.
+*/
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+} // namespace nsl
+
+#endif /* defined(__Harness__) */
+
+/* fin */
@@ -0,0 +1,139 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   PerfCounters.cpp
+
+   Class: PerfCounters
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstring>
+
+#ifdef __linux__
+#  include <unistd.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <linux/perf_event.h>
+#endif
+
+#include "PerfCounters.h"
+
+namespace nsl {
+
+// =========================================================
+// Class PerfCounters
+// ---------------------------------------------------------
+
+PerfCounters::PerfCounters() : _available(false)
+{
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c)
+    {
+      _fd[c] = -1;
+      _values[c] = 0;
+    }
+
+#ifdef __linux__
+  const std::uint64_t configs[NUMBER_OF_COUNTERS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES
+  };
+
+  _available = true;
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c)
+    {
+      struct perf_event_attr attr;
+      memset(&attr, 0, sizeof(attr));
+      attr.size           = sizeof(attr);
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.config         = configs[c];
+      attr.disabled       = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+
+      // Counting for the current thread on any CPU
+      _fd[c] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (_fd[c] < 0) _available = false;
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c)
+    if (_fd[c] >= 0) close(_fd[c]);
+#endif
+}
+
+/**
+   Name of a counter.
+*/
+const char *PerfCounters::name(Counter counter)
+{
+  switch (counter)
+    {
+    case CYCLES:       return "cycles";
+    case INSTRUCTIONS: return "instructions";
+    case CACHE_MISSES: return "cache-misses";
+    default:           return "unknown";
+    }
+}
+
+/**
+   True when the hardware counters can be read.
+*/
+bool PerfCounters::available() const
+{
+  return _available;
+}
+
+/**
+   Reset and start counting.
+*/
+void PerfCounters::start()
+{
+#ifdef __linux__
+  if (!_available) return;
+  
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c)
+    {
+      ioctl(_fd[c], PERF_EVENT_IOC_RESET, 0);
+      ioctl(_fd[c], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+   Stop counting and read the counters.
+*/
+void PerfCounters::stop()
+{
+#ifdef __linux__
+  if (!_available) return;
+
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c)
+    {
+      ioctl(_fd[c], PERF_EVENT_IOC_DISABLE, 0);
+      if (read(_fd[c], &_values[c], sizeof(_values[c])) != sizeof(_values[c]))
+	_values[c] = 0;
+    }
+#endif
+}
+
+/**
+   Value of a counter between the last start() and stop().
+*/
+std::uint64_t PerfCounters::value(Counter counter) const
+{
+  return _values[counter];
+}
+
+} // namespace nsl
+
+/* fin */
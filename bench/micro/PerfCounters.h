@@ -0,0 +1,69 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   PerfCounters.h
+
+   Class: PerfCounters
+
+   Hardware performance counters (cycles, instructions, cache
+   misses) of the current thread via the Linux perf_event_open
+   system call.  When the counters are not available (other
+   operating system, missing permission - see
+   /proc/sys/kernel/perf_event_paranoid - or a container without
+   access to the PMU) available() is false and all values are 0.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __PerfCounters__
+#define __PerfCounters__
+
+#include <cstdint>
+
+namespace nsl {
+
+// =========================================================
+// class PerfCounters
+// ---------------------------------------------------------
+
+class PerfCounters {
+
+ public:
+  enum Counter {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    NUMBER_OF_COUNTERS
+  };
+
+ private:
+  int _fd[NUMBER_OF_COUNTERS];
+  std::uint64_t _values[NUMBER_OF_COUNTERS];
+  bool _available;
+
+ public:
+  PerfCounters();
+  ~PerfCounters();
+
+  static const char *name(Counter counter);
+
+  bool available() const;
+
+  void start();
+  void stop();
+  std::uint64_t value(Counter counter) const;
+
+ private:
+  PerfCounters(const PerfCounters &);
+  PerfCounters &operator= (const PerfCounters &);
+};
+
+} // namespace nsl
+
+#endif /* defined(__PerfCounters__) */
+
+/* fin */
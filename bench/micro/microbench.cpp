@@ -0,0 +1,275 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   microbench.cpp
+
+   nslfem-spring1d kernel microbenchmarks.
+
+   Measures the building blocks of the solver on their own:
+   DMatrix::swapRows, DMatrix::deleteRowsAndColumns,
+   DMatrix::gaussianElimination, the matrix-vector product,
+   DVector::deleteElements and Spring::stiffnessMatrix.  The
+   matrices are stiffness matrices of a chain of n springs, the
+   same structure the solver sees for the examples.
+
+   Usage: see help() or `bin/nslfem-microbench --help'.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+#include "Node.h"
+#include "Spring.h"
+#include "DMatrix.h"
+#include "DVector.h"
+#include "Harness.h"
+
+namespace {
+
+// =========================================================
+// Settings
+// ---------------------------------------------------------
+
+struct Settings {
+  std::size_t size    = 256;           // Matrix dimension
+  std::size_t warmup  = 3;
+  std::size_t samples = 21;
+  bool perfCounters   = true;
+  std::string filter;                  // Only benchmarks containing this string
+  std::string csvFile;
+};
+
+// =========================================================
+// Command line
+// ---------------------------------------------------------
+
+void help()
+{
+  std::cout
+    << "Usage: nslfem-microbench [options]" << std::endl
+    << std::endl
+    << "Options:" << std::endl
+    << std::endl
+    << "  -h, --help                  Print this help text" << std::endl
+    << "  --size=<n>                  Matrix dimension (default: 256)" << std::endl
+    << "  --warmup=<n>                Unmeasured samples (default: 3)" << std::endl
+    << "  --samples=<n>               Measured samples (default: 21)" << std::endl
+    << "  --filter=<string>           Only run benchmarks whose name contains <string>" << std::endl
+    << "  --no-perf                   Do not read the hardware counters" << std::endl
+    << "  --csv=<file>                Also write the results as CSV to <file>" << std::endl
+    ;
+}
+
+/**
+   Value of an option of the form --name=value.
+*/
+bool option(const char *arg, const char *name, std::string &value)
+{
+  std::size_t n = strlen(name);
+  if (strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+
+  value = arg + n + 1;
+  return true;
+}
+
+/**
+   Parse the command-line arguments.
+*/
+Settings parseArguments(int argc, char* argv[])
+{
+  Settings settings;
+  std::string value;
+
+  for (int i = 1; i < argc; ++i)
+    {
+      const char *arg = argv[i];
+
+      if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
+	{
+	  help();
+	  exit(EXIT_SUCCESS);
+	}
+      else if (option(arg, "--size", value))
+	settings.size = strtoul(value.c_str(), nullptr, 10);
+      else if (option(arg, "--warmup", value))
+	settings.warmup = strtoul(value.c_str(), nullptr, 10);
+      else if (option(arg, "--samples", value))
+	settings.samples = strtoul(value.c_str(), nullptr, 10);
+      else if (option(arg, "--filter", value))
+	settings.filter = value;
+      else if (strcmp(arg, "--no-perf") == 0)
+	settings.perfCounters = false;
+      else if (option(arg, "--csv", value))
+	settings.csvFile = value;
+      else
+	{
+	  std::cerr << "Unknown option: " << arg << std::endl;
+	  help();
+	  exit(EXIT_FAILURE);
+	}
+    }
+
+  if (settings.size < 2)
+    {
+      std::cerr << "The matrix dimension has to be at least 2." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  return settings;
+}
+
+// =========================================================
+// Test data
+// ---------------------------------------------------------
+
+/**
+   Stiffness matrix of a chain of n - 1 springs with spring
+   constants 1, 2, ..., n - 1, the first node being fixed
+   (diagonal element 1 in row 0) so that the matrix is regular.
+*/
+nsl::DMatrix chainStiffnessMatrix(std::size_t n)
+{
+  nsl::DMatrix m(n, n);
+
+  m(0, 0) = 1;
+  for (std::size_t s = 0; s + 1 < n; ++s)
+    {
+      double k = double(s + 1);
+      if (s > 0) m(s, s) += k;
+      m(s + 1, s + 1) += k;
+      if (s > 0)
+	{
+	  m(s, s + 1) -= k;
+	  m(s + 1, s) -= k;
+	}
+    }
+
+  return m;
+}
+
+nsl::DVector rampVector(std::size_t n)
+{
+  nsl::DVector v(n);
+  for (std::size_t i = 0; i < n; ++i) v(i) = double(i + 1);
+  return v;
+}
+
+} // namespace
+
+// =========================================================
+// main
+// ---------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+  Settings settings = parseArguments(argc, argv);
+  std::size_t n = settings.size;
+
+  nsl::Harness harness(settings.warmup, settings.samples);
+  harness.setPerfCounters(settings.perfCounters);
+
+  auto selected = [&settings] (const std::string &name) {
+    return settings.filter.empty() || name.find(settings.filter) != std::string::npos;
+  };
+  std::string suffix = "/" + std::to_string(n);
+
+  const nsl::DMatrix stiffness = chainStiffnessMatrix(n);
+  const nsl::DVector ramp      = rampVector(n);
+
+  // The predicate of the delete benchmarks: every 10th row / element
+  auto everyTenth = [] (std::size_t i) { return i % 10 == 0; };
+
+  // DMatrix::swapRows
+  if (selected("DMatrix::swapRows"))
+    {
+      nsl::DMatrix m(stiffness);
+      std::size_t i = 0;
+      harness.run("DMatrix::swapRows" + suffix, nullptr, [&] () {
+	  m.swapRows(i, n - 1 - i);
+	  i = (i + 1) % n;
+	}, 1000);
+    }
+
+  // DMatrix::deleteRowsAndColumns
+  if (selected("DMatrix::deleteRowsAndColumns"))
+    {
+      // DMatrix has no copy assignment, refill it from the values
+      std::vector<std::vector<double> > values(n, std::vector<double>(n));
+      for (std::size_t i = 0; i < n; ++i)
+	for (std::size_t j = 0; j < n; ++j)
+	  values[i][j] = stiffness(i, j);
+
+      nsl::DMatrix m;
+      harness.run("DMatrix::deleteRowsAndColumns" + suffix,
+		  [&] () { m = values; },
+		  [&] () { m.deleteRowsAndColumns(everyTenth); });
+    }
+
+  // DMatrix::gaussianElimination
+  if (selected("DMatrix::gaussianElimination"))
+    {
+      harness.run("DMatrix::gaussianElimination" + suffix, nullptr, [&] () {
+	  nsl::DVector x = stiffness.gaussianElimination(ramp);
+	  nsl::doNotOptimize(x(0));
+	});
+    }
+
+  // DMatrix * DVector
+  if (selected("DMatrix*DVector"))
+    {
+      harness.run("DMatrix*DVector" + suffix, nullptr, [&] () {
+	  nsl::DVector y = stiffness * ramp;
+	  nsl::doNotOptimize(y(0));
+	}, 10);
+    }
+
+  // DVector::deleteElements
+  if (selected("DVector::deleteElements"))
+    {
+      std::vector<double> values(n);
+      for (std::size_t i = 0; i < n; ++i) values[i] = ramp(i);
+
+      nsl::DVector v;
+      harness.run("DVector::deleteElements" + suffix,
+		  [&] () { v = values; },
+		  [&] () { v.deleteElements(everyTenth); });
+    }
+
+  // Spring::stiffnessMatrix
+  if (selected("Spring::stiffnessMatrix"))
+    {
+      nsl::Node node1(0, 1), node2(1, 2);
+      nsl::Spring spring(0, 1, &node1, &node2, 2.5);
+      harness.run("Spring::stiffnessMatrix", nullptr, [&] () {
+	  nsl::DMatrix k = spring.stiffnessMatrix();
+	  nsl::doNotOptimize(k(0, 0));
+	}, 1000);
+    }
+
+  harness.printTable(std::cout);
+
+  if (!settings.csvFile.empty())
+    {
+      std::ofstream csv(settings.csvFile.c_str());
+      if (!csv)
+	{
+	  std::cerr << "Unable to open file " << settings.csvFile << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+      harness.writeCSV(csv);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/* fin */
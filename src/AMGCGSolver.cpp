@@ -0,0 +1,66 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   AMGCGSolver.cpp
+
+   Class: BasicAMGCGSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include "AMGCGSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicAMGCGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+LinearSolverBase::Type BasicAMGCGSolver<Real>::type() const
+{
+  return LinearSolverBase::AMG_CG;
+}
+
+/**
+   Keep the matrix (see CGSolver::factor())
+   and build the multigrid hierarchy.
+*/
+template <typename Real>
+void BasicAMGCGSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  BasicCGSolver<Real>::factor(matrix);
+  _hierarchy.build(matrix);
+}
+
+/**
+   The multigrid hierarchy.
+*/
+template <typename Real>
+const BasicAMGHierarchy<Real> &BasicAMGCGSolver<Real>::hierarchy() const
+{
+  return _hierarchy;
+}
+
+/**
+   z = one V-cycle applied to r.
+*/
+template <typename Real>
+void BasicAMGCGSolver<Real>::precondition(const std::vector<Real> &r, std::vector<Real> &z) const
+{
+  _hierarchy.vcycle(r.data(), z.data());
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicAMGCGSolver)
+
+} // namespace nsl
+
+/* fin */
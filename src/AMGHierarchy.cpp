@@ -0,0 +1,454 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   AMGHierarchy.cpp
+
+   Class: BasicAMGHierarchy
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "AMGHierarchy.h"
+
+namespace nsl {
+
+namespace {
+
+// Rows per task of the parallel matrix vector products
+const std::size_t grain = 16 * 1024;
+
+/**
+   r = b - A x
+*/
+template <typename Real>
+void residual(const BasicSMatrix<Real> &A, const Real *b, const Real *x, Real *r)
+{
+  const std::size_t *rowStart = A.rowStart().data();
+  const std::size_t *colIndex = A.colIndex().data();
+  const Real *values   = A.values().data();
+
+  ThreadPool::instance().parallelFor(A.rows(), grain, [=] (std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i)
+	{
+	  Real s = b[i];
+	  for (std::size_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+	    s -= values[k] * x[colIndex[k]];
+	  r[i] = s;
+	}
+    });
+  Profiler::countFlops(2 * A.nnz());
+}
+
+/**
+   y = A x (add = false) or y += A x (add = true)
+*/
+template <typename Real>
+void multiply(const BasicSMatrix<Real> &A, const Real *x, Real *y, bool add)
+{
+  const std::size_t *rowStart = A.rowStart().data();
+  const std::size_t *colIndex = A.colIndex().data();
+  const Real *values   = A.values().data();
+
+  ThreadPool::instance().parallelFor(A.rows(), grain, [=] (std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i)
+	{
+	  Real s = add ? y[i] : 0;
+	  for (std::size_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+	    s += values[k] * x[colIndex[k]];
+	  y[i] = s;
+	}
+    });
+  Profiler::countFlops(2 * A.nnz());
+}
+
+} // namespace
+
+// =========================================================
+// Class BasicAMGHierarchy
+// ---------------------------------------------------------
+
+/**
+   The matrix of a level.
+*/
+template <typename Real>
+const BasicSMatrix<Real> &BasicAMGHierarchy<Real>::matrix(std::size_t level) const
+{
+  return level == 0 ? *_fine : _levels[level].A;
+}
+
+/**
+   Build the hierarchy for the given matrix.
+*/
+template <typename Real>
+void BasicAMGHierarchy<Real>::build(const BasicSMatrix<Real> &fine)
+{
+  ScopedTimer timer("amg setup");
+
+  _fine = &fine;
+  _levels.assign(1, Level());
+
+  for (std::size_t l = 0; ; ++l)
+    {
+      const BasicSMatrix<Real> &A = matrix(l);
+      std::size_t n = A.rows();
+
+      // The inverse diagonal and the Jacobi damping 4 / (3 rho),
+      // rho bounding the spectral radius of D^-1 A (Gershgorin)
+      double rho = 0;
+      _levels[l].inverseDiagonal.assign(n, 0.0);
+      for (std::size_t i = 0; i < n; ++i)
+	{
+	  Real d = A(i, i);
+	  if (d <= 0)
+	    {
+	      std::cerr
+		<< "ERROR The matrix is not solvable!" << std::endl
+		<< std::endl
+		<< "A(" << i << ", " << i << ") = " << d << " <= 0 (multigrid level " << l << ")" << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+
+	  Real s = 0;
+	  for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+	    s += std::fabs(A.values()[k]);
+	  rho = std::max(rho, double(s / d));
+	  _levels[l].inverseDiagonal[i] = 1 / d;
+	}
+      _levels[l].omega = rho > 0 ? 4 / (3 * rho) : 1;
+
+      _levels[l].x.assign(n, 0.0);
+      _levels[l].b.assign(n, 0.0);
+      _levels[l].r.assign(n, 0.0);
+
+      if (n <= _coarseSize || l + 1 == _maxLevels) break;
+
+      // The aggregates of the strong couplings; stop when the system
+      // does not shrink any more
+      BasicSMatrix<Real> S = strongCouplings(A);
+      std::size_t aggregates;
+      std::vector<std::size_t> aggregateOf = aggregate(S, aggregates);
+      if (aggregates == 0 || aggregates > n * 9 / 10) break;
+
+      // The tentative prolongation
+      std::vector<BasicTriplet<Real>> triplets(n);
+      for (std::size_t i = 0; i < n; ++i)
+	triplets[i] = { i, aggregateOf[i], 1.0 };
+      BasicSMatrix<Real> P(n, aggregates, triplets);
+      BasicSMatrix<Real> coarse = P.transpose() * (A * P);
+
+      // Smoothed with the strong couplings only (which keeps P as
+      // sparse as the aggregates): P = P_tentative - omega D_S^-1 S P_tentative.
+      // On well connected (random) networks the coarse matrices get
+      // many more neighbours per node than the fine one, all the more
+      // with smoothing; in order to keep the operator complexity low,
+      // the smoothed prolongation is only used when the coarse matrix
+      // has at most half as many nonzeros as the fine one
+      auto sparse = [&] (const BasicSMatrix<Real> &C) { return 2 * C.nnz() <= A.nnz(); };
+      if (sparse(coarse))
+	{
+	  double rhoS = 0;
+	  for (std::size_t i = 0; i < n; ++i)
+	    {
+	      Real s = 0;
+	      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+		s += std::fabs(S.values()[k]);
+	      rhoS = std::max(rhoS, double(s / S(i, i)));
+	    }
+
+	  BasicSMatrix<Real> smoothed = S * P;
+	  std::vector<Real> &values = smoothed.values();
+	  for (std::size_t i = 0; i < n; ++i)
+	    {
+	      double scale = -4 / (3 * rhoS * S(i, i));
+	      for (std::size_t k = smoothed.rowStart()[i]; k < smoothed.rowStart()[i + 1]; ++k)
+		{
+		  values[k] *= scale;
+		  if (smoothed.colIndex()[k] == aggregateOf[i]) values[k] += 1;
+		}
+	    }
+
+	  BasicSMatrix<Real> smoothedCoarse = smoothed.transpose() * (A * smoothed);
+	  if (sparse(smoothedCoarse))
+	    {
+	      P = std::move(smoothed);
+	      coarse = std::move(smoothedCoarse);
+	    }
+	}
+
+      Level next;
+      next.A = std::move(coarse);
+      _levels[l].R = P.transpose();
+      _levels[l].P = std::move(P);
+      _levels.push_back(std::move(next));
+    }
+
+  _coarseSolver.factor(matrix(_levels.size() - 1));
+}
+
+/**
+   The strong couplings of a matrix:
+
+     |a(i, j)| >= theta max_k!=i |a(i, k)|
+
+   (every node has at least one strong neighbour).  The weak
+   couplings are added to the diagonal, so that the rows sum up to
+   the same values as in the matrix.
+*/
+template <typename Real>
+BasicSMatrix<Real> BasicAMGHierarchy<Real>::strongCouplings(const BasicSMatrix<Real> &A) const
+{
+  std::size_t n = A.rows();
+
+  // The strongest coupling of every node
+  std::vector<Real> strongest(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+      if (A.colIndex()[k] != i) strongest[i] = std::max(strongest[i], std::fabs(A.values()[k]));
+
+  std::vector<BasicTriplet<Real>> triplets;
+  triplets.reserve(A.nnz());
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+      {
+	std::size_t j = A.colIndex()[k];
+	Real a = A.values()[k];
+	if (j == i || std::fabs(a) >= _theta * strongest[i])
+	  triplets.push_back({ i, j, a });
+	else
+	  triplets.push_back({ i, i, a });
+      }
+
+  return BasicSMatrix<Real>(n, n, triplets);
+}
+
+/**
+   Group the nodes of the graph of the strong couplings S into
+   aggregates: returns the aggregate of each node and sets
+   `aggregates' to their number.
+
+     1. A node whose neighbours are all free starts an aggregate
+        together with them.
+     2. The remaining nodes join the aggregate of their strongest
+        neighbour of step 1.
+     3. Nodes still left over form aggregates with their free
+        neighbours.
+     4. Nodes which ended up alone join the aggregate of their
+        strongest neighbour.
+
+   In steps 1 and 3 only neighbours are taken along for which the
+   coupling is strong as well (a node tied to a much stiffer spring
+   belongs to the aggregate at its other end).
+*/
+template <typename Real>
+std::vector<std::size_t> BasicAMGHierarchy<Real>::aggregate(const BasicSMatrix<Real> &S, std::size_t &aggregates) const
+{
+  std::size_t n = S.rows();
+  const std::size_t none = n;
+
+  // The strongest coupling of every node
+  std::vector<Real> strongest(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+      if (S.colIndex()[k] != i) strongest[i] = std::max(strongest[i], std::fabs(S.values()[k]));
+
+  // Strong for both nodes
+  auto mutual = [&] (std::size_t i, std::size_t k) -> bool {
+    std::size_t j = S.colIndex()[k];
+    return j != i && std::fabs(S.values()[k]) >= _theta * strongest[j];
+  };
+
+  std::vector<std::size_t> aggregateOf(n, none);
+  aggregates = 0;
+
+  // 1. Aggregates of a node and all of its neighbours
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (aggregateOf[i] != none) continue;
+
+      bool free = true;
+      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1] && free; ++k)
+	if (mutual(i, k) && aggregateOf[S.colIndex()[k]] != none) free = false;
+      if (!free) continue;
+
+      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+	if (mutual(i, k)) aggregateOf[S.colIndex()[k]] = aggregates;
+      aggregateOf[i] = aggregates;
+      ++aggregates;
+    }
+
+  // 2. Join the aggregate of the strongest aggregated neighbour
+  std::vector<std::size_t> joined(aggregateOf);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (aggregateOf[i] != none) continue;
+
+      double strongest = 0;
+      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+	{
+	  std::size_t j = S.colIndex()[k];
+	  if (j != i && aggregateOf[j] != none && std::fabs(S.values()[k]) > strongest)
+	    {
+	      strongest = std::fabs(S.values()[k]);
+	      joined[i] = aggregateOf[j];
+	    }
+	}
+    }
+  aggregateOf.swap(joined);
+
+  // 3. New aggregates for the rest
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (aggregateOf[i] != none) continue;
+
+      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+	if (mutual(i, k) && aggregateOf[S.colIndex()[k]] == none)
+	  aggregateOf[S.colIndex()[k]] = aggregates;
+      aggregateOf[i] = aggregates;
+      ++aggregates;
+    }
+
+  // 4. Single nodes join the aggregate of their strongest neighbour
+  std::vector<std::size_t> size(aggregates, 0);
+  for (std::size_t i = 0; i < n; ++i) ++size[aggregateOf[i]];
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (size[aggregateOf[i]] != 1) continue;
+
+      double strongest = 0;
+      std::size_t neighbour = none;
+      for (std::size_t k = S.rowStart()[i]; k < S.rowStart()[i + 1]; ++k)
+	{
+	  std::size_t j = S.colIndex()[k];
+	  if (j != i && std::fabs(S.values()[k]) > strongest)
+	    {
+	      strongest = std::fabs(S.values()[k]);
+	      neighbour = j;
+	    }
+	}
+      if (neighbour != none && size[aggregateOf[neighbour]] > 1)
+	{
+	  size[aggregateOf[i]] = 0;
+	  aggregateOf[i] = aggregateOf[neighbour];
+	  ++size[aggregateOf[i]];
+	}
+    }
+
+  // Number the remaining aggregates
+  std::vector<std::size_t> number(aggregates, none);
+  aggregates = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (number[aggregateOf[i]] == none) number[aggregateOf[i]] = aggregates++;
+      aggregateOf[i] = number[aggregateOf[i]];
+    }
+
+  return aggregateOf;
+}
+
+/**
+   Apply one V-cycle to b[0 ... n - 1], starting with x = 0.
+*/
+template <typename Real>
+void BasicAMGHierarchy<Real>::vcycle(const Real *b, Real *x) const
+{
+  const Level &finest = _levels[0];
+  std::copy(b, b + finest.b.size(), finest.b.begin());
+  vcycle(0);
+  std::copy(finest.x.begin(), finest.x.end(), x);
+}
+
+/**
+   V-cycle on a level: solve A x = b approximately for the b of the
+   level into the x of the level.
+*/
+template <typename Real>
+void BasicAMGHierarchy<Real>::vcycle(std::size_t l) const
+{
+  const Level &level = _levels[l];
+  const BasicSMatrix<Real> &A = matrix(l);
+  std::size_t n = A.rows();
+
+  std::vector<Real> &x = level.x;
+  std::vector<Real> &b = level.b;
+  std::vector<Real> &r = level.r;
+
+  // The coarsest level is solved directly
+  if (l + 1 == _levels.size())
+    {
+      BasicVector<Real> solution = _coarseSolver.solve(BasicVector<Real>(b));
+      for (std::size_t i = 0; i < n; ++i) x[i] = solution(i);
+      return;
+    }
+
+  auto smooth = [&] () {
+    residual(A, b.data(), x.data(), r.data());
+    for (std::size_t i = 0; i < n; ++i) x[i] += level.omega * level.inverseDiagonal[i] * r[i];
+    Profiler::countFlops(3 * n);
+  };
+
+  // Pre-smoothing, the first sweep starting with x = 0
+  for (std::size_t i = 0; i < n; ++i) x[i] = level.omega * level.inverseDiagonal[i] * b[i];
+  for (int sweep = 1; sweep < _sweeps; ++sweep) smooth();
+
+  // Coarse grid correction
+  const Level &next = _levels[l + 1];
+  residual(A, b.data(), x.data(), r.data());
+  multiply(level.R, r.data(), next.b.data(), false);
+  vcycle(l + 1);
+  multiply(level.P, next.x.data(), x.data(), true);
+
+  // Post-smoothing
+  for (int sweep = 0; sweep < _sweeps; ++sweep) smooth();
+}
+
+/**
+   Number of levels (including the finest one).
+*/
+template <typename Real>
+std::size_t BasicAMGHierarchy<Real>::levels() const
+{
+  return _levels.size();
+}
+
+/**
+   Number of unknowns on a level.
+*/
+template <typename Real>
+std::size_t BasicAMGHierarchy<Real>::levelSize(std::size_t level) const
+{
+  return matrix(level).rows();
+}
+
+/**
+   Sum of the nonzeros of all levels relative to the finest level.
+*/
+template <typename Real>
+double BasicAMGHierarchy<Real>::operatorComplexity() const
+{
+  double nnz = 0;
+  for (std::size_t l = 0; l < _levels.size(); ++l)
+    nnz += matrix(l).nnz();
+
+  return nnz / _fine->nnz();
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicAMGHierarchy)
+
+} // namespace nsl
+
+/* fin */
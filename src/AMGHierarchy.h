@@ -0,0 +1,100 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   AMGHierarchy.h
+
+   Class: BasicAMGHierarchy, AMGHierarchy
+
+   Smoothed aggregation algebraic multigrid hierarchy for symmetric
+   positive definite matrices (the reduced stiffness matrices of
+   spring assemblages).
+
+   Setup: on every level the nodes are grouped into aggregates of
+   strongly connected neighbours (|a(i, j)| >= theta max_k |a(i, k)|).
+   The tentative prolongation maps each aggregate to a constant (the
+   near null space of a spring network: a rigid displacement).  It
+   is smoothed with one damped Jacobi step of the strong couplings S
+
+     P = (I - omega D_S^-1 S) P_tentative
+
+   and the coarse matrix is the Galerkin product P^T A P.  Where the
+   smoothed prolongation would make the coarse matrix too dense
+   (random, well connected networks) the tentative one is kept.
+   Levels are added until the system is small enough to be
+   factorized with the sparse direct solver.  The matrix products
+   are calculated on the thread pool.
+
+   Solve: a V-cycle with damped Jacobi pre- and post-smoothing (the
+   same number of sweeps, so that the V-cycle is a symmetric operator
+   and can be used as a preconditioner for conjugate gradients).
+
+   The hierarchy depends only on the matrix: build it once and apply
+   it to as many right hand sides (load cases) as needed.  The finest
+   matrix is not copied and has to outlive the hierarchy.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __AMGHierarchy__
+#define __AMGHierarchy__
+
+#include <vector>
+
+#include "SMatrix.h"
+#include "SparseSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicAMGHierarchy
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicAMGHierarchy {
+
+  struct Level {
+    BasicSMatrix<Real> A;                       // The Galerkin matrix (level 0: see _fine)
+    BasicSMatrix<Real> P;                       // Prolongation from the next coarser level
+    BasicSMatrix<Real> R;                       // Restriction to the next coarser level: P^T
+    std::vector<Real> inverseDiagonal;
+    double omega = 0;                // Jacobi damping
+
+    // Work vectors of the V-cycle
+    mutable std::vector<Real> x, b, r;
+  };
+
+  const BasicSMatrix<Real> *_fine = nullptr;
+  std::vector<Level> _levels;
+  BasicSparseSolver<Real> _coarseSolver;
+
+  double _theta = 0.25;              // Strength of connection threshold
+  std::size_t _coarseSize = 500;     // Largest system solved directly
+  std::size_t _maxLevels = 25;
+  int _sweeps = 2;                   // Pre- and post-smoothing sweeps
+
+ public:
+  void build(const BasicSMatrix<Real> &matrix);
+  void vcycle(const Real *b, Real *x) const;
+
+  std::size_t levels() const;
+  std::size_t levelSize(std::size_t level) const;
+  double operatorComplexity() const;
+
+ private:
+  const BasicSMatrix<Real> &matrix(std::size_t level) const;
+  BasicSMatrix<Real> strongCouplings(const BasicSMatrix<Real> &A) const;
+  std::vector<std::size_t> aggregate(const BasicSMatrix<Real> &S, std::size_t &aggregates) const;
+  void vcycle(std::size_t level) const;
+};
+
+typedef BasicAMGHierarchy<double> AMGHierarchy;
+
+} // namespace nsl
+
+#endif /* defined(__AMGHierarchy__) */
+
+/* fin */
@@ -0,0 +1,217 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   AMGSolver.cpp
+
+   Class: BasicAMGSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include "Profiler.h"
+#include "AMGSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicAMGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+LinearSolverBase::Type BasicAMGSolver<Real>::type() const
+{
+  return LinearSolverBase::AMG;
+}
+
+/**
+   Keep a reference to the matrix (it has to outlive the solver)
+   and build the multigrid hierarchy.
+*/
+template <typename Real>
+void BasicAMGSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  _matrix = &matrix;
+  _hierarchy.build(matrix);
+}
+
+/**
+   Solve A x = b starting with x = 0:
+   x += V-cycle(b - A x) until the residual is small enough.
+
+   The plain V-cycles converge slowly on long chains with varying
+   spring constants (about 0.66 per cycle on the chains of
+   nslfem-gen).  When a cycle does not halve the residual any more,
+   the remaining iterations are conjugate gradients preconditioned
+   with the V-cycle, as done by AMGCGSolver.
+*/
+template <typename Real>
+BasicVector<Real> BasicAMGSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  ScopedTimer timer("multigrid");
+
+  const BasicSMatrix<Real> &A = *_matrix;
+  std::size_t n = A.rows();
+
+  std::vector<Real> x(n, 0.0), r(n), e(n);
+  for (std::size_t i = 0; i < n; ++i) r[i] = b(i);
+
+  double normB = 0;
+  for (std::size_t i = 0; i < n; ++i) normB += r[i] * r[i];
+  normB = std::sqrt(normB);
+
+  _iterations = 0;
+  _residual = 0;
+  _accelerated = false;
+  if (normB == 0) return BasicVector<Real>(x);
+
+  double previous = 1;
+  while (_iterations < _maxIterations)
+    {
+      _hierarchy.vcycle(r.data(), e.data());
+      for (std::size_t i = 0; i < n; ++i) x[i] += e[i];
+      ++_iterations;
+
+      double normR = 0;
+      for (std::size_t i = 0; i < n; ++i)
+	{
+	  Real s = b(i);
+	  for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+	    s -= A.values()[k] * x[A.colIndex()[k]];
+	  r[i] = s;
+	  normR += s * s;
+	}
+      Profiler::countFlops(2 * A.nnz() + 3 * n);
+
+      _residual = std::sqrt(normR) / normB;
+      if (_residual <= _tolerance) break;
+
+      // The first cycles may raise the residual; later ones have to
+      // at least halve it, or the cycles are handed over to CG
+      if (_iterations >= 3 && _residual > _stallFactor * previous)
+	{
+	  _accelerated = true;
+	  break;
+	}
+      previous = _residual;
+    }
+
+  if (_accelerated)
+    {
+      // Conjugate gradients preconditioned with one V-cycle (as
+      // AMGCGSolver), continued from the current x
+      std::vector<Real> p(n), q(n);
+      _hierarchy.vcycle(r.data(), e.data());
+      p = e;
+      Real rz = 0;
+      for (std::size_t i = 0; i < n; ++i) rz += r[i] * e[i];
+
+      while (_iterations < _maxIterations)
+	{
+	  Real pq = 0;
+	  for (std::size_t i = 0; i < n; ++i)
+	    {
+	      Real s = 0;
+	      for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+		s += A.values()[k] * p[A.colIndex()[k]];
+	      q[i] = s;
+	      pq += p[i] * s;
+	    }
+	  Real alpha = rz / pq;
+
+	  double normR = 0;
+	  for (std::size_t i = 0; i < n; ++i)
+	    {
+	      x[i] += alpha * p[i];
+	      r[i] -= alpha * q[i];
+	      normR += r[i] * r[i];
+	    }
+	  ++_iterations;
+	  Profiler::countFlops(2 * A.nnz() + 10 * n);
+
+	  _residual = std::sqrt(normR) / normB;
+	  if (_residual <= _tolerance) break;
+
+	  _hierarchy.vcycle(r.data(), e.data());
+	  Real rzNew = 0;
+	  for (std::size_t i = 0; i < n; ++i) rzNew += r[i] * e[i];
+	  Real beta = rzNew / rz;
+	  rz = rzNew;
+
+	  for (std::size_t i = 0; i < n; ++i) p[i] = e[i] + beta * p[i];
+	}
+    }
+
+  if (_residual > _tolerance)
+    std::cerr << "WARNING Multigrid did not converge: relative residual "
+	      << _residual << " after " << _iterations << " V-cycles." << std::endl;
+
+  return BasicVector<Real>(x);
+}
+
+template <typename Real>
+void BasicAMGSolver<Real>::setTolerance(double tolerance)
+{
+  _tolerance = tolerance;
+}
+
+template <typename Real>
+void BasicAMGSolver<Real>::setMaxIterations(std::size_t iterations)
+{
+  _maxIterations = iterations;
+}
+
+/**
+   Number of V-cycles of the last solve(), including the conjugate
+   gradient iterations.
+*/
+template <typename Real>
+std::size_t BasicAMGSolver<Real>::iterations() const
+{
+  return _iterations;
+}
+
+/**
+   Relative residual |b - A x| / |b| after the last solve().
+*/
+template <typename Real>
+double BasicAMGSolver<Real>::residual() const
+{
+  return _residual;
+}
+
+/**
+   True when the last solve() had to continue with conjugate
+   gradients.
+*/
+template <typename Real>
+bool BasicAMGSolver<Real>::accelerated() const
+{
+  return _accelerated;
+}
+
+/**
+   The multigrid hierarchy.
+*/
+template <typename Real>
+const BasicAMGHierarchy<Real> &BasicAMGSolver<Real>::hierarchy() const
+{
+  return _hierarchy;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicAMGSolver)
+
+} // namespace nsl
+
+/* fin */
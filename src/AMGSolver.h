@@ -0,0 +1,72 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   AMGSolver.h
+
+   Class: BasicAMGSolver, AMGSolver
+
+   Algebraic multigrid solver: V-cycles of a smoothed aggregation
+   hierarchy (see AMGHierarchy.h) applied to the residual until the
+   relative residual drops below the tolerance.  Falls back to
+   conjugate gradients preconditioned with the V-cycle (the method
+   of AMGCGSolver) when the cycles stall.  Needs O(nnz) memory
+   and, for the spring networks it is made for, a number of cycles
+   which hardly grows with the size of the network.
+
+   factor() builds the hierarchy; it is reused by every solve().
+   The matrix has to outlive the solver.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __AMGSolver__
+#define __AMGSolver__
+
+#include "LinearSolver.h"
+#include "AMGHierarchy.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicAMGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicAMGSolver : public BasicLinearSolver<Real> {
+
+  const BasicSMatrix<Real> *_matrix = nullptr;
+  BasicAMGHierarchy<Real> _hierarchy;
+
+  double _tolerance = Precision::iterativeTolerance<Real>();  // Relative residual
+  std::size_t _maxIterations = 500;  // V-cycles
+  double _stallFactor = 0.5;         // Residual reduction per V-cycle
+
+  mutable std::size_t _iterations = 0;
+  mutable double _residual = 0;
+  mutable bool _accelerated = false;
+
+ public:
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+  void setTolerance(double tolerance);
+  void setMaxIterations(std::size_t iterations);
+
+  std::size_t iterations() const;
+  double residual() const;
+  bool accelerated() const;
+  const BasicAMGHierarchy<Real> &hierarchy() const;
+};
+
+typedef BasicAMGSolver<double> AMGSolver;
+
+} // namespace nsl
+
+#endif /* defined(__AMGSolver__) */
+
+/* fin */
@@ -0,0 +1,35 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Access.h
+
+   Element access policy.
+
+   By default every element access of DVector, DMatrix and DSpan is
+   bounds checked with assert().  Defining NSL_UNCHECKED_ACCESS at
+   compile time (see `make release') removes these checks from the
+   element accessors, so that the solver kernels run without a
+   branch per access.  The unit tests are always built with checked
+   access.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Access__
+#define __Access__
+
+#include <cassert>
+
+#ifdef NSL_UNCHECKED_ACCESS
+#  define NSL_CHECK_ACCESS(condition) ((void) 0)
+#else
+#  define NSL_CHECK_ACCESS(condition) assert(condition)
+#endif
+
+#endif /* defined(__Access__) */
+
+/* fin */
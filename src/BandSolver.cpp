@@ -0,0 +1,226 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   BandSolver.cpp
+
+   Class: BasicBandSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "BandSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicBandSolver
+// ---------------------------------------------------------
+
+/**
+   Bandwidth of a matrix: the largest |i - j| of a nonzero element (i, j).
+*/
+template <typename Real>
+std::size_t BasicBandSolver<Real>::bandwidth(const BasicSMatrix<Real> &matrix)
+{
+  std::size_t b = 0;
+  for (std::size_t i = 0; i < matrix.rows(); ++i)
+    for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+      {
+	std::size_t j = matrix.colIndex()[k];
+	b = std::max(b, i > j ? i - j : j - i);
+      }
+  
+  return b;
+}
+
+template <typename Real>
+LinearSolverBase::Type BasicBandSolver<Real>::type() const
+{
+  return LinearSolverBase::BAND;
+}
+
+/**
+   Compute and store the factor in single (true) or double precision.
+*/
+template <typename Real>
+void BasicBandSolver<Real>::setSinglePrecision(bool single)
+{
+  _single = single;
+}
+
+/**
+   Factorize the matrix.
+*/
+template <typename Real>
+void BasicBandSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  factorUpper(matrix);
+}
+
+/**
+   Factorize a symmetric matrix given by its upper triangle.
+*/
+template <typename Real>
+void BasicBandSolver<Real>::factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  factorUpper(matrix.upper());
+}
+
+/**
+   Factorize the matrix given by (at least) its upper triangle.
+*/
+template <typename Real>
+void BasicBandSolver<Real>::factorUpper(const BasicSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  if (_single ? !factor(matrix, _singleBand, pivot, value) : !factor(matrix, _band, pivot, value))
+    {
+      std::cerr 
+	<< "ERROR The matrix is not solvable!" << std::endl
+	<< std::endl
+	<< "The stiffness matrix is not positive definite (pivot " << pivot << ": " << value << ")." << std::endl
+	<< "Is there a part of the assemblage without prescribed displacement?" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+/**
+   Factorize the matrix.  Returns false when it turns out not to be
+   positive definite (in the precision of the factor).
+*/
+template <typename Real>
+bool BasicBandSolver<Real>::tryFactor(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  return _single ? factor(matrix.upper(), _singleBand, pivot, value) : factor(matrix.upper(), _band, pivot, value);
+}
+
+/**
+   Factorize the matrix into `band' (the other precision is released).
+   Only the upper triangle of `matrix' is read.  When a pivot is not
+   positive, false is returned and `pivot' and `value' are set to its
+   row and value.
+*/
+template <typename Real>
+template <typename Factor>
+bool BasicBandSolver<Real>::factor(const BasicSMatrix<Real> &matrix, std::vector<Factor> &band, std::size_t &pivot, double &value)
+{
+  ScopedTimer timer("band factorization");
+
+  std::vector<Real>().swap(_band);
+  std::vector<float>().swap(_singleBand);
+
+  _n = matrix.rows();
+  _bandwidth = bandwidth(matrix);
+  band.assign(_n * (_bandwidth + 1), Factor(0));
+
+  // Copy the lower band: the transposed upper triangle
+  for (std::size_t i = 0; i < _n; ++i)
+    for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+      {
+	std::size_t j = matrix.colIndex()[k];
+	if (j >= i) band[index(j, i)] = Factor(matrix.values()[k]);
+      }
+
+  // Row oriented Cholesky factorization:
+  // L(i, j) = (A(i, j) - sum_k L(i, k) L(j, k)) / L(j, j)
+  std::uint64_t flops = 0;
+  for (std::size_t i = 0; i < _n; ++i)
+    {
+      std::size_t first = i > _bandwidth ? i - _bandwidth : 0;
+      
+      for (std::size_t j = first; j <= i; ++j)
+	{
+	  std::size_t firstJ = j > _bandwidth ? j - _bandwidth : 0;
+	  Factor s = band[index(i, j)];
+	  for (std::size_t k = std::max(first, firstJ); k < j; ++k)
+	    s -= band[index(i, k)] * band[index(j, k)];
+	  flops += 2 * (j - std::max(first, firstJ));
+
+	  if (j < i)
+	    band[index(i, j)] = s / band[index(j, j)];
+	  else if (s > 0)
+	    band[index(i, i)] = std::sqrt(s);
+	  else
+	    {
+	      Profiler::countFlops(flops);
+	      pivot = i;
+	      value = s;
+	      return false;
+	    }
+	}
+    }
+  Profiler::countFlops(flops);
+
+  return true;
+}
+
+/**
+   Solve L L^T x = b by forward and back substitution.
+*/
+template <typename Real>
+BasicVector<Real> BasicBandSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  BasicVector<Real> x(b);
+
+  if (_single)
+    {
+      std::vector<float> v(_n);
+      for (std::size_t i = 0; i < _n; ++i) v[i] = float(b(i));
+      substitute(_singleBand, v.data());
+      for (std::size_t i = 0; i < _n; ++i) x(i) = v[i];
+    }
+  else
+    substitute(_band, x.span().data());
+
+  return x;
+}
+
+/**
+   L L^T x = v, x overwriting v.
+*/
+template <typename Real>
+template <typename Factor>
+void BasicBandSolver<Real>::substitute(const std::vector<Factor> &band, Factor *v) const
+{
+  // L y = b
+  for (std::size_t i = 0; i < _n; ++i)
+    {
+      std::size_t first = i > _bandwidth ? i - _bandwidth : 0;
+      Factor s = v[i];
+      for (std::size_t k = first; k < i; ++k)
+	s -= band[index(i, k)] * v[k];
+      v[i] = s / band[index(i, i)];
+    }
+
+  // L^T x = y
+  for (std::size_t i = _n; i-- > 0; )
+    {
+      v[i] /= band[index(i, i)];
+      std::size_t first = i > _bandwidth ? i - _bandwidth : 0;
+      for (std::size_t k = first; k < i; ++k)
+	v[k] -= band[index(i, k)] * v[i];
+    }
+  Profiler::countFlops(4 * _n * (_bandwidth + 1));
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicBandSolver)
+
+} // namespace nsl
+
+/* fin */
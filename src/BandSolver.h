@@ -0,0 +1,90 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   BandSolver.h
+
+   Class: BasicBandSolver, BandSolver
+
+   Cholesky factorization K = L L^T of a symmetric positive definite
+   band matrix.  Only the lower band (bandwidth b) is stored, row by
+   row: O(n b) memory and O(n b^2) time.  It is filled from the upper
+   triangle of the matrix, so that a symmetric matrix in half storage
+   is factorized without expanding it.  The matrix is used in the
+   given order, i.e. the solver is the right choice when the nodes
+   are already numbered along the structure (chains, slim grids).
+
+   With setSinglePrecision(true) the factor is computed and stored in
+   single precision (half the memory and memory traffic); see
+   RefinementSolver for recovering double precision accuracy.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __BandSolver__
+#define __BandSolver__
+
+#include <vector>
+
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicBandSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicBandSolver : public BasicLinearSolver<Real> {
+
+  std::size_t _n = 0;
+  std::size_t _bandwidth = 0;
+  bool _single = false;
+
+  // L(i, j), i - b <= j <= i, is stored at _band[index(i, j)]
+  std::vector<Real> _band;
+  std::vector<float>  _singleBand;     // Instead of _band in single precision
+  
+ public:
+  static std::size_t bandwidth(const BasicSMatrix<Real> &matrix);
+
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  void factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  bool tryFactor(const BasicSymmetricSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+  void setSinglePrecision(bool single);
+
+ private:
+  std::size_t index(std::size_t i, std::size_t j) const;
+
+  void factorUpper(const BasicSMatrix<Real> &matrix);
+
+  template <typename Factor>
+  bool factor(const BasicSMatrix<Real> &matrix, std::vector<Factor> &band, std::size_t &pivot, double &value);
+
+  template <typename Factor>
+  void substitute(const std::vector<Factor> &band, Factor *v) const;
+};
+
+typedef BasicBandSolver<double> BandSolver;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+template <typename Real>
+inline std::size_t BasicBandSolver<Real>::index(std::size_t i, std::size_t j) const
+{
+  return i * (_bandwidth + 1) + j + _bandwidth - i;
+}
+
+} // namespace nsl
+
+#endif /* defined(__BandSolver__) */
+
+/* fin */
@@ -0,0 +1,197 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   CGSolver.cpp
+
+   Class: BasicCGSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <iostream>
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "CGSolver.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   y = A x
+*/
+template <typename Real>
+void multiply(const BasicSMatrix<Real> &A, const Real *x, Real *y)
+{
+  const std::size_t *rowStart = A.rowStart().data();
+  const std::size_t *colIndex = A.colIndex().data();
+  const Real *values   = A.values().data();
+
+  ThreadPool::instance().parallelFor(A.rows(), 16 * 1024, [=] (std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i)
+	{
+	  Real s = 0;
+	  for (std::size_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+	    s += values[k] * x[colIndex[k]];
+	  y[i] = s;
+	}
+    });
+}
+
+template <typename Real>
+Real dot(const std::vector<Real> &a, const std::vector<Real> &b)
+{
+  Real s = 0;
+  for (std::size_t i = 0; i < a.size(); ++i) s += a[i] * b[i];
+  return s;
+}
+
+} // namespace
+
+// =========================================================
+// Class BasicCGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+LinearSolverBase::Type BasicCGSolver<Real>::type() const
+{
+  return LinearSolverBase::CG;
+}
+
+/**
+   Keep a reference to the matrix (it has to outlive the solver)
+   and invert its diagonal.
+*/
+template <typename Real>
+void BasicCGSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  _matrix = &matrix;
+
+  std::size_t n = matrix.rows();
+  _inverseDiagonal.assign(n, 1.0);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      Real d = matrix(i, i);
+      if (d <= 0)
+	{
+	  std::cerr 
+	    << "ERROR The matrix is not solvable!" << std::endl
+	    << std::endl
+	    << "A(" << i << ", " << i << ") = " << d << " <= 0" << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+      _inverseDiagonal[i] = 1.0 / d;
+    }
+}
+
+/**
+   Solve A x = b starting with x = 0.
+*/
+template <typename Real>
+BasicVector<Real> BasicCGSolver<Real>::solve(const BasicVector<Real> &b_) const
+{
+  ScopedTimer timer("conjugate gradients");
+
+  const BasicSMatrix<Real> &A = *_matrix;
+  std::size_t n = A.rows();
+  std::size_t maxIterations = _maxIterations ? _maxIterations : 10 * n + 100;
+
+  std::vector<Real> x(n, 0.0), r(n), z(n), p(n), q(n);
+  for (std::size_t i = 0; i < n; ++i) r[i] = b_(i);
+
+  double normB = std::sqrt(dot(r, r));
+  _iterations = 0;
+  _residual = 0;
+  if (normB == 0) return BasicVector<Real>(x);
+
+  precondition(r, z);
+  p = z;
+  Real rz = dot(r, z);
+
+  std::uint64_t flops = 0;
+  while (_iterations < maxIterations)
+    {
+      multiply(A, p.data(), q.data());
+      Real alpha = rz / dot(p, q);
+
+      for (std::size_t i = 0; i < n; ++i)
+	{
+	  x[i] += alpha * p[i];
+	  r[i] -= alpha * q[i];
+	}
+      ++_iterations;
+      flops += 2 * A.nnz() + 10 * n;
+
+      _residual = std::sqrt(dot(r, r)) / normB;
+      if (_residual <= _tolerance) break;
+
+      precondition(r, z);
+      Real rzNew = dot(r, z);
+      Real beta = rzNew / rz;
+      rz = rzNew;
+
+      for (std::size_t i = 0; i < n; ++i) p[i] = z[i] + beta * p[i];
+    }
+  Profiler::countFlops(flops);
+
+  if (_residual > _tolerance)
+    std::cerr << "WARNING Conjugate gradients did not converge: relative residual " 
+	      << _residual << " after " << _iterations << " iterations." << std::endl;
+
+  return BasicVector<Real>(x);
+}
+
+/**
+   Jacobi preconditioning: z = D^-1 r
+*/
+template <typename Real>
+void BasicCGSolver<Real>::precondition(const std::vector<Real> &r, std::vector<Real> &z) const
+{
+  for (std::size_t i = 0; i < r.size(); ++i) z[i] = _inverseDiagonal[i] * r[i];
+}
+
+template <typename Real>
+void BasicCGSolver<Real>::setTolerance(double tolerance)
+{
+  _tolerance = tolerance;
+}
+
+template <typename Real>
+void BasicCGSolver<Real>::setMaxIterations(std::size_t iterations)
+{
+  _maxIterations = iterations;
+}
+
+/**
+   Number of iterations of the last solve().
+*/
+template <typename Real>
+std::size_t BasicCGSolver<Real>::iterations() const
+{
+  return _iterations;
+}
+
+/**
+   Relative residual |b - A x| / |b| after the last solve().
+*/
+template <typename Real>
+double BasicCGSolver<Real>::residual() const
+{
+  return _residual;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicCGSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,71 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   CGSolver.h
+
+   Class: BasicCGSolver, CGSolver
+
+   Conjugate gradient method with Jacobi (diagonal) preconditioning
+   for symmetric positive definite matrices.  Needs only the sparse
+   matrix and a few vectors: O(nnz) memory and O(nnz) time per
+   iteration.  The number of iterations grows with the square root
+   of the condition number, i.e. long chains converge slowly, while
+   well connected networks converge quickly.
+
+   Subclasses may replace the preconditioner by overriding
+   precondition() (see TreeCGSolver).
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __CGSolver__
+#define __CGSolver__
+
+#include <vector>
+
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicCGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicCGSolver : public BasicLinearSolver<Real> {
+
+  const BasicSMatrix<Real> *_matrix = nullptr;
+  std::vector<Real> _inverseDiagonal;
+
+  double _tolerance = Precision::iterativeTolerance<Real>();  // Relative residual
+  std::size_t _maxIterations = 0;    // 0: 10 * n + 100
+
+  mutable std::size_t _iterations = 0;
+  mutable double _residual = 0;
+
+ public:
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+  void setTolerance(double tolerance);
+  void setMaxIterations(std::size_t iterations);
+
+  std::size_t iterations() const;
+  double residual() const;
+
+ protected:
+  virtual void precondition(const std::vector<Real> &r, std::vector<Real> &z) const;
+};
+
+typedef BasicCGSolver<double> CGSolver;
+
+} // namespace nsl
+
+#endif /* defined(__CGSolver__) */
+
+/* fin */
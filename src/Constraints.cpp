@@ -0,0 +1,178 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Constraints.cpp
+
+   Class: BasicConstraints
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cassert>
+
+#include "Profiler.h"
+#include "DVector.h"
+#include "Constraints.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicConstraints
+// ---------------------------------------------------------
+
+/**
+    Constructor: `size' free degrees of freedom.
+*/
+template <typename Real>
+BasicConstraints<Real>::BasicConstraints(std::size_t size)
+  : BasicConstraints(size, std::vector<std::size_t>(), std::vector<Real>()) {}
+
+/**
+    Constructor: the degrees of freedom `dofs' are constrained to
+    the corresponding `values'.
+*/
+template <typename Real>
+BasicConstraints<Real>::BasicConstraints(std::size_t size, const std::vector<std::size_t> &dofs, const std::vector<Real> &values)
+  : _size(size), _mask((size + 63) / 64, 0), _values(size, 0.0)
+{
+  assert(dofs.size() == values.size());
+
+  for (std::size_t k = 0; k < dofs.size(); ++k)
+    {
+      assert(dofs[k] < size);
+
+      _mask[dofs[k] >> 6] |= std::uint64_t(1) << (dofs[k] & 63);
+      _values[dofs[k]] = values[k];
+    }
+
+  // The free and constrained degrees of freedom in ascending order
+  _freeIndex.resize(size);
+  for (std::size_t i = 0; i < size; ++i)
+    if (isConstrained(i))
+      {
+	_freeIndex[i] = size;
+	_constrainedDofs.push_back(i);
+      }
+    else
+      {
+	_freeIndex[i] = _freeDofs.size();
+	_freeDofs.push_back(i);
+      }
+
+  Profiler::countAllocation(_mask.size() * sizeof(std::uint64_t) +
+			    _values.size() * sizeof(Real) +
+			    (2 * size) * sizeof(std::size_t));
+}
+
+/**
+   Number of degrees of freedom.
+*/
+template <typename Real>
+std::size_t BasicConstraints<Real>::size() const
+{
+  return _size;
+}
+
+/**
+   Number of free degrees of freedom: the size of the reduced system.
+*/
+template <typename Real>
+std::size_t BasicConstraints<Real>::numberOfFree() const
+{
+  return _freeDofs.size();
+}
+
+/**
+   Number of degrees of freedom with a prescribed displacement.
+*/
+template <typename Real>
+std::size_t BasicConstraints<Real>::numberOfConstrained() const
+{
+  return _constrainedDofs.size();
+}
+
+/**
+   The prescribed displacements (0 for the free degrees of freedom).
+*/
+template <typename Real>
+const std::vector<Real> &BasicConstraints<Real>::values() const
+{
+  return _values;
+}
+
+/**
+   The free degrees of freedom in ascending order.
+*/
+template <typename Real>
+const std::vector<std::size_t> &BasicConstraints<Real>::freeDofs() const
+{
+  return _freeDofs;
+}
+
+/**
+   The constrained degrees of freedom in ascending order.
+*/
+template <typename Real>
+const std::vector<std::size_t> &BasicConstraints<Real>::constrainedDofs() const
+{
+  return _constrainedDofs;
+}
+
+/**
+   The index of every degree of freedom in the reduced system
+   (size() for the constrained ones).
+*/
+template <typename Real>
+const std::vector<std::size_t> &BasicConstraints<Real>::freeIndex() const
+{
+  return _freeIndex;
+}
+
+/**
+   The elements of v at the free degrees of freedom.
+*/
+template <typename Real>
+BasicVector<Real> BasicConstraints<Real>::gather(const BasicVector<Real> &v) const
+{
+  assert(v.size() == _size);
+
+  BasicVector<Real> free(_freeDofs.size());
+  const Real *vv = v.span().data();
+  Real *ff = free.span().data();
+  for (std::size_t k = 0; k < _freeDofs.size(); ++k)
+    ff[k] = vv[_freeDofs[k]];
+
+  return free;
+}
+
+/**
+   The full vector: the prescribed values at the constrained and
+   the elements of `free' at the free degrees of freedom.
+*/
+template <typename Real>
+BasicVector<Real> BasicConstraints<Real>::scatter(const BasicVector<Real> &free) const
+{
+  assert(free.size() == _freeDofs.size());
+
+  BasicVector<Real> v(_values);
+  const Real *ff = free.span().data();
+  Real *vv = v.span().data();
+  for (std::size_t k = 0; k < _freeDofs.size(); ++k)
+    vv[_freeDofs[k]] = ff[k];
+
+  return v;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicConstraints)
+
+} // namespace nsl
+
+/* fin */
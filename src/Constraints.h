@@ -0,0 +1,110 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Constraints.h
+
+   Class: BasicConstraints, Constraints
+
+   The prescribed displacements (boundary conditions) of a model:
+   a bit per degree of freedom marking the constrained ones, a dense
+   array with their values (0 for the free ones) and the lists of the
+   free and constrained degrees of freedom.  Built once per model,
+   so that the boundary conditions are applied and the solution is
+   scattered back without testing every degree of freedom again:
+
+     BasicVector<Real> f = constraints.gather(globalForces);
+     ... solve K u = f ...
+     BasicVector<Real> displacements = constraints.scatter(u);
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Constraints__
+#define __Constraints__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Access.h"
+#include "DVector.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicConstraints
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicConstraints {
+
+  std::size_t _size;
+
+  // Bit i % 64 of _mask[i / 64] is set for constrained degrees of freedom
+  std::vector<std::uint64_t> _mask;
+  std::vector<Real> _values;
+
+  std::vector<std::size_t> _freeDofs;
+  std::vector<std::size_t> _constrainedDofs;
+
+  // The index of every free degree of freedom in the reduced system
+  // (size() for the constrained ones)
+  std::vector<std::size_t> _freeIndex;
+
+ public:
+  BasicConstraints(std::size_t size = 0);
+  BasicConstraints(std::size_t size, const std::vector<std::size_t> &dofs, const std::vector<Real> &values);
+
+  std::size_t size() const;
+  std::size_t numberOfFree() const;
+  std::size_t numberOfConstrained() const;
+
+  bool isConstrained(std::size_t i) const;
+  Real value(std::size_t i) const;
+
+  const std::vector<Real> &values() const;
+  const std::vector<std::size_t> &freeDofs() const;
+  const std::vector<std::size_t> &constrainedDofs() const;
+  const std::vector<std::size_t> &freeIndex() const;
+
+  BasicVector<Real> gather(const BasicVector<Real> &v) const;
+  BasicVector<Real> scatter(const BasicVector<Real> &free) const;
+};
+
+typedef BasicConstraints<double> Constraints;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   True when the displacement of degree of freedom i is prescribed.
+*/
+template <typename Real>
+inline bool BasicConstraints<Real>::isConstrained(std::size_t i) const
+{
+  NSL_CHECK_ACCESS(i < _size);
+
+  return (_mask[i >> 6] >> (i & 63)) & 1;
+}
+
+/**
+   The prescribed displacement of degree of freedom i (0 when free).
+*/
+template <typename Real>
+inline Real BasicConstraints<Real>::value(std::size_t i) const
+{
+  NSL_CHECK_ACCESS(i < _size);
+
+  return _values[i];
+}
+
+} // namespace nsl
+
+#endif /* defined(__Constraints__) */
+
+/* fin */
@@ -4,7 +4,7 @@
    
    DMatrix.cpp
    
-   Class: DMatrix
+   Class: BasicMatrix
 
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -14,36 +14,66 @@
 
 #include <cassert>
 #include <cmath>
+#include <algorithm>
+#include <sstream>
 
+#include "Profiler.h"
+#include "MemoryTracker.h"
 #include "DVector.h"
 #include "DMatrix.h"
 
 namespace nsl {
 
+namespace {
+
+/**
+   Warn when a dense matrix of the given size 
+   would exceed the memory budget.
+*/
+template <typename Real>
+void checkMemoryBudget(std::size_t rows, std::size_t cols)
+{
+  if (MemoryTracker::budget() == 0) return;
+
+  std::ostringstream what;
+  what << "a dense " << rows << " x " << cols << " matrix";
+  MemoryTracker::checkBudget(std::uint64_t(rows) * cols * sizeof(Real), what.str().c_str());
+}
+
+} // namespace
+
 /** 
     Constructor.
 */
-DMatrix::DMatrix(std::size_t rows, std::size_t cols) 
+template <typename Real>
+BasicMatrix<Real>::BasicMatrix(std::size_t rows, std::size_t cols) 
 {
   _rows = rows;
   _cols = cols;
 
-  _v = new std::vector<double> (rows * cols);
+  checkMemoryBudget<Real>(rows, cols);
+
+  _v = new std::vector<Real> (rows * cols);
+  Profiler::countAllocation(rows * cols * sizeof(Real));
 }
 
 /** 
     Constructor.
 */
-DMatrix::DMatrix(const std::vector<std::vector<double> > &values)
+template <typename Real>
+BasicMatrix<Real>::BasicMatrix(const std::vector<std::vector<Real> > &values)
 {
   _rows = values.size();
   _cols = (_rows == 0) ? 0 : values[0].size();
 
-  _v = new std::vector<double> (_rows * _cols);
+  checkMemoryBudget<Real>(_rows, _cols);
+
+  _v = new std::vector<Real> (_rows * _cols);
+  Profiler::countAllocation(_rows * _cols * sizeof(Real));
 
   for (std::size_t row = 0; row < _rows; ++row)
     {
-      const std::vector<double> &rowValues = values[row];
+      const std::vector<Real> &rowValues = values[row];
       
       assert(rowValues.size() == _cols);
       
@@ -55,18 +85,23 @@ DMatrix::DMatrix(const std::vector<std::vector<double> > &values)
 /** 
     Copy constructor.
 */
-DMatrix::DMatrix(const DMatrix &matrix)
+template <typename Real>
+BasicMatrix<Real>::BasicMatrix(const BasicMatrix &matrix)
 {
   _rows = matrix._rows;
   _cols = matrix._cols;
 
-  _v = new std::vector<double> (*(matrix._v));
+  checkMemoryBudget<Real>(_rows, _cols);
+
+  _v = new std::vector<Real> (*(matrix._v));
+  Profiler::countAllocation(matrix.size() * sizeof(Real));
 }
 
 /** 
     Destructor.
 */
-DMatrix::~DMatrix() 
+template <typename Real>
+BasicMatrix<Real>::~BasicMatrix() 
 {
   delete _v;
 }
@@ -74,7 +109,8 @@ DMatrix::~DMatrix()
 /**
    = operator for initialization.
 */
-DMatrix &DMatrix::operator= (const std::vector<double> &values)
+template <typename Real>
+BasicMatrix<Real> &BasicMatrix<Real>::operator= (const std::vector<Real> &values)
 {
   assert(values.size() == size());
   
@@ -89,7 +125,8 @@ DMatrix &DMatrix::operator= (const std::vector<double> &values)
 /**
    = operator for initialization.
 */
-DMatrix &DMatrix::operator= (const std::vector<std::vector<double> > &values)
+template <typename Real>
+BasicMatrix<Real> &BasicMatrix<Real>::operator= (const std::vector<std::vector<Real> > &values)
 {
   assert(values.size() > 0);
 
@@ -100,7 +137,7 @@ DMatrix &DMatrix::operator= (const std::vector<std::vector<double> > &values)
 
   for (std::size_t row = 0; row < rows; ++row) 
     {
-      const std::vector<double> &rowValues = values[row];
+      const std::vector<Real> &rowValues = values[row];
       
       assert(rowValues.size() == cols);
       
@@ -114,7 +151,8 @@ DMatrix &DMatrix::operator= (const std::vector<std::vector<double> > &values)
 /**
    Number of elements.
 */
-std::size_t DMatrix::size() const
+template <typename Real>
+std::size_t BasicMatrix<Real>::size() const
 {
   return _rows * _cols;
 }
@@ -122,7 +160,8 @@ std::size_t DMatrix::size() const
 /**
    Number of columns.
 */
-std::size_t DMatrix::cols() const
+template <typename Real>
+std::size_t BasicMatrix<Real>::cols() const
 {
   return _cols;
 }
@@ -130,7 +169,8 @@ std::size_t DMatrix::cols() const
 /**
    Number of rows.
 */
-std::size_t DMatrix::rows() const
+template <typename Real>
+std::size_t BasicMatrix<Real>::rows() const
 {
   return _rows;
 }
@@ -138,57 +178,38 @@ std::size_t DMatrix::rows() const
 /**
    Resize the matrix
 */
-void DMatrix::resize(std::size_t rows, std::size_t cols)
+template <typename Real>
+void BasicMatrix<Real>::resize(std::size_t rows, std::size_t cols)
 { 
+  if (rows * cols > _v->size())
+    checkMemoryBudget<Real>(rows, cols);
+
   _rows = rows;
   _cols = cols;
 
   _v->resize(rows * cols);
 }
 
-/**
-   Element accessor.
-*/
-double &DMatrix::operator() (std::size_t row, std::size_t col)
-{
-  assert(row < _rows);
-  assert(col < _cols);
-
-  return (*_v)[row * _cols + col];
-}
-
-/**
-   Constant element accessor.
-*/
-double DMatrix::operator() (std::size_t row, std::size_t col) const
-{
-  assert(row < _rows);
-  assert(col < _cols);
-
-  return (*_v)[row * _cols + col];
-}
-
 /**
    Swap rows.
 */
-void DMatrix::swapRows(const std::size_t i, const std::size_t j)
+template <typename Real>
+void BasicMatrix<Real>::swapRows(const std::size_t i, const std::size_t j)
 {
   assert(i != j);
   assert(i < _rows);
   assert(j < _rows);
   
-  for (std::size_t col = 0; col < _cols; ++col)
-    {
-      double tmp = (*this)(i, col);
-      (*this)(i, col) = (*this)(j, col);
-      (*this)(j, col) = tmp;
-    }
+  Real *ri = row(i).data();
+  Real *rj = row(j).data();
+  std::swap_ranges(ri, ri + _cols, rj);
 }
 
 /**
    Remove rows and columns for which predicate(<column/row index>) is true.
 */
-void DMatrix::deleteRowsAndColumns(std::function<bool (std::size_t i)> predicate)
+template <typename Real>
+void BasicMatrix<Real>::deleteRowsAndColumns(std::function<bool (std::size_t i)> predicate)
 {
   // Calculate the size of the new matrix.
   // The number of rows/columns in the new matrix
@@ -206,7 +227,8 @@ void DMatrix::deleteRowsAndColumns(std::function<bool (std::size_t i)> predicate
 
   // Assemble the new matrix
   // using only those rows and columns for which the predicate(<index of row/column>) is false
-  std::vector<double> *v = new std::vector<double> (rowsNew * colsNew);
+  std::vector<Real> *v = new std::vector<Real> (rowsNew * colsNew);
+  Profiler::countAllocation(rowsNew * colsNew * sizeof(Real));
   
   std::size_t k = 0;
   for (std::size_t r = 0; r < _rows; ++r)
@@ -228,8 +250,11 @@ void DMatrix::deleteRowsAndColumns(std::function<bool (std::size_t i)> predicate
 /**
    Gaussian Elimination.
 */
-DVector DMatrix::gaussianElimination(const DVector &b_) const
+template <typename Real>
+BasicVector<Real> BasicMatrix<Real>::gaussianElimination(const BasicVector<Real> &b_) const
 {
+  ScopedTimer timer("gaussian elimination");
+
   // Gaussian Elimination only works for square matrices
   assert(_rows == _cols);
 
@@ -237,8 +262,8 @@ DVector DMatrix::gaussianElimination(const DVector &b_) const
   std::size_t n = _rows;
 
   // Copy matrix A and vector b
-  DMatrix A(*this);
-  DVector b(b_);
+  BasicMatrix A(*this);
+  BasicVector<Real> b(b_);
   
   for (std::size_t i = 0; i < n - 1; ++i) 
     {
@@ -249,11 +274,11 @@ DVector DMatrix::gaussianElimination(const DVector &b_) const
       // from A_(i, i) to A_(_rows-1, i).
       // The largest element is A_(row, i).
       std::size_t row = i;
-      double largest = abs(A(i, i));
+      Real largest = std::fabs(A(i, i));
 
       for (std::size_t r = i + 1; r < _rows; ++r)
 	{
-	  double current = abs(A(r, i));
+	  Real current = std::fabs(A(r, i));
 	  if (current > largest) 
 	    {
 	      row = r;
@@ -289,33 +314,47 @@ DVector DMatrix::gaussianElimination(const DVector &b_) const
       // =====================================
       // Elimination Step
       // -------------------------------------
+      // The kernel works on raw row views:
+      // the loop bounds already guarantee valid indices
+      const Real *pivotRow = A.row(i).data();
+      Real *bv = b.span().data();
+      
       for (std::size_t r = i + 1; r < _rows; ++r)
 	{
+	  Real *currentRow = A.row(r).data();
+
 	  // Multiplier
-	  double m = - A(r, i) / A(i, i);
+	  Real m = - currentRow[i] / pivotRow[i];
 
-	  A(r, i) = 0;
+	  currentRow[i] = 0;
 	  
 	  for (std::size_t c = i + 1; c < _cols; ++c) 
-	    A(r, c) += m * A(i, c);
+	    currentRow[c] += m * pivotRow[c];
 
-	  b(r) += m * b(i);
+	  bv[r] += m * bv[i];
 	}
+
+      // Division, row update and right hand side update per row
+      Profiler::countFlops((_rows - i - 1) * (2 * (_cols - i - 1) + 3));
     }
       
   // =====================================
   // Back substitution
   // -------------------------------------
-  DVector u(n);
+  BasicVector<Real> u(n);
+  const Real *bv = b.span().data();
+  Real *uv = u.span().data();
   for(std::size_t i = n; i-- > 0; )
     {
-      u(i) = b(i);
+      const Real *currentRow = A.row(i).data();
+      Real s = bv[i];
       
       for(std::size_t j = i + 1; j < n; ++j)
-	u(i) -= A(i , j) * u(j);
+	s -= currentRow[j] * uv[j];
 
-      u(i) /= A(i, i);
+      uv[i] = s / currentRow[i];
     }
+  Profiler::countFlops(n * n);
   
   return u;
 }
@@ -323,7 +362,8 @@ DVector DMatrix::gaussianElimination(const DVector &b_) const
 /**
    Equality operator.
  */
-bool operator== (const DMatrix &m1, const DMatrix &m2)
+template <typename Real>
+bool operator== (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2)
 {
   return (m1._rows == m2._rows &&
 	  m1._cols == m2._cols &&
@@ -333,7 +373,8 @@ bool operator== (const DMatrix &m1, const DMatrix &m2)
 /**
    Inequality operator.
  */
-bool operator!= (const DMatrix &m1, const DMatrix &m2)
+template <typename Real>
+bool operator!= (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2)
 {
   return !(m1 == m2);
 }
@@ -341,35 +382,42 @@ bool operator!= (const DMatrix &m1, const DMatrix &m2)
 /**
    Euclidean distance.
  */
-double euclideanDistance(const DMatrix &m1, const DMatrix &m2)
+template <typename Real>
+Real euclideanDistance(const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2)
 {
   assert(m1.cols() == m2.cols());
   assert(m1.rows() == m2.rows());
 
-  double ed = 0;
+  Real ed = 0;
   for (std::size_t i = 0; i < m1.size(); ++i) 
     {
-      double d = (*m1._v)[i] - (*m2._v)[i];
+      Real d = (*m1._v)[i] - (*m2._v)[i];
       ed += d * d;
     }
   
-  return sqrt(ed);
+  return std::sqrt(ed);
 }
 
 /**
    Multiplication operator: DMatrix * DVector -> DVector
 */
-DVector operator* (const DMatrix &m, const DVector &v)
+template <typename Real>
+BasicVector<Real> operator* (const BasicMatrix<Real> &m, const BasicVector<Real> &v)
 {
   assert(m.cols() == v.size());
 
-  DVector r(m.rows());
+  Profiler::countFlops(2 * m.size());
+
+  BasicVector<Real> r(m.rows());
+  const Real *vv = v.span().data();
+  Real *rv = r.span().data();
   for (std::size_t row = 0; row < m._rows; ++row)
     {
-      double &s = r(row);
-      s = 0;
+      const Real *currentRow = m.row(row).data();
+      Real s = 0;
       for (std::size_t col = 0; col < m._cols; ++col)
-	s += m(row, col) * v(col);
+	s += currentRow[col] * vv[col];
+      rv[row] = s;
     }
   
   return r;
@@ -378,7 +426,8 @@ DVector operator* (const DMatrix &m, const DVector &v)
 /**   
       os <<
 */
-std::ostream& operator<<(std::ostream& os, const DMatrix& m)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicMatrix<Real>& m)
 {
   for (std::size_t row = 0; row < m._rows; ++row)
     {
@@ -393,6 +442,21 @@ std::ostream& operator<<(std::ostream& os, const DMatrix& m)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicMatrix)
+
+#define INSTANTIATE(Real)						\
+  template bool operator== (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2); \
+  template bool operator!= (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2); \
+  template Real euclideanDistance(const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2); \
+  template BasicVector<Real> operator* (const BasicMatrix<Real> &m, const BasicVector<Real> &v); \
+  template std::ostream& operator<<(std::ostream& os, const BasicMatrix<Real>& m);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
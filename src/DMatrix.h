@@ -4,7 +4,7 @@
    
    DMatrix.h
    
-   Class: DMatrix
+   Class: BasicMatrix, DMatrix
 
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -18,26 +18,43 @@
 #include <cstddef>
 #include <iostream>
 #include <vector>
+#include <functional>
 
+#include "Access.h"
+#include "DSpan.h"
 #include "DVector.h"
 #include "FVector.h"
 
 namespace nsl {
 
-class DMatrix {
+template <typename Real> class BasicMatrix;
 
-  std::vector<double> *_v;
+template <typename Real>
+bool operator== (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2);
+template <typename Real>
+bool operator!= (const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2);
+template <typename Real>
+Real euclideanDistance(const BasicMatrix<Real> &m1, const BasicMatrix<Real> &m2);
+template <typename Real>
+BasicVector<Real> operator* (const BasicMatrix<Real> &m, const BasicVector<Real> &v);
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicMatrix<Real>& m);
+
+template <typename Real>
+class BasicMatrix {
+
+  std::vector<Real> *_v;
   std::size_t _cols, _rows;
 
  public:
   
-  DMatrix(std::size_t rows = 0, std::size_t cols = 0);
-  DMatrix(const std::vector<std::vector<double> > &values);
-  DMatrix(const DMatrix &matrix);
-  ~DMatrix();
+  BasicMatrix(std::size_t rows = 0, std::size_t cols = 0);
+  BasicMatrix(const std::vector<std::vector<Real> > &values);
+  BasicMatrix(const BasicMatrix &matrix);
+  ~BasicMatrix();
 
-  DMatrix &operator= (const std::vector<double> &values);
-  DMatrix &operator= (const std::vector<std::vector<double> > &values);
+  BasicMatrix &operator= (const std::vector<Real> &values);
+  BasicMatrix &operator= (const std::vector<std::vector<Real> > &values);
 
   std::size_t size() const;
   std::size_t cols() const;
@@ -45,24 +62,103 @@ class DMatrix {
 
   void resize(std::size_t rows, std::size_t cols);
 
-  double &operator() (std::size_t row, std::size_t column);
-  double operator() (std::size_t row, std::size_t column) const;
+  Real &operator() (std::size_t row, std::size_t column);
+  Real operator() (std::size_t row, std::size_t column) const;
+
+  Span<Real> row(std::size_t row);
+  Span<const Real> row(std::size_t row) const;
+  Span<Real> col(std::size_t col);
+  Span<const Real> col(std::size_t col) const;
 
   void swapRows(const std::size_t i, const std::size_t j);
   void deleteRowsAndColumns(std::function<bool (std::size_t i)> predicate);
   
-  DVector gaussianElimination(const DVector &b) const;
+  BasicVector<Real> gaussianElimination(const BasicVector<Real> &b) const;
 
-  friend bool operator== (const DMatrix &m1, const DMatrix &m2);
-  friend bool operator!= (const DMatrix &m1, const DMatrix &m2);
+  friend bool operator== <>(const BasicMatrix &m1, const BasicMatrix &m2);
+  friend bool operator!= <>(const BasicMatrix &m1, const BasicMatrix &m2);
   
-  friend double euclideanDistance(const DMatrix &m1, const DMatrix &m2);
+  friend Real euclideanDistance<>(const BasicMatrix &m1, const BasicMatrix &m2);
   
-  friend DVector operator* (const DMatrix &m, const DVector &v);
+  friend BasicVector<Real> operator* <>(const BasicMatrix &m, const BasicVector<Real> &v);
   
-  friend std::ostream& operator<<(std::ostream& os, const DMatrix& m);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicMatrix& m);
 };
 
+typedef BasicMatrix<double> DMatrix;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   Element accessor.
+*/
+template <typename Real>
+inline Real &BasicMatrix<Real>::operator() (std::size_t row, std::size_t col)
+{
+  NSL_CHECK_ACCESS(row < _rows);
+  NSL_CHECK_ACCESS(col < _cols);
+
+  return (*_v)[row * _cols + col];
+}
+
+/**
+   Constant element accessor.
+*/
+template <typename Real>
+inline Real BasicMatrix<Real>::operator() (std::size_t row, std::size_t col) const
+{
+  NSL_CHECK_ACCESS(row < _rows);
+  NSL_CHECK_ACCESS(col < _cols);
+
+  return (*_v)[row * _cols + col];
+}
+
+/**
+   View on a row (contiguous).
+*/
+template <typename Real>
+inline Span<Real> BasicMatrix<Real>::row(std::size_t row)
+{
+  NSL_CHECK_ACCESS(row < _rows);
+
+  return Span<Real>(_v->data() + row * _cols, _cols);
+}
+
+/**
+   Constant view on a row (contiguous).
+*/
+template <typename Real>
+inline Span<const Real> BasicMatrix<Real>::row(std::size_t row) const
+{
+  NSL_CHECK_ACCESS(row < _rows);
+
+  return Span<const Real>(_v->data() + row * _cols, _cols);
+}
+
+/**
+   View on a column (strided by the number of columns).
+*/
+template <typename Real>
+inline Span<Real> BasicMatrix<Real>::col(std::size_t col)
+{
+  NSL_CHECK_ACCESS(col < _cols);
+
+  return Span<Real>(_v->data() + col, _rows, _cols);
+}
+
+/**
+   Constant view on a column (strided by the number of columns).
+*/
+template <typename Real>
+inline Span<const Real> BasicMatrix<Real>::col(std::size_t col) const
+{
+  NSL_CHECK_ACCESS(col < _cols);
+
+  return Span<const Real>(_v->data() + col, _rows, _cols);
+}
+
 } // namespace nsl
 
 #endif /* defined(__DMatrix__) */
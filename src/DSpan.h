@@ -0,0 +1,86 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   DSpan.h
+
+   Class: Span, DSpan, DConstSpan
+
+   A non-owning view on a sequence of doubles with a fixed stride.
+   Used to hand rows (stride 1) and columns (stride = number of
+   columns) of a DMatrix or the elements of a DVector to the solver
+   kernels without copying them.
+
+   The view is only valid as long as the underlying storage is
+   neither resized nor destroyed.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __DSpan__
+#define __DSpan__
+
+#include <cstddef>
+
+#include "Access.h"
+
+namespace nsl {
+
+// =========================================================
+// class Span
+// ---------------------------------------------------------
+
+template <typename T>
+class Span {
+
+  T *_p;
+  std::size_t _size;
+  std::size_t _stride;
+
+ public:
+
+  Span(T *p = nullptr, std::size_t size = 0, std::size_t stride = 1)
+    : _p(p), _size(size), _stride(stride) {}
+
+  /**
+     Number of elements.
+  */
+  std::size_t size() const { return _size; }
+
+  /**
+     Distance between two consecutive elements in the underlying storage.
+  */
+  std::size_t stride() const { return _stride; }
+
+  /**
+     True when the elements are stored contiguously.
+  */
+  bool contiguous() const { return _stride == 1; }
+
+  /**
+     Pointer to the first element.
+  */
+  T *data() const { return _p; }
+
+  /**
+     Element accessor.
+  */
+  T &operator() (std::size_t i) const
+  {
+    NSL_CHECK_ACCESS(i < _size);
+
+    return _p[i * _stride];
+  }
+};
+
+typedef Span<double>       DSpan;
+typedef Span<const double> DConstSpan;
+
+} // namespace nsl
+
+#endif /* defined(__DSpan__) */
+
+/* fin */
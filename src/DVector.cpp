@@ -4,7 +4,7 @@
    
    DVector.cpp
 
-   Class: DVector
+   Class: BasicVector
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -16,6 +16,7 @@
 #include <cassert>
 #include <cmath>
 
+#include "Profiler.h"
 #include "DVector.h"
 
 namespace nsl {
@@ -23,31 +24,38 @@ namespace nsl {
 /** 
     Constructor.
 */
-DVector::DVector(std::size_t size) 
+template <typename Real>
+BasicVector<Real>::BasicVector(std::size_t size) 
 {
-  _v = new std::vector<double> (size);
+  _v = new std::vector<Real> (size);
+  Profiler::countAllocation(size * sizeof(Real));
 }
 
 /** 
     Constructor.
 */
-DVector::DVector(const std::vector<double> &values)
+template <typename Real>
+BasicVector<Real>::BasicVector(const std::vector<Real> &values)
 {
-  _v = new std::vector<double> (values);
+  _v = new std::vector<Real> (values);
+  Profiler::countAllocation(values.size() * sizeof(Real));
 }
 
 /** 
     Constructor.
 */
-DVector::DVector(const DVector &v)
+template <typename Real>
+BasicVector<Real>::BasicVector(const BasicVector &v)
 {
-  _v = new std::vector<double> (*(v._v));
+  _v = new std::vector<Real> (*(v._v));
+  Profiler::countAllocation(v.size() * sizeof(Real));
 }
 
 /** 
     Destructor.
 */
-DVector::~DVector() 
+template <typename Real>
+BasicVector<Real>::~BasicVector() 
 {
   delete _v;
 }
@@ -55,7 +63,8 @@ DVector::~DVector()
 /**
    = operator for initialization.
  */
-DVector &DVector::operator= (const std::vector<double> &values)
+template <typename Real>
+BasicVector<Real> &BasicVector<Real>::operator= (const std::vector<Real> &values)
 {
   std::size_t size = values.size();
   this->resize(size);
@@ -69,7 +78,8 @@ DVector &DVector::operator= (const std::vector<double> &values)
 /**
    Number of elements.
 */
-std::size_t DVector::size() const
+template <typename Real>
+std::size_t BasicVector<Real>::size() const
 {
   return _v->size();
 }
@@ -77,7 +87,8 @@ std::size_t DVector::size() const
 /**
    Resize the vector.
 */
-void DVector::resize(std::size_t size)
+template <typename Real>
+void BasicVector<Real>::resize(std::size_t size)
 { 
   _v->resize(size);
 }
@@ -85,13 +96,14 @@ void DVector::resize(std::size_t size)
 /**
    Swap elements.
  */
-void DVector::swapElements(const std::size_t i, const std::size_t j)
+template <typename Real>
+void BasicVector<Real>::swapElements(const std::size_t i, const std::size_t j)
 {
   assert(i != j);
   assert(i < size());
   assert(j < size());
   
-  double tmp = (*this)(i);
+  Real tmp = (*this)(i);
   (*this)(i) = (*this)(j);
   (*this)(j) = tmp;
 }
@@ -99,7 +111,8 @@ void DVector::swapElements(const std::size_t i, const std::size_t j)
 /**
    Apply boundary conditions.
 */
-void DVector:: applyBoundaryConditions(const FVector displacementVector)
+template <typename Real>
+void BasicVector<Real>::applyBoundaryConditions(const BasicFVector<Real> displacementVector)
 { 
   std::size_t sizeDisplacementVector = displacementVector.size();
 
@@ -109,7 +122,8 @@ void DVector:: applyBoundaryConditions(const FVector displacementVector)
   // Size of the new vector
   // All elements for which a displacement is defined are removed
   std::size_t sizeNew = sizeDisplacementVector - displacementVector.numberOfDefinedElements();
-  std::vector<double> *v = new std::vector<double> (sizeNew);
+  std::vector<Real> *v = new std::vector<Real> (sizeNew);
+  Profiler::countAllocation(sizeNew * sizeof(Real));
   
   std::size_t j = 0;
   for (std::size_t i = 0; i < size(); ++i)
@@ -125,7 +139,8 @@ void DVector:: applyBoundaryConditions(const FVector displacementVector)
 /**
    Remove elements for which predicate(<element index>) is true.
  */
-void DVector::deleteElements(std::function<bool (std::size_t i)> predicate)
+template <typename Real>
+void BasicVector<Real>::deleteElements(std::function<bool (std::size_t i)> predicate)
 {
   // Calculate the size of the new vector.
   // The number of elements in the new vector
@@ -138,7 +153,8 @@ void DVector::deleteElements(std::function<bool (std::size_t i)> predicate)
 
   // Assemble the new vector
   // using only those elements for which the predicate(<index of row/column>) is false
-  std::vector<double> *v = new std::vector<double> (sizeNew);
+  std::vector<Real> *v = new std::vector<Real> (sizeNew);
+  Profiler::countAllocation(sizeNew * sizeof(Real));
   std::size_t j = 0;
   for (std::size_t i = 0; i < size(); ++i)
     // Only use the elements for which predicate(i) is false
@@ -150,30 +166,11 @@ void DVector::deleteElements(std::function<bool (std::size_t i)> predicate)
   _v = v;
 }
 
-/**
-   Element accessor.
- */
-double &DVector::operator() (std::size_t i)
-{
-  assert(0 <= i && i < _v->size());
-
-  return (*_v)[i];
-}
-
-/**
-   Constant element accessor.
- */
-double DVector::operator() (std::size_t i) const
-{
-  assert(0 <= i && i < _v->size());
-
-  return (*_v)[i];
-}
-
 /**
    Equality operator.
  */
-bool operator== (const DVector &v1, const DVector &v2)
+template <typename Real>
+bool operator== (const BasicVector<Real> &v1, const BasicVector<Real> &v2)
 {
   return (*v1._v == *v2._v);
 }
@@ -181,7 +178,8 @@ bool operator== (const DVector &v1, const DVector &v2)
 /**
    Inequality operator.
  */
-bool operator!= (const DVector &v1, const DVector &v2)
+template <typename Real>
+bool operator!= (const BasicVector<Real> &v1, const BasicVector<Real> &v2)
 {
   return !(v1 == v2);
 }
@@ -189,30 +187,32 @@ bool operator!= (const DVector &v1, const DVector &v2)
 /**
    Euclidean distance.
  */
-double euclideanDistance(const DVector &v1, const DVector &v2)
+template <typename Real>
+Real euclideanDistance(const BasicVector<Real> &v1, const BasicVector<Real> &v2)
 {
   assert(v1.size() == v2.size());
 
-  double ed = 0;
+  Real ed = 0;
   for (std::size_t i = 0; i < v1.size(); ++i) 
     {
-      double d = v1(i) - v2(i);
+      Real d = v1(i) - v2(i);
       ed += d * d;
     }
   
-  return sqrt(ed);
+  return std::sqrt(ed);
 }
   
 /**
    Multiplication operator: DVector * DVector -> DVector
  */
-double operator* (const DVector &v1, const DVector &v2)
+template <typename Real>
+Real operator* (const BasicVector<Real> &v1, const BasicVector<Real> &v2)
 {
   // Assert that both vectors have the same dimension
   assert(v1.size() == v2.size());
 
   // Multiply
-  double result = 0;
+  Real result = 0;
   for (std::size_t i = 0; i < v1.size(); ++i)
     result += v1(i) * v2(i);
   
@@ -222,7 +222,8 @@ double operator* (const DVector &v1, const DVector &v2)
 /**   
   os <<
 */
-std::ostream& operator<<(std::ostream& os, const DVector& m)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicVector<Real>& m)
 {
   for (std::size_t i = 0; i < m.size(); ++i)
     {
@@ -233,6 +234,21 @@ std::ostream& operator<<(std::ostream& os, const DVector& m)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicVector)
+
+#define INSTANTIATE(Real)						\
+  template bool operator== (const BasicVector<Real> &v1, const BasicVector<Real> &v2); \
+  template bool operator!= (const BasicVector<Real> &v1, const BasicVector<Real> &v2); \
+  template Real euclideanDistance(const BasicVector<Real> &v1, const BasicVector<Real> &v2); \
+  template Real operator* (const BasicVector<Real> &v1, const BasicVector<Real> &v2); \
+  template std::ostream& operator<<(std::ostream& os, const BasicVector<Real>& m);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
@@ -4,7 +4,7 @@
    
    DVector.h
 
-   Class: DVector
+   Class: BasicVector, DVector
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -17,49 +17,115 @@
 
 #include <iostream>
 #include <vector>
+#include <functional>
 
+#include "Access.h"
+#include "DSpan.h"
 #include "FVector.h"
 
 namespace nsl {
 
+template <typename Real> class BasicVector;
+
+template <typename Real>
+bool operator== (const BasicVector<Real> &v1, const BasicVector<Real> &v2);
+template <typename Real>
+bool operator!= (const BasicVector<Real> &v1, const BasicVector<Real> &v2);
+template <typename Real>
+Real euclideanDistance(const BasicVector<Real> &v1, const BasicVector<Real> &v2);
+template <typename Real>
+Real operator* (const BasicVector<Real> &v1, const BasicVector<Real> &v2);
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicVector<Real>& v);
+
 // =========================================================
-// class DVector
+// class BasicVector
 // ---------------------------------------------------------
 
-class DVector {
+template <typename Real>
+class BasicVector {
 
-  std::vector<double> *_v;
+  std::vector<Real> *_v;
 
  public:
   
-  DVector(std::size_t size = 0);
-  DVector(const std::vector<double> &values);
-  DVector(const DVector &vector);
-  ~DVector();
+  BasicVector(std::size_t size = 0);
+  BasicVector(const std::vector<Real> &values);
+  BasicVector(const BasicVector &vector);
+  ~BasicVector();
 
-  DVector &operator= (const std::vector<double> &values);
+  BasicVector &operator= (const std::vector<Real> &values);
   
   std::size_t size() const;
 
   void resize(std::size_t size);
 
   void swapElements(const std::size_t i, const std::size_t j);
-  void applyBoundaryConditions(const FVector displacementVector);
+  void applyBoundaryConditions(const BasicFVector<Real> displacementVector);
   void deleteElements(std::function<bool (std::size_t i)> predicate);
   
-  double &operator() (std::size_t i);
-  double operator() (std::size_t i) const;
+  Real &operator() (std::size_t i);
+  Real operator() (std::size_t i) const;
+
+  Span<Real> span();
+  Span<const Real> span() const;
 
-  friend bool operator== (const DVector &v1, const DVector &v2);
-  friend bool operator!= (const DVector &v1, const DVector &v2);
+  friend bool operator== <>(const BasicVector &v1, const BasicVector &v2);
+  friend bool operator!= <>(const BasicVector &v1, const BasicVector &v2);
 
-  friend double euclideanDistance(const DVector &v1, const DVector &v2);
+  friend Real euclideanDistance<>(const BasicVector &v1, const BasicVector &v2);
   
-  friend double operator* (const DVector &v1, const DVector &v2);
+  friend Real operator* <>(const BasicVector &v1, const BasicVector &v2);
   
-  friend std::ostream& operator<<(std::ostream& os, const DVector& v);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicVector& v);
 };
 
+typedef BasicVector<double> DVector;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   Element accessor.
+ */
+template <typename Real>
+inline Real &BasicVector<Real>::operator() (std::size_t i)
+{
+  NSL_CHECK_ACCESS(i < _v->size());
+
+  return (*_v)[i];
+}
+
+/**
+   Constant element accessor.
+ */
+template <typename Real>
+inline Real BasicVector<Real>::operator() (std::size_t i) const
+{
+  NSL_CHECK_ACCESS(i < _v->size());
+
+  return (*_v)[i];
+}
+
+/**
+   View on all elements.
+ */
+template <typename Real>
+inline Span<Real> BasicVector<Real>::span()
+{
+  return Span<Real>(_v->data(), _v->size());
+}
+
+/**
+   Constant view on all elements.
+ */
+template <typename Real>
+inline Span<const Real> BasicVector<Real>::span() const
+{
+  return Span<const Real>(_v->data(), _v->size());
+}
+
 } // namespace nsl
 
 #endif /* defined(__DVector__) */
@@ -0,0 +1,83 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   DenseSolver.cpp
+
+   Class: BasicDenseSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <iostream>
+
+#include "Profiler.h"
+#include "DenseSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicDenseSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+LinearSolverBase::Type BasicDenseSolver<Real>::type() const
+{
+  return LinearSolverBase::DENSE;
+}
+
+/**
+   Factorize the upper triangle of a full symmetric matrix.
+*/
+template <typename Real>
+void BasicDenseSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  factorSymmetric(BasicSymmetricSMatrix<Real>(matrix));
+}
+
+/**
+   Copy the matrix into packed storage and factorize it in place.
+*/
+template <typename Real>
+void BasicDenseSolver<Real>::factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  _factor = matrix.toPacked();
+  factor();
+}
+
+template <typename Real>
+void BasicDenseSolver<Real>::factor()
+{
+  ScopedTimer timer("dense factorization");
+
+  std::size_t pivot;
+  Real value;
+  if (!_factor.eliminate(pivot, value))
+    {
+      std::cerr 
+	<< "ERROR The matrix is not solvable!" << std::endl
+	<< std::endl
+	<< "The stiffness matrix is not positive definite (pivot " << pivot << ": " << value << ")." << std::endl
+	<< "Is there a part of the assemblage without prescribed displacement?" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+template <typename Real>
+BasicVector<Real> BasicDenseSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  return _factor.eliminateSolve(b);
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicDenseSolver)
+
+} // namespace nsl
+
+/* fin */
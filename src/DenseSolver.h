@@ -0,0 +1,54 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   DenseSolver.h
+
+   Class: BasicDenseSolver, DenseSolver
+
+   Gaussian elimination of the matrix in symmetric packed storage
+   (see PMatrix.h).  O(n^3) time and O(n^2) memory, but exact for the
+   small textbook models and independent of the structure of the
+   matrix.  Only the upper triangle is stored: half the memory of
+   a full dense matrix.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __DenseSolver__
+#define __DenseSolver__
+
+#include "PMatrix.h"
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicDenseSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicDenseSolver : public BasicLinearSolver<Real> {
+
+  BasicPackedMatrix<Real> _factor;
+
+ public:
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  void factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+ private:
+  void factor();
+};
+
+typedef BasicDenseSolver<double> DenseSolver;
+
+} // namespace nsl
+
+#endif /* defined(__DenseSolver__) */
+
+/* fin */
@@ -4,7 +4,7 @@
    
    FDouble.cpp
    
-   Class: FDouble
+   Class: BasicFValue
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -20,46 +20,54 @@
 namespace nsl {
 
 // =========================================================
-// Class FDouble
+// Class BasicFValue
 // ---------------------------------------------------------
 
-FDouble::FDouble() : _defined(false), _value(0.0) {}
+template <typename Real>
+BasicFValue<Real>::BasicFValue() : _defined(false), _value(0.0) {}
 
-FDouble::FDouble(const double value)
+template <typename Real>
+BasicFValue<Real>::BasicFValue(const Real value)
 {
   set(value);
 }
 
-FDouble::FDouble(const FDouble &fdouble) 
+template <typename Real>
+BasicFValue<Real>::BasicFValue(const BasicFValue &fvalue) 
 {
-  _defined = fdouble._defined;
-  _value   = fdouble._value;
+  _defined = fvalue._defined;
+  _value   = fvalue._value;
 }
 
-FDouble::~FDouble() {}
+template <typename Real>
+BasicFValue<Real>::~BasicFValue() {}
 
 // =========================================================
 // Accessors
 // ---------------------------------------------------------
 
-void FDouble::set(double value)
+template <typename Real>
+void BasicFValue<Real>::set(Real value)
 {
   _defined = true;
   _value   = value;
 }
 
-void FDouble::unset()
+template <typename Real>
+void BasicFValue<Real>::unset()
 {
   _defined = false;
   _value   = 0.0;
 }
 
-bool FDouble::isDefined() const
+template <typename Real>
+bool BasicFValue<Real>::isDefined() const
 {
   return _defined;
 }
 
-double FDouble::getValue() const
+template <typename Real>
+Real BasicFValue<Real>::getValue() const
 {
   assert(_defined);
   
@@ -70,16 +78,28 @@ double FDouble::getValue() const
 // Friends
 // ---------------------------------------------------------
 
-std::ostream& operator<<(std::ostream& os, const FDouble &fdouble)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFValue<Real> &fvalue)
 {
-  if (fdouble._defined) 
-    os << fdouble._value;
+  if (fvalue._defined) 
+    os << fvalue._value;
   else
     os << "-";
 
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicFValue)
+
+#define INSTANTIATE(Real)						\
+  template std::ostream& operator<<(std::ostream& os, const BasicFValue<Real> &fvalue);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
@@ -4,7 +4,10 @@
    
    FDouble.h
    
-   Class: FDouble
+   Class: BasicFValue, FDouble
+
+   An optional value: a number or undefined (for example the
+   displacement of a node, which is only given for some nodes).
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -15,34 +18,46 @@
 #ifndef __FDouble__
 #define __FDouble__
 
+#include <iostream>
+
+#include "Precision.h"
+
 namespace nsl {
 
+template <typename Real> class BasicFValue;
+
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFValue<Real> &fvalue);
+
 // =========================================================
-// class FDouble
+// class BasicFValue
 // ---------------------------------------------------------
 
-class FDouble {
+template <typename Real>
+class BasicFValue {
 
 private:
   bool _defined;
-  double _value;
+  Real _value;
 
 public:
-  FDouble();
-  FDouble(const double value);
-  FDouble(const FDouble &value);
-  ~FDouble();
+  BasicFValue();
+  BasicFValue(const Real value);
+  BasicFValue(const BasicFValue &value);
+  ~BasicFValue();
 
   // Accessors
-  void set(double value);
+  void set(Real value);
   void unset();
   bool isDefined() const;
-  double getValue() const;
+  Real getValue() const;
 
   // Friends  
-  friend std::ostream& operator<<(std::ostream& os, const FDouble &fdouble);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicFValue &fvalue);
 };
 
+typedef BasicFValue<double> FDouble;
+
 } // namespace nsl
 
 #endif /* defined(__FDouble__) */
@@ -4,7 +4,7 @@
    
    FEM.cpp
    
-   Class: FEM
+   Class: BasicFEM
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -15,175 +15,2059 @@
 #include <string>
 #include <map>
 #include <iostream>
+#include <algorithm>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cmath>
 
 #include "Parser.h"
 #include "Node.h"
 #include "Spring.h"
+#include "ThreadPool.h"
+#include "Profiler.h"
+#include "UnionFind.h"
+#include "RefinementSolver.h"
+#include "SparseSolver.h"
+#include "CGSolver.h"
+#include "Random.h"
+#include "Statistics.h"
 
 #include "FEM.h"
 
 namespace nsl {
 
+namespace {
+
+/**
+   The connected components of the graph of a stiffness matrix:
+   the row indices of every component in ascending order,
+   the components ordered by their first row.
+*/
+template <typename Real>
+std::vector<std::vector<std::size_t> > independentParts(const BasicSMatrix<Real> &matrix)
+{
+  UnionFind sets(matrix.rows());
+  for (std::size_t i = 0; i < matrix.rows(); ++i)
+    for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+      sets.unite(i, matrix.colIndex()[k]);
+
+  std::vector<std::vector<std::size_t> > parts;
+  std::vector<std::size_t> partOf(matrix.rows(), matrix.rows());
+  for (std::size_t i = 0; i < matrix.rows(); ++i)
+    {
+      std::size_t root = sets.find(i);
+      if (partOf[root] == matrix.rows())
+	{
+	  partOf[root] = parts.size();
+	  parts.push_back(std::vector<std::size_t>());
+	}
+      parts[partOf[root]].push_back(i);
+    }
+
+  return parts;
+}
+
+/**
+   The bridges of an undirected multigraph: the edges whose removal
+   disconnects their ends.  Edge e connects the vertices a[e] and
+   b[e] (a[e] != b[e]); parallel edges are no bridges.  Tarjan's
+   low-link algorithm with an explicit stack, in O(vertices + edges).
+*/
+std::vector<bool> bridges(std::size_t vertices, const std::vector<std::size_t> &a, const std::vector<std::size_t> &b)
+{
+  std::size_t m = a.size();
+
+  // The edges at each vertex
+  std::vector<std::size_t> start(vertices + 1, 0), incident(2 * m);
+  for (std::size_t e = 0; e < m; ++e)
+    {
+      ++start[a[e] + 1];
+      ++start[b[e] + 1];
+    }
+  for (std::size_t v = 0; v < vertices; ++v)
+    start[v + 1] += start[v];
+  std::vector<std::size_t> next(start.begin(), start.end() - 1);
+  for (std::size_t e = 0; e < m; ++e)
+    {
+      incident[next[a[e]]++] = e;
+      incident[next[b[e]]++] = e;
+    }
+
+  // A vertex on the depth first search path, the edge it has been
+  // reached by and its next incident edge to follow
+  struct Frame {
+    std::size_t vertex, edge, next;
+  };
+
+  std::vector<bool> bridge(m, false);
+  std::vector<std::size_t> order(vertices, vertices), low(vertices);
+  std::vector<Frame> path;
+  std::size_t visited = 0;
+  for (std::size_t root = 0; root < vertices; ++root)
+    {
+      if (order[root] != vertices) continue;
+
+      order[root] = low[root] = visited++;
+      path.push_back({ root, m, start[root] });
+      while (!path.empty())
+	{
+	  Frame &frame = path.back();
+	  if (frame.next < start[frame.vertex + 1])
+	    {
+	      std::size_t e = incident[frame.next++];
+	      if (e == frame.edge) continue;
+
+	      std::size_t w = a[e] == frame.vertex ? b[e] : a[e];
+	      if (order[w] == vertices)
+		{
+		  order[w] = low[w] = visited++;
+		  path.push_back({ w, e, start[w] });
+		}
+	      else
+		low[frame.vertex] = std::min(low[frame.vertex], order[w]);
+	    }
+	  else
+	    {
+	      Frame done = frame;
+	      path.pop_back();
+	      if (path.empty()) continue;
+
+	      std::size_t parent = path.back().vertex;
+	      low[parent] = std::min(low[parent], low[done.vertex]);
+	      if (low[done.vertex] > order[parent]) bridge[done.edge] = true;
+	    }
+	}
+    }
+
+  return bridge;
+}
+
+/**
+   Conjugate gradients preconditioned with the factorization of a
+   nearby matrix: the nominal stiffness matrix for the samples of
+   the Monte Carlo analysis.  The less the matrices differ, the fewer
+   iterations are needed.
+*/
+template <typename Real>
+class NominalCGSolver : public BasicCGSolver<Real> {
+
+  const BasicLinearSolver<Real> &_nominal;
+
+ public:
+  NominalCGSolver(const BasicLinearSolver<Real> &nominal) : _nominal(nominal) {}
+
+ protected:
+  void precondition(const std::vector<Real> &r, std::vector<Real> &z) const
+  {
+    BasicVector<Real> x = _nominal.solve(BasicVector<Real>(r));
+    const Real *xx = x.span().data();
+    std::copy(xx, xx + r.size(), z.begin());
+  }
+};
+
+/**
+   The contributions of every spring to the reduced stiffness matrix
+   and force vector (see BasicFEM::applyBoundaryConditions()), for
+   assembling them again with other spring constants, forces or
+   prescribed displacements into a matrix with the same pattern.
+*/
+template <typename Real>
+class ReducedSystem {
+
+  static const std::size_t none = (std::size_t) -1;
+
+  // The positions of the contributions of each spring in the values
+  // of the reduced matrix (`none': no contribution) and, when one
+  // node is constrained, the free node and the constrained node
+  // (the force k u_c at the free node)
+  std::vector<std::size_t> _diagonal1, _diagonal2, _offDiagonal;
+  std::vector<std::size_t> _shiftRow, _shiftNode;
+
+ public:
+  ReducedSystem(const std::vector<int> &node1, const std::vector<int> &node2,
+		const BasicConstraints<Real> &constraints,
+		const BasicSymmetricSMatrix<Real> &matrix)
+    : _diagonal1(node1.size(), none), _diagonal2(node1.size(), none), _offDiagonal(node1.size(), none),
+      _shiftRow(node1.size(), none), _shiftNode(node1.size(), none)
+  {
+    const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
+    std::size_t free = constraints.numberOfFree();
+    for (std::size_t s = 0; s < node1.size(); ++s)
+      {
+	std::size_t a = node1[s];
+	std::size_t b = node2[s];
+	if (a == b) continue;
+
+	std::size_t p = freeIndex[a], q = freeIndex[b];
+	if (p < free) _diagonal1[s] = matrix.position(p, p);
+	if (q < free) _diagonal2[s] = matrix.position(q, q);
+	if (p < free && q < free) _offDiagonal[s] = matrix.position(p, q);
+	else if (p < free)
+	  {
+	    _shiftRow[s] = p;
+	    _shiftNode[s] = b;
+	  }
+	else if (q < free)
+	  {
+	    _shiftRow[s] = q;
+	    _shiftNode[s] = a;
+	  }
+      }
+  }
+
+  /**
+     The values of the reduced matrix for the spring constants k.
+  */
+  void assembleMatrix(const Real *k, std::vector<Real> &values) const
+  {
+    std::fill(values.begin(), values.end(), Real(0));
+    for (std::size_t s = 0; s < _diagonal1.size(); ++s)
+      {
+	if (_diagonal1[s] != none) values[_diagonal1[s]] += k[s];
+	if (_diagonal2[s] != none) values[_diagonal2[s]] += k[s];
+	if (_offDiagonal[s] != none) values[_offDiagonal[s]] -= k[s];
+      }
+    Profiler::countFlops(3 * _diagonal1.size());
+  }
+
+  /**
+     Add the forces caused by the prescribed displacements
+     (indexed by node) to the given forces f at the free nodes.
+  */
+  void assembleForces(const Real *k, const Real *displacement, BasicVector<Real> &f) const
+  {
+    for (std::size_t s = 0; s < _shiftRow.size(); ++s)
+      if (_shiftRow[s] != none) f(_shiftRow[s]) += k[s] * displacement[_shiftNode[s]];
+    Profiler::countFlops(2 * _shiftRow.size());
+  }
+};
+
+/**
+   Solves reduced systems with the pattern of a nominal matrix, one
+   per thread: with a direct solver selected by repeating the numeric
+   factorization of a copy of the nominal factorization, otherwise
+   (or when the numeric factorization fails) by conjugate gradients
+   preconditioned with the nominal factorization.
+*/
+template <typename Real>
+class PatternSolver {
+
+  const BasicSparseSolver<Real> &_nominal;
+  bool _refactor;
+  std::unique_ptr<BasicSparseSolver<Real> > _solver;
+
+ public:
+  BasicSymmetricSMatrix<Real> matrix;  // The matrix to solve, with the nominal pattern
+
+  PatternSolver(const BasicSparseSolver<Real> &nominal, const BasicSymmetricSMatrix<Real> &pattern, bool refactor)
+    : _nominal(nominal), _refactor(refactor), matrix(pattern) {}
+
+  /**
+     Solve `matrix' x = f; `fellBack' tells whether the numeric
+     factorization failed and conjugate gradients have been used.
+  */
+  BasicVector<Real> solve(const BasicVector<Real> &f, bool &fellBack)
+  {
+    if (_refactor && !_solver) _solver.reset(new BasicSparseSolver<Real>(_nominal));
+
+    bool factorized = _refactor && _solver->tryRefactor(matrix);
+    fellBack = _refactor && !factorized;
+    if (factorized) return _solver->solve(f);
+
+    NominalCGSolver<Real> cg(_nominal);
+    cg.factorSymmetric(matrix);
+    return cg.solve(f);
+  }
+};
+
+} // namespace
+
+// =========================================================
+// Struct BasicElementResults
+// ---------------------------------------------------------
+
+template <typename Real>
+BasicElementResults<Real>::BasicElementResults(std::size_t springs)
+  : localForce1(springs), localForce2(springs),
+    elongation(springs), strainEnergy(springs) {}
+
+template <typename Real>
+void BasicElementResults<Real>::resize(std::size_t springs)
+{
+  localForce1.resize(springs);
+  localForce2.resize(springs);
+  elongation.resize(springs);
+  strainEnergy.resize(springs);
+}
+
+// =========================================================
+// Struct BasicContingencyResults
+// ---------------------------------------------------------
+
+template <typename Real>
+BasicContingencyResults<Real>::BasicContingencyResults(std::size_t nodes, std::size_t springs)
+  : displacement(nodes), displacementCase(nodes),
+    force(nodes), forceCase(nodes),
+    springForce(springs), springForceCase(springs) {}
+
+template <typename Real>
+void BasicContingencyResults<Real>::resize(std::size_t nodes, std::size_t springs)
+{
+  displacement.resize(nodes);
+  displacementCase.resize(nodes);
+  force.resize(nodes);
+  forceCase.resize(nodes);
+  springForce.resize(springs);
+  springForceCase.resize(springs);
+  unstable.clear();
+}
+
+// =========================================================
+// Struct BasicMonteCarloResults
+// ---------------------------------------------------------
+
+template <typename Real>
+BasicMonteCarloResults<Real>::BasicMonteCarloResults(std::size_t nodes, const std::vector<double> &probabilities)
+  : probabilities(probabilities), samples(0), fallbacks(0), mean(nodes), deviation(nodes)
+{
+  for (std::size_t j = 0; j < probabilities.size(); ++j)
+    quantiles.push_back(BasicVector<Real>(nodes));
+}
+
+template <typename Real>
+void BasicMonteCarloResults<Real>::resize(std::size_t nodes)
+{
+  mean.resize(nodes);
+  deviation.resize(nodes);
+  quantiles.clear();
+  for (std::size_t j = 0; j < probabilities.size(); ++j)
+    quantiles.push_back(BasicVector<Real>(nodes));
+}
+
 // =========================================================
-// Class FEM
+// Class BasicFEM
 // ---------------------------------------------------------
 
-FEM::FEM() {}
+template <typename Real>
+BasicFEM<Real>::BasicFEM() {}
+
+template <typename Real>
+BasicFEM<Real>::BasicFEM(const std::vector<std::string> &files)
+{
+  // Parse the definition files
+  // and create the finite element model
+  BasicParser<Real> parser(this, files);
+  parser.parse();
+}
+
+template <typename Real>
+BasicFEM<Real>::~BasicFEM()
+{
+  // Delete all springs
+  for (auto spring : _springs)
+    delete spring;
+  _springs.clear();
+  
+  // Delete all nodes
+  for (auto node : _nodes)
+    delete node;
+  _nodes.clear();
+
+  // Clear the indices
+  _springIndexToIDMap.clear();
+  _springIDToIndexMap.clear();
+  _nodeIndexToIDMap.clear();
+  _nodeIDToIndexMap.clear();
+  
+  // Delete force vector, stiffness matrix
+  if (_globalForceVector) delete _globalForceVector;
+  if (_globalStiffnessMatrix) delete _globalStiffnessMatrix;
+  if (_globalDisplacementVector) delete _globalDisplacementVector;
+  if (_constraints) delete _constraints;
+  if (_lowRank) delete _lowRank;
+}
+
+// =========================================================
+// Methods
+// ---------------------------------------------------------
+
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::getGlobalForceVector()
+{
+  // The force vector is calculated on first use
+  if (!_globalForceVector) calculateGlobalForceVector();
+
+  return *_globalForceVector;
+}
+
+template <typename Real>
+Real BasicFEM<Real>::getGlobalForce(const int nodeID)
+{
+  // The force vector is calculated on first use
+  if (!_globalForceVector) calculateGlobalForceVector();
+
+  // Get index of node
+  int i = _nodeIDToIndexMap[nodeID];
+
+  // Return the corresponding force
+  return (*_globalForceVector)(i);
+}
+
+template <typename Real>
+BasicMatrix<Real> BasicFEM<Real>::getGlobalStiffnessMatrix()
+{
+  // Not assembled by solve() when the model has been reduced
+  if (!_globalStiffnessMatrix) _globalStiffnessMatrix = new BasicSymmetricSMatrix<Real>(assembleGlobalStiffnessMatrix());
+
+  return _globalStiffnessMatrix->toDense();
+}
+
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::getGlobalDisplacementVector()
+{
+  return *_globalDisplacementVector;
+}
+
+template <typename Real>
+Real BasicFEM<Real>::getGlobalDisplacement(const int nodeID)
+{
+  // Get index of node
+  int i = _nodeIDToIndexMap[nodeID];
+
+  // Return the corresponding force
+  return (*_globalDisplacementVector)(i);
+}
+  
+/**
+   Set the solver backend.  With LinearSolver::AUTO (the default)
+   the backend is chosen by solve() from the analysis of the model.
+*/
+template <typename Real>
+void BasicFEM<Real>::setSolver(LinearSolverBase::Type type)
+{
+  _solverType = type;
+}
+
+/**
+   Fix a node of each part of the assemblage without prescribed
+   displacement (see checkConnectivity()) instead of rejecting the
+   model.
+*/
+template <typename Real>
+void BasicFEM<Real>::setStabilize(bool stabilize)
+{
+  _stabilize = stabilize;
+}
+
+/**
+   Solve a model shrunk by merging parallel and series springs
+   (see solveReduced()).
+*/
+template <typename Real>
+void BasicFEM<Real>::setReduce(bool reduce)
+{
+  _reduce = reduce;
+}
+
+/**
+   Factorize the stiffness matrix in single precision and recover
+   full accuracy by iterative refinement (band and sparse
+   solver only, see RefinementSolver).
+*/
+template <typename Real>
+void BasicFEM<Real>::setMixedPrecision(bool mixedPrecision)
+{
+  _mixedPrecision = mixedPrecision;
+}
+
+/**
+   The parts of the assemblage without any prescribed displacement.
+
+   The nodes are merged along the springs (springs with spring 
+   constant 0 do not connect anything) with a union-find structure
+   in O(n α(n)).  Returns the node IDs of each connected component
+   which does not contain a node with a given displacement; the
+   stiffness matrix of such a part is singular.
+*/
+template <typename Real>
+std::vector<std::vector<int> > BasicFEM<Real>::floatingComponents()
+{
+  std::size_t n = _nodes.size();
+
+  UnionFind components(n);
+  for (std::size_t s = 0; s < _springConstants.size(); ++s)
+    if (_springConstants[s] != 0)
+      components.unite(_springNodeIndex1[s], _springNodeIndex2[s]);
+
+  // Components with a prescribed displacement
+  std::vector<bool> anchored(n, false);
+  for (std::size_t i = 0; i < n; ++i)
+    if (_nodes[i]->getDisplacement().isDefined())
+      anchored[components.find(i)] = true;
+
+  // The nodes of the other components, 
+  // ordered by their first node
+  std::vector<std::vector<int> > floating;
+  std::vector<std::size_t> componentIndex(n, n);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t root = components.find(i);
+      if (anchored[root]) continue;
+
+      if (componentIndex[root] == n)
+	{
+	  componentIndex[root] = floating.size();
+	  floating.push_back(std::vector<int>());
+	}
+      floating[componentIndex[root]].push_back(_nodes[i]->getID());
+    }
+
+  return floating;
+}
+
+/**
+   Check that each part of the assemblage has a prescribed displacement.
+
+   Otherwise the model is singular, which would only be noticed deep
+   inside the factorization.  The parts without prescribed 
+   displacement are reported and the program exits - or, when 
+   stabilizing, the first node of each part is fixed (displacement 0).
+*/
+template <typename Real>
+void BasicFEM<Real>::checkConnectivity()
+{
+  ScopedTimer timer("connectivity");
+
+  std::vector<std::vector<int> > floating = floatingComponents();
+  if (floating.empty()) return;
+
+  // At most this many node IDs are printed per part
+  const std::size_t maxIDs = 20;
+
+  std::ostream &os = _stabilize ? std::clog : std::cerr;
+  os << (_stabilize ? "WARNING " : "ERROR ")
+     << floating.size() << " part(s) of the assemblage have no prescribed displacement:" 
+     << std::endl << std::endl;
+  for (const auto &component : floating)
+    {
+      os << "  - nodes";
+      for (std::size_t i = 0; i < component.size() && i < maxIDs; ++i)
+	os << " " << component[i];
+      if (component.size() > maxIDs)
+	os << " ... (" << component.size() << " nodes)";
+      os << std::endl;
+    }
+  os << std::endl;
+
+  if (!_stabilize)
+    {
+      os << "The stiffness matrix is singular.  Add a displacement to each of these parts" << std::endl
+	 << "or use --stabilize to fix the first node of each part." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  for (const auto &component : floating)
+    {
+      getNodeByID(component[0])->addDisplacement(0);
+      os << "Fixing node " << component[0] << " (displacement 0)." << std::endl;
+    }
+  os << std::endl;
+}
+
+/**
+   Analyse the structure of the model (see ModelAnalysis.h).
+*/
+template <typename Real>
+ModelAnalysis BasicFEM<Real>::analyse()
+{
+  std::vector<bool> constrained(_nodes.size());
+  for (std::size_t i = 0; i < _nodes.size(); ++i)
+    constrained[i] = _nodes[i]->getDisplacement().isDefined();
+
+  return ModelAnalysis(_nodes.size(), _springNodeIndex1, _springNodeIndex2, constrained, 
+		       std::vector<double>(_springConstants.begin(), _springConstants.end()));
+}
+
+/**
+   Solve the finite element model.
+*/
+template <typename Real>
+void BasicFEM<Real>::solve()
+{
+  // The results of a previous solve() are out of date:
+  // the model may have changed since
+  delete _constraints;
+  _constraints = nullptr;
+  delete _globalStiffnessMatrix;
+  _globalStiffnessMatrix = nullptr;
+  delete _globalDisplacementVector;
+  _globalDisplacementVector = nullptr;
+  delete _globalForceVector;
+  _globalForceVector = nullptr;
+  delete _lowRank;
+  _lowRank = nullptr;
+
+  if (_reduce)
+    {
+      solveReduced();
+      return;
+    }
+
+  ScopedTimer timer("solve");
+
+  // Reject (or stabilize) singular models before doing any work
+  checkConnectivity();
+
+  // =====================================
+  // Assemble the FEM model
+  // -------------------------------------
+  
+  // Assemble the prescribed displacements
+  // and keep them for the calculation of the reaction forces
+  _constraints = new BasicConstraints<Real>(assembleConstraints());
+
+  // Assemble the global force vector
+  // reduced to the unconstrained nodes
+  BasicVector<Real> forceVector = _constraints->gather(assembleGlobalForceVector());
+
+  // Assemble the global stiffness matrix
+  // and keep it for the calculation of the reaction forces
+  _globalStiffnessMatrix = new BasicSymmetricSMatrix<Real>(assembleGlobalStiffnessMatrix());
+
+  // =====================================
+  // Apply boundary conditions
+  // -------------------------------------
+
+  // Apply the boundary conditions:
+  // the partitioned stiffness matrix of the unconstrained nodes
+  BasicSymmetricSMatrix<Real> stiffnessMatrix = applyBoundaryConditions(forceVector);
+
+  // Calculate the unconstrained global displacements 
+  // by solving the partitioned stiffness matrix and force vector
+  BasicVector<Real> unconstrainedDisplacements = solveReducedSystem(stiffnessMatrix, forceVector);
+  
+  // Add the calculated global displacements to the prescribed displacements
+  _globalDisplacementVector = new BasicVector<Real>(_constraints->scatter(unconstrainedDisplacements));
+
+  // The global forces are calculated lazily 
+  // by getGlobalForceVector() / getGlobalForce()
+}
+
+/**
+   Solve the model after a series/parallel reduction.
+
+   Parallel springs (springs between the same pair of nodes) are
+   merged into one spring by summing their spring constants.  Runs of
+   springs in series through unloaded, unconstrained nodes connected
+   to exactly two other nodes are collapsed into one equivalent spring
+
+     1 / k = 1 / k1 + 1 / k2 + ... 
+
+   The reduced model is solved by solve() and the displacements of
+   the eliminated nodes are reconstructed in linear time: the force
+   F = k (u_b - u_a) is the same in every spring of a run, so that 
+   the displacement of an inner node is u_a + F times the sum of 
+   1 / k of the springs between a and the node.  The reaction forces
+   are taken from the reduced model.
+*/
+template <typename Real>
+void BasicFEM<Real>::solveReduced()
+{
+  // Reject (or stabilize) singular models before reducing them
+  checkConnectivity();
+
+  std::size_t n = _nodes.size();
+
+  // The springs of the reduced model: a, b and the spring constant
+  struct Edge {
+    std::size_t a, b;
+    Real k;
+  };
+
+  // An eliminated node: its run and the compliance 
+  // (sum of 1 / k) of the springs between it and the start of the run
+  struct Inner {
+    std::size_t node;
+    std::size_t run;
+    Real compliance;
+  };
+
+  std::vector<Edge> runs;
+  std::vector<Inner> inner;
+  std::vector<bool> eliminated(n, false);
+  std::size_t keptNodes = n;
+
+  BasicFEM<Real> reduced;
+  reduced.setSolver(_solverType);
+  reduced.setMixedPrecision(_mixedPrecision);
+
+  {
+    ScopedTimer timer("reduction");
+
+    // =====================================
+    // Merge parallel springs
+    // -------------------------------------
+
+    std::vector<Edge> edges;
+    edges.reserve(_springConstants.size());
+    for (std::size_t s = 0; s < _springConstants.size(); ++s)
+      {
+	std::size_t a = _springNodeIndex1[s];
+	std::size_t b = _springNodeIndex2[s];
+	if (a == b || _springConstants[s] == 0) continue;
+	edges.push_back({ std::min(a, b), std::max(a, b), _springConstants[s] });
+      }
+    std::sort(edges.begin(), edges.end(), [] (const Edge &e1, const Edge &e2) {
+	return e1.a < e2.a || (e1.a == e2.a && e1.b < e2.b);
+      });
+    std::size_t m = 0;
+    for (std::size_t e = 0; e < edges.size(); ++e)
+      if (m > 0 && edges[m - 1].a == edges[e].a && edges[m - 1].b == edges[e].b)
+	edges[m - 1].k += edges[e].k;
+      else
+	edges[m++] = edges[e];
+    edges.resize(m);
+
+    // The springs at each node
+    std::vector<std::size_t> edgeStart(n + 1, 0), incident(2 * m);
+    for (const Edge &e : edges)
+      {
+	++edgeStart[e.a + 1];
+	++edgeStart[e.b + 1];
+      }
+    for (std::size_t i = 0; i < n; ++i)
+      edgeStart[i + 1] += edgeStart[i];
+    std::vector<std::size_t> next(edgeStart.begin(), edgeStart.end() - 1);
+    for (std::size_t e = 0; e < m; ++e)
+      {
+	incident[next[edges[e].a]++] = e;
+	incident[next[edges[e].b]++] = e;
+      }
+
+    // =====================================
+    // Collapse springs in series
+    // -------------------------------------
+
+    for (std::size_t i = 0; i < n; ++i)
+      eliminated[i] = 
+	edgeStart[i + 1] - edgeStart[i] == 2 &&
+	!_nodes[i]->getDisplacement().isDefined() && 
+	_nodes[i]->getForce() == 0;
+
+    // Follow every run from a kept node through the eliminated nodes
+    // to the next kept node
+    std::vector<bool> visited(m, false);
+    for (std::size_t a = 0; a < n; ++a)
+      {
+	if (eliminated[a]) continue;
+	for (std::size_t p = edgeStart[a]; p < edgeStart[a + 1]; ++p)
+	  {
+	    std::size_t e = incident[p];
+	    if (visited[e]) continue;
+
+	    std::size_t node = a;
+	    Real compliance = 0;
+	    for (;;)
+	      {
+		visited[e] = true;
+		compliance += 1 / edges[e].k;
+		node = edges[e].a == node ? edges[e].b : edges[e].a;
+		if (!eliminated[node]) break;
+
+		inner.push_back({ node, runs.size(), compliance });
+		e = incident[edgeStart[node]] == e ? incident[edgeStart[node] + 1] : incident[edgeStart[node]];
+	      }
+	    runs.push_back({ a, node, 1 / compliance });
+	  }
+      }
+
+    // =====================================
+    // Build the reduced model
+    // -------------------------------------
+
+    for (std::size_t i = 0; i < n; ++i)
+      {
+	if (eliminated[i]) 
+	  {
+	    --keptNodes;
+	    continue;
+	  }
+
+	int id = _nodes[i]->getID();
+	reduced.addNode(id);
+	if (_nodes[i]->getDisplacement().isDefined())
+	  reduced.addDisplacement(id, _nodes[i]->getDisplacement().getValue());
+	if (_nodes[i]->getForce() != 0)
+	  reduced.addForce(id, _nodes[i]->getForce());
+      }
+
+    // A run returning to its start carries no force
+    int springID = 0;
+    for (const Edge &run : runs)
+      if (run.a != run.b)
+	reduced.addSpring(++springID, _nodes[run.a]->getID(), _nodes[run.b]->getID(), run.k);
+
+    std::clog << "Reduction: " << n << " nodes, " << _springs.size() << " springs -> " 
+	      << keptNodes << " nodes, " << springID << " springs" << std::endl;
+  }
+
+  reduced.solve();
+
+  ScopedTimer timer("reconstruction");
+
+  // The displacements of the kept nodes
+  BasicVector<Real> *displacements = new BasicVector<Real>(n);
+  for (std::size_t i = 0; i < n; ++i)
+    if (!eliminated[i])
+      (*displacements)(i) = reduced.getGlobalDisplacement(_nodes[i]->getID());
+
+  // The displacements of the eliminated nodes
+  for (const Inner &node : inner)
+    {
+      const Edge &run = runs[node.run];
+      Real ua = (*displacements)(run.a);
+      Real force = run.k * ((*displacements)(run.b) - ua);
+      (*displacements)(node.node) = ua + force * node.compliance;
+    }
+  Profiler::countFlops(4 * inner.size());
+  _globalDisplacementVector = displacements;
+
+  // The forces: the given forces and the reaction forces of the reduced model
+  BasicVector<Real> *forces = new BasicVector<Real>(assembleGlobalForceVector());
+  for (std::size_t i = 0; i < n; ++i)
+    if (_nodes[i]->getDisplacement().isDefined())
+      (*forces)(i) = reduced.getGlobalForce(_nodes[i]->getID());
+  _globalForceVector = forces;
+}
+
+/**
+   Solve the partitioned system of the unconstrained nodes.
+
+   Constrained nodes cut the model: when the graph of the partitioned
+   stiffness matrix falls apart into several independent parts, every
+   part is factored and solved on its own - concurrently on the
+   thread pool, the largest parts first - and the solutions are
+   scattered back into the vector of the unconstrained displacements.
+   Unless a solver has been selected explicitly, the backend is chosen
+   for every part separately.
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::solveReducedSystem(const BasicSymmetricSMatrix<Real> &stiffnessMatrix, const BasicVector<Real> &forceVector)
+{
+  std::vector<std::vector<std::size_t> > parts = independentParts(stiffnessMatrix.upper());
+
+  // All displacements are given: nothing to solve
+  if (parts.empty()) return BasicVector<Real>(0);
+
+  // =====================================
+  // A single part: solve the whole system
+  // -------------------------------------
+
+  if (parts.size() <= 1)
+    {
+      LinearSolverBase::Type solverType = _solverType;
+      std::string reason = "selected";
+      if (solverType == LinearSolverBase::AUTO)
+	{
+	  ModelAnalysis analysis = analyse();
+	  solverType = analysis.recommendSolver(reason);
+	  reason = "auto: " + reason;
+	}
+      std::clog << "Solver: " << LinearSolverBase::typeName(solverType) << " (" << reason << ")" << std::endl;
+
+      if (_mixedPrecision && BasicRefinementSolver<Real>::refines(solverType))
+	{
+	  BasicRefinementSolver<Real> solver(solverType);
+	  solver.factorSymmetric(stiffnessMatrix);
+	  BasicVector<Real> displacements = solver.solve(forceVector);
+
+	  std::clog << "Refinement: " << solver.iterations() << " iterations, backward error " << solver.backwardError();
+	  if (solver.fellBack()) std::clog << " (factorized in full precision: single precision did not converge)";
+	  std::clog << std::endl;
+
+	  return displacements;
+	}
+
+      BasicLinearSolver<Real> *solver = BasicLinearSolver<Real>::create(solverType);
+      solver->factorSymmetric(stiffnessMatrix);
+
+      // Timed here, not in the solvers: their solve() also runs
+      // concurrently and in every iteration of a preconditioner
+      ScopedTimer timer(LinearSolverBase::isDirect(solverType) ? "substitution" : "iterative solution");
+      BasicVector<Real> displacements = solver->solve(forceVector);
+
+      // Keep the factorization for updateSpringConstant()
+      _lowRank = new BasicLowRankSolver<Real>(solver, displacements);
+
+      return displacements;
+    }
+
+  // =====================================
+  // Several parts: solve them independently
+  // -------------------------------------
+
+  ScopedTimer timer("independent parts");
+
+  // Start with the largest parts to balance the load
+  std::stable_sort(parts.begin(), parts.end(), 
+		   [] (const std::vector<std::size_t> &a, const std::vector<std::size_t> &b) { 
+		     return a.size() > b.size(); 
+		   });
+
+  // The index of every row in its part
+  std::vector<std::size_t> localIndex(stiffnessMatrix.rows());
+  for (const std::vector<std::size_t> &part : parts)
+    for (std::size_t i = 0; i < part.size(); ++i)
+      localIndex[part[i]] = i;
+
+  BasicVector<Real> displacements(stiffnessMatrix.rows());
+  std::vector<LinearSolverBase::Type> solverTypes(parts.size());
+
+  // The refinement of the parts solved in mixed precision
+  std::vector<char> refined(parts.size(), 0), fellBack(parts.size(), 0);
+  std::vector<std::size_t> iterations(parts.size(), 0);
+  std::vector<double> backwardErrors(parts.size(), 0.0);
+
+  auto solvePart = [&] (std::size_t p) {
+    const std::vector<std::size_t> &part = parts[p];
+
+    // The stiffness matrix and force vector of the part
+    // (the local indices keep the order: the matrix stays upper triangular)
+    const BasicSMatrix<Real> &upper = stiffnessMatrix.upper();
+    std::vector<BasicTriplet<Real>> entries;
+    BasicVector<Real> forces(part.size());
+    for (std::size_t i = 0; i < part.size(); ++i)
+      {
+	std::size_t row = part[i];
+	for (std::size_t k = upper.rowStart()[row]; k < upper.rowStart()[row + 1]; ++k)
+	  entries.push_back({ i, localIndex[upper.colIndex()[k]], upper.values()[k] });
+	forces(i) = forceVector(row);
+      }
+    BasicSymmetricSMatrix<Real> matrix(part.size(), entries);
+
+    LinearSolverBase::Type solverType = _solverType;
+    if (solverType == LinearSolverBase::AUTO)
+      {
+	std::string reason;
+	solverType = ModelAnalysis(matrix.upper()).recommendSolver(reason);
+      }
+    solverTypes[p] = solverType;
+
+    BasicLinearSolver<Real> *solver;
+    if (_mixedPrecision && BasicRefinementSolver<Real>::refines(solverType))
+      solver = new BasicRefinementSolver<Real>(solverType);
+    else
+      solver = BasicLinearSolver<Real>::create(solverType);
+    solver->factorSymmetric(matrix);
+    BasicVector<Real> x = solver->solve(forces);
+    if (_mixedPrecision && BasicRefinementSolver<Real>::refines(solverType))
+      {
+	const BasicRefinementSolver<Real> *refinement = static_cast<const BasicRefinementSolver<Real> *>(solver);
+	refined[p] = 1;
+	fellBack[p] = refinement->fellBack();
+	iterations[p] = refinement->iterations();
+	backwardErrors[p] = refinement->backwardError();
+      }
+    delete solver;
+
+    // The parts are disjoint: no synchronisation needed
+    for (std::size_t i = 0; i < part.size(); ++i)
+      displacements(part[i]) = x(i);
+  };
+
+  // Every chunk of the pool picks the next unsolved part
+  std::atomic<std::size_t> next(0);
+  ThreadPool::instance().parallelFor(parts.size(), 1, [&] (std::size_t, std::size_t) {
+      for (std::size_t p = next++; p < parts.size(); p = next++)
+	solvePart(p);
+    });
+
+  std::map<LinearSolverBase::Type, std::size_t> used;
+  for (LinearSolverBase::Type type : solverTypes)
+    ++used[type];
+  std::clog << "Solver: " << parts.size() << " independent parts:";
+  for (std::map<LinearSolverBase::Type, std::size_t>::const_iterator it = used.begin(); it != used.end(); ++it)
+    std::clog << (it == used.begin() ? " " : ", ") << LinearSolverBase::typeName(it->first) << " (" << it->second << ")";
+  std::clog << (_solverType == LinearSolverBase::AUTO ? " (auto)" : " (selected)") << std::endl;
+
+  if (std::count(refined.begin(), refined.end(), 1) > 0)
+    {
+      std::clog << "Refinement: " << std::count(refined.begin(), refined.end(), 1) << " parts, up to "
+		<< *std::max_element(iterations.begin(), iterations.end()) << " iterations, backward error up to "
+		<< *std::max_element(backwardErrors.begin(), backwardErrors.end());
+      if (std::count(fellBack.begin(), fellBack.end(), 1) > 0)
+	std::clog << " (" << std::count(fellBack.begin(), fellBack.end(), 1) << " factorized in full precision)";
+      std::clog << std::endl;
+    }
+
+  return displacements;
+}
+
+/**
+   Change the spring constant of a spring of a solved model and
+   update the displacements (and, lazily, the forces).
+
+   The change of the spring constant by d adds d v v^T, v = e_a -
+   e_b, to the stiffness matrix (a, b: the nodes of the spring).
+   Instead of factorizing the reduced stiffness matrix again, the
+   factorization kept by solve() is reused: the changed system is
+   solved with the Sherman-Morrison-Woodbury formula (see
+   LowRankSolver.h), one solve with the factorization for each
+   spring changed for the first time and O(r n) for r changed
+   springs.  After maxUpdateRank changed springs the matrix is
+   factorized again, including all changes.
+
+   When solve() did not keep a factorization by a direct solver
+   (independent parts, mixed precision, a reduced model or an
+   iterative solver), the first update factorizes the reduced
+   stiffness matrix with a direct solver in the working precision.
+
+   A change which makes the model unstable is an error (see
+   tryUpdateSpringConstant()).
+*/
+template <typename Real>
+void BasicFEM<Real>::updateSpringConstant(const int springID, const Real springConstant)
+{
+  if (!tryUpdateSpringConstant(springID, springConstant))
+    {
+      std::cerr << "ERROR Changing the spring constant of spring " << springID << " to " << springConstant
+		<< " makes the model unstable: ";
+      if (springConstant < 0)
+	std::cerr << "spring constants have to be positive or 0!" << std::endl;
+      else
+	std::cerr << "a part of the assemblage is held by this spring alone!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+/**
+   Change the spring constant of a spring of a solved model like
+   updateSpringConstant(), unless the change makes the model unstable.
+   Then the model is left unchanged and false is returned.
+
+   With non-negative spring constants the stiffness matrix stays
+   positive definite unless a spring which alone holds a part of the
+   assemblage - a bridge of the spring graph with the constrained
+   nodes merged, see unstableRemovals() - is set to 0.  Checking this
+   on the graph is exact: a spring softened by any factor is accepted.
+*/
+template <typename Real>
+bool BasicFEM<Real>::tryUpdateSpringConstant(const int springID, const Real springConstant)
+{
+  if (!_globalDisplacementVector)
+    {
+      std::cerr << "ERROR The model has to be solved before updating spring " << springID << "!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  BasicSpring<Real> *spring = getSpringByID(springID);
+  if (!spring)
+    {
+      std::cerr << "ERROR A spring with id " << springID << " does not exist!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  ScopedTimer timer("update");
+
+  assembleForUpdates();
+
+  std::size_t s = spring->getIndex();
+  std::size_t a = _springNodeIndex1[s];
+  std::size_t b = _springNodeIndex2[s];
+  Real delta = springConstant - _springConstants[s];
+
+  // Check the change before changing anything
+  if (springConstant < 0) return false;
+  if (springConstant == 0 && delta != 0 && unstableRemovals()[s]) return false;
+
+  if (!_lowRank || !LinearSolverBase::isDirect(_lowRank->solver().type()))
+    factorizeForUpdates(true);
+
+  spring->setSpringConstant(springConstant);
+  _springConstants[s] = springConstant;
+
+  // A spring from a node to itself does not change the matrix
+  if (a == b || delta == 0) return true;
+
+  _globalStiffnessMatrix->element(a, a) += delta;
+  _globalStiffnessMatrix->element(b, b) += delta;
+  _globalStiffnessMatrix->element(a, b) -= delta;
+
+  // The reaction forces are calculated again on demand
+  delete _globalForceVector;
+  _globalForceVector = nullptr;
+
+  // Both ends constrained: the reduced system does not change
+  const BasicConstraints<Real> &constraints = *_constraints;
+  if (constraints.isConstrained(a) && constraints.isConstrained(b)) return true;
+
+  if (_lowRank->rank() >= maxUpdateRank && !_lowRank->contains(s))
+    factorizeForUpdates(true);
+  else
+    _lowRank->update(s, constraints.freeIndex()[a], constraints.freeIndex()[b], delta,
+		     constraints.value(a) - constraints.value(b));
+
+  BasicVector<Real> displacements = constraints.scatter(_lowRank->solve());
+  delete _globalDisplacementVector;
+  _globalDisplacementVector = new BasicVector<Real>(displacements);
+
+  return true;
+}
+
+/**
+   The springs whose removal makes the model unstable: the bridges of
+   the spring graph with all constrained nodes merged into one node,
+   found in linear time.  A part of the assemblage is held by such a
+   spring alone.  Springs without stiffness are no edges of the graph.
+*/
+template <typename Real>
+std::vector<bool> BasicFEM<Real>::unstableRemovals()
+{
+  assembleForUpdates();
+
+  const BasicConstraints<Real> &constraints = *_constraints;
+  std::size_t springs = _springs.size();
+  std::size_t free = constraints.numberOfFree();
+  const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
+
+  // The springs between free nodes and the ground (vertex `free')
+  std::vector<std::size_t> vertex1, vertex2, edgeSpring;
+  for (std::size_t s = 0; s < springs; ++s)
+    {
+      std::size_t a = std::min(freeIndex[_springNodeIndex1[s]], free);
+      std::size_t b = std::min(freeIndex[_springNodeIndex2[s]], free);
+      if (a == b || _springConstants[s] == 0) continue;
+
+      vertex1.push_back(a);
+      vertex2.push_back(b);
+      edgeSpring.push_back(s);
+    }
+
+  std::vector<bool> bridge = bridges(free + 1, vertex1, vertex2);
+  std::vector<bool> unstable(springs, false);
+  for (std::size_t e = 0; e < bridge.size(); ++e)
+    if (bridge[e]) unstable[edgeSpring[e]] = true;
+
+  return unstable;
+}
+
+/**
+   N-1 contingency analysis: the response of the solved model to the
+   removal of each single spring, reduced to the worst case at every
+   node and spring (see BasicContingencyResults).
+
+   All cases share one factorization of the reduced stiffness matrix
+   (the one kept by solve() when it has been computed by a direct
+   solver): removing the spring between a and b is the rank-1 change
+   -k v v^T, v = e_a - e_b, and with z = K^-1 v the Sherman-Morrison
+   formula gives the displacements
+
+     y = u - z d c,   x = y - z d v^T y / (1 + d v^T z),   d = -k
+
+   (c: prescribed displacement difference, see LowRankSolver.h) in
+   one solve with the factorization.  The cases are distributed over
+   the thread pool.
+
+   A removal makes the model unstable when the spring is a bridge
+   of the spring graph with all constrained nodes merged into one
+   node: a part of the assemblage is then held by that spring alone.
+   These removals are found in linear time before solving (1 + d v^T
+   z is 0 for them).
+*/
+template <typename Real>
+void BasicFEM<Real>::contingencyAnalysis(BasicContingencyResults<Real> &results)
+{
+  if (!_globalDisplacementVector)
+    {
+      std::cerr << "ERROR The model has to be solved before the contingency analysis!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  ScopedTimer timer("contingency");
+
+  assembleForUpdates();
+
+  const BasicConstraints<Real> &constraints = *_constraints;
+  std::size_t nodes = _nodes.size();
+  std::size_t springs = _springs.size();
+  std::size_t free = constraints.numberOfFree();
+  const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
+
+  // =====================================
+  // Unstable removals
+  // -------------------------------------
+
+  std::vector<bool> unstable = unstableRemovals();
+
+  results.resize(nodes, springs);
+  for (std::size_t s = 0; s < springs; ++s)
+    if (unstable[s]) results.unstable.push_back(s);
+
+  // =====================================
+  // The cases
+  // -------------------------------------
+
+  // The iterative solvers keep statistics in solve(): solve concurrently
+  // with a direct solver only
+  if (!_lowRank || _lowRank->rank() > 0 || !LinearSolverBase::isDirect(_lowRank->solver().type()))
+    factorizeForUpdates(true);
+  const BasicLinearSolver<Real> &solver = _lowRank->solver();
+  const Real *base = _lowRank->solution().span().data();
+
+  BasicVector<Real> givenForces = assembleGlobalForceVector();
+  const Real *given = givenForces.span().data();
+
+  // The largest absolute value at each node or spring and its case;
+  // on a tie the earlier case wins (the base case first), so that
+  // the result does not depend on the order of the threads
+  struct Worst {
+    std::size_t cases;
+    std::vector<Real> value;
+    std::vector<std::size_t> which;
+
+    Worst(std::size_t n, std::size_t cases) : cases(cases), value(n, 0.0), which(n, cases + 1) {}
+
+    std::size_t rank(std::size_t c) const { return c == cases ? 0 : c + 1; }
+
+    void update(std::size_t i, Real v, std::size_t c)
+    {
+      if (std::fabs(v) > std::fabs(value[i]) ||
+	  (std::fabs(v) == std::fabs(value[i]) && rank(c) < rank(which[i])))
+	{
+	  value[i] = v;
+	  which[i] = c;
+	}
+    }
+
+    void merge(const Worst &other)
+    {
+      for (std::size_t i = 0; i < value.size(); ++i)
+	update(i, other.value[i], other.which[i]);
+    }
+  };
+
+  Worst displacement(nodes, springs), force(nodes, springs), springForce(springs, springs);
+  std::mutex mutex;
+
+  // Case `springs' is the base case; every chunk of the pool picks the next case
+  std::atomic<std::size_t> next(0);
+  ThreadPool::instance().parallelFor(ThreadPool::instance().size(), 1, [&] (std::size_t, std::size_t) {
+      Worst localDisplacement(nodes, springs), localForce(nodes, springs), localSpringForce(springs, springs);
+      std::vector<Real> x(free), u(nodes), reaction(nodes);
+      std::uint64_t flops = 0;
+
+      for (std::size_t s = next++; s <= springs; s = next++)
+	{
+	  std::copy(base, base + free, x.begin());
+	  if (s < springs)
+	    {
+	      std::size_t a = _springNodeIndex1[s];
+	      std::size_t b = _springNodeIndex2[s];
+
+	      // The same as the base case, or no solution
+	      if (a == b || _springConstants[s] == 0 || unstable[s]) continue;
+
+	      std::size_t p = freeIndex[a], q = freeIndex[b];
+	      if (p < free || q < free)
+		{
+		  BasicVector<Real> v(free);
+		  if (p < free) v(p) = 1;
+		  if (q < free) v(q) = -1;
+		  BasicVector<Real> z = solver.solve(v);
+		  const Real *zz = z.span().data();
+
+		  // v^T w
+		  auto dot = [p, q, free] (const Real *w) -> Real {
+		    return (p < free ? w[p] : 0) - (q < free ? w[q] : 0);
+		  };
+
+		  Real d = -_springConstants[s];
+		  Real shift = d * (constraints.value(a) - constraints.value(b));
+		  for (std::size_t i = 0; i < free; ++i)
+		    x[i] -= zz[i] * shift;
+		  Real alpha = d * dot(x.data()) / (1 + d * dot(zz));
+		  for (std::size_t i = 0; i < free; ++i)
+		    x[i] -= zz[i] * alpha;
+		  flops += 4 * free + 6;
+		}
+	    }
+
+	  for (std::size_t i = 0; i < nodes; ++i)
+	    {
+	      u[i] = constraints.isConstrained(i) ? constraints.value(i) : x[freeIndex[i]];
+	      reaction[i] = 0;
+	      localDisplacement.update(i, u[i], s);
+	    }
+
+	  // The spring forces and the reaction forces
+	  // (the removed spring carries no force)
+	  for (std::size_t t = 0; t < springs; ++t)
+	    {
+	      if (t == s) continue;
+
+	      std::size_t a = _springNodeIndex1[t];
+	      std::size_t b = _springNodeIndex2[t];
+	      Real k = _springConstants[t];
+	      Real f = k * u[b] - k * u[a];
+	      localSpringForce.update(t, f, s);
+	      reaction[a] -= f;
+	      reaction[b] += f;
+	    }
+	  flops += 5 * springs;
+
+	  for (std::size_t i = 0; i < nodes; ++i)
+	    localForce.update(i, constraints.isConstrained(i) ? reaction[i] : given[i], s);
+	}
+      Profiler::countFlops(flops);
+
+      std::lock_guard<std::mutex> lock(mutex);
+      displacement.merge(localDisplacement);
+      force.merge(localForce);
+      springForce.merge(localSpringForce);
+    });
+
+  for (std::size_t i = 0; i < nodes; ++i)
+    {
+      results.displacement(i) = displacement.value[i];
+      results.displacementCase[i] = displacement.which[i];
+      results.force(i) = force.value[i];
+      results.forceCase[i] = force.which[i];
+    }
+  for (std::size_t t = 0; t < springs; ++t)
+    {
+      results.springForce(t) = springForce.value[t];
+      results.springForceCase[t] = springForce.which[t];
+    }
+}
+
+/**
+   Monte Carlo analysis: the statistics of the displacements when the
+   spring constants are random, lognormally distributed with the
+   spring constants of the model as mean and the coefficient of
+   variation `variation' (standard deviation / mean), independently
+   for each spring (see Random::lognormal()).
+
+   Sample n draws its spring constants from stream n of the counter
+   based generator seeded with `seed': the results do not depend on
+   the number of threads.  The samples are solved in batches, in
+   parallel; the solutions of a batch are then added to the one-pass
+   estimators of the mean, the variance and the quantiles of every
+   node in the order of the samples (see Statistics.h).  The memory
+   needed does not depend on the number of samples.
+
+   All samples have the pattern of the nominal stiffness matrix: the
+   reduced matrix of a sample is assembled directly into the values
+   of the nominal one, and the ordering and symbolic factorization
+   of the sparse solver are computed once.  With a direct solver
+   selected every thread repeats only the numeric factorization for
+   each sample (SparseSolver::refactorSymmetric(), with a copy of the
+   factor per thread).  With an iterative solver selected, or when a
+   numeric factorization fails, the sample is solved by conjugate
+   gradients preconditioned with the factorization of the nominal
+   matrix, which for moderate variations converge in a few
+   iterations.
+*/
+template <typename Real>
+void BasicFEM<Real>::monteCarlo(BasicMonteCarloResults<Real> &results, std::size_t samples,
+				double variation, std::uint64_t seed)
+{
+  if (samples == 0 || !(variation >= 0))
+    {
+      std::cerr << "ERROR Invalid Monte Carlo analysis: " << samples << " samples, "
+		<< "coefficient of variation " << variation << "!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  for (double p : results.probabilities)
+    if (!(p > 0 && p < 1))
+      {
+	std::cerr << "ERROR Invalid quantile probability: " << p << "!" << std::endl;
+	exit(EXIT_FAILURE);
+      }
+
+  if (!_globalDisplacementVector)
+    {
+      std::cerr << "ERROR The model has to be solved before the Monte Carlo analysis!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  ScopedTimer timer("monte carlo");
+
+  assembleForUpdates();
+
+  const BasicConstraints<Real> &constraints = *_constraints;
+  std::size_t nodes = _nodes.size();
+  std::size_t springs = _springs.size();
+  std::size_t free = constraints.numberOfFree();
+  const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
+
+  // =====================================
+  // The pattern of the samples
+  // -------------------------------------
+
+  BasicVector<Real> forceVector = constraints.gather(assembleGlobalForceVector());
+  BasicVector<Real> givenForces(forceVector);
+  BasicSymmetricSMatrix<Real> nominal = applyBoundaryConditions(forceVector);
+  ReducedSystem<Real> reduced(_springNodeIndex1, _springNodeIndex2, constraints, nominal);
+  const Real *prescribed = constraints.values().data();
 
-FEM::FEM(const std::vector<std::string> &files)
-{
-  // Parse the definition files
-  // and create the finite element model
-  Parser parser(this, files);
-  parser.parse();
+  // The ordering and symbolic factorization (and the preconditioner)
+  LinearSolverBase::Type solverType = _solverType;
+  if (solverType == LinearSolverBase::AUTO)
+    {
+      std::string reason;
+      solverType = analyse().recommendSolver(reason);
+    }
+  bool refactor = LinearSolverBase::isDirect(solverType);
+
+  BasicSparseSolver<Real> factorization;
+  factorization.factorSymmetric(nominal);
+
+  // =====================================
+  // The samples
+  // -------------------------------------
+
+  std::vector<RunningStatistics> moments(free);
+  std::vector<P2Quantile> quantiles;
+  std::size_t levels = results.probabilities.size();
+  quantiles.reserve(free * levels);
+  for (std::size_t i = 0; i < free; ++i)
+    for (double p : results.probabilities)
+      quantiles.push_back(P2Quantile(p));
+
+  // The solutions of a batch of samples, one after the other
+  std::size_t threads = ThreadPool::instance().size();
+  std::size_t batch = std::min(samples, 4 * threads);
+  std::vector<Real> solutions(batch * free);
+
+  // The solver of each thread, created by the thread
+  std::vector<std::unique_ptr<PatternSolver<Real> > > solvers(threads);
+
+  std::atomic<std::size_t> fallbacks(0);
+  for (std::size_t first = 0; first < samples; first += batch)
+    {
+      std::size_t count = std::min(batch, samples - first);
+
+      std::atomic<std::size_t> next(0);
+      ThreadPool::instance().parallelFor(threads, 1, [&] (std::size_t begin, std::size_t) {
+	  if (!solvers[begin]) solvers[begin].reset(new PatternSolver<Real>(factorization, nominal, refactor));
+	  PatternSolver<Real> &solver = *solvers[begin];
+
+	  std::vector<Real> k(springs);
+	  for (std::size_t c = next++; c < count; c = next++)
+	    {
+	      // The stiffness matrix and force vector of the sample
+	      Random random(seed, first + c);
+	      for (std::size_t s = 0; s < springs; ++s)
+		k[s] = Real(random.lognormal(double(_springConstants[s]), variation));
+
+	      BasicVector<Real> f(givenForces);
+	      reduced.assembleMatrix(k.data(), solver.matrix.values());
+	      reduced.assembleForces(k.data(), prescribed, f);
+
+	      bool fellBack;
+	      BasicVector<Real> x = solver.solve(f, fellBack);
+	      if (fellBack) ++fallbacks;
+
+	      const Real *xx = x.span().data();
+	      std::copy(xx, xx + free, solutions.begin() + c * free);
+	    }
+	});
+
+      // Add the solutions to the estimators, in the order of the samples
+      ThreadPool::instance().parallelFor(free, 1024, [&] (std::size_t begin, std::size_t end) {
+	  for (std::size_t i = begin; i < end; ++i)
+	    for (std::size_t c = 0; c < count; ++c)
+	      {
+		double u = double(solutions[c * free + i]);
+		moments[i].add(u);
+		for (std::size_t j = 0; j < levels; ++j)
+		  quantiles[i * levels + j].add(u);
+	      }
+	});
+    }
+
+  // =====================================
+  // The results
+  // -------------------------------------
+
+  results.resize(nodes);
+  results.samples = samples;
+  results.fallbacks = refactor ? fallbacks.load() : samples;
+  for (std::size_t i = 0; i < nodes; ++i)
+    {
+      if (constraints.isConstrained(i))
+	{
+	  results.mean(i) = constraints.value(i);
+	  results.deviation(i) = 0;
+	  for (std::size_t j = 0; j < levels; ++j)
+	    results.quantiles[j](i) = constraints.value(i);
+	  continue;
+	}
+
+      std::size_t k = freeIndex[i];
+      results.mean(i) = Real(moments[k].mean());
+      results.deviation(i) = Real(moments[k].deviation());
+      for (std::size_t j = 0; j < levels; ++j)
+	results.quantiles[j](i) = Real(quantiles[k * levels + j].quantile());
+    }
 }
 
-FEM::~FEM()
+/**
+   Parameter sweep: solve the model at every point of the sweep (see
+   Sweep.h) and write a table with one row per point to `os': the
+   number of the point, the values of the parameters and the results
+   (the displacement and force of each output node and the force of
+   each output spring; all nodes when no outputs are given).  The
+   columns are separated by tabs; the first line names them: the
+   parameters `param.k:<spring>', `param.f:<node>' and `param.d:<node>',
+   the results `u:<node>', `f:<node>' and `s:<spring>'.
+
+   A point changes the values of the reduced system, never its
+   pattern: swept forces and prescribed displacements change the
+   force vector, swept spring constants the values of the matrix.
+   The ordering and symbolic factorization of the sparse solver are
+   computed once.  Without swept spring constants all points are
+   solved with this one factorization, by a forward and back
+   substitution each; otherwise the numeric factorization is repeated
+   for each point (see monteCarlo(), also for the iterative solvers).
+
+   The points are solved in parallel batches, and the rows of a batch
+   are written in the order of the points as soon as the batch is
+   done: memory does not grow with the number of points.
+*/
+template <typename Real>
+void BasicFEM<Real>::sweep(const BasicSweep<Real> &sweep, std::ostream &os)
 {
-  // Delete all springs
-  for (auto spring : _springs)
-    delete spring;
-  _springs.clear();
-  
-  // Delete all nodes
-  for (auto node : _nodes)
-    delete node;
-  _nodes.clear();
+  if (!_globalDisplacementVector)
+    {
+      std::cerr << "ERROR The model has to be solved before the parameter sweep!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
 
-  // Clear the indices
-  _springIndexToIDMap.clear();
-  _springIDToIndexMap.clear();
-  _nodeIndexToIDMap.clear();
-  _nodeIDToIndexMap.clear();
-  
-  // Delete force vector, stiffness matrix
-  if (_globalForceVector) delete _globalForceVector;
-  if (_globalStiffnessMatrix) delete _globalStiffnessMatrix;
-  if (_globalDisplacementVector) delete _globalDisplacementVector;
+  ScopedTimer timer("sweep");
+
+  assembleForUpdates();
+
+  typedef BasicSweep<Real> Spec;
+  const BasicConstraints<Real> &constraints = *_constraints;
+  std::size_t nodes = _nodes.size();
+  std::size_t springs = _springs.size();
+  const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
+
+  // =====================================
+  // The parameters and columns
+  // -------------------------------------
+
+  // The internal index of the spring or node of every parameter
+  const std::vector<typename Spec::Parameter> &parameters = sweep.parameters();
+  std::vector<std::size_t> index(parameters.size());
+  bool springsChange = false;
+  for (std::size_t j = 0; j < parameters.size(); ++j)
+    {
+      const typename Spec::Parameter &parameter = parameters[j];
+      if (parameter.kind == Spec::SPRING_CONSTANT)
+	{
+	  BasicSpring<Real> *spring = getSpringByID(parameter.id);
+	  if (!spring)
+	    {
+	      std::cerr << "ERROR A spring with id " << parameter.id << " does not exist!" << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  index[j] = spring->getIndex();
+	  springsChange = true;
+	  continue;
+	}
+
+      // Only values change: the free and the constrained nodes stay the same
+      index[j] = getNodeByID(parameter.id)->getIndex();
+      bool constrained = constraints.isConstrained(index[j]);
+      if (parameter.kind == Spec::FORCE && constrained)
+	{
+	  std::cerr << "ERROR Node " << parameter.id << " has a prescribed displacement:"
+		    << " its force cannot be swept!" << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+      if (parameter.kind == Spec::DISPLACEMENT && !constrained)
+	{
+	  std::cerr << "ERROR Node " << parameter.id << " has no prescribed displacement to sweep!" << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+    }
+
+  // The result columns: the displacement and force of a node, the force of a spring
+  enum Result { DISPLACEMENT, FORCE, SPRING_FORCE };
+  struct Column {
+    Result result;
+    std::size_t index;
+    int id;
+  };
+  std::vector<Column> columns;
+  for (const typename Spec::Output &output : sweep.outputs())
+    if (output.kind == Spec::SPRING)
+      {
+	BasicSpring<Real> *spring = getSpringByID(output.id);
+	if (!spring)
+	  {
+	    std::cerr << "ERROR A spring with id " << output.id << " does not exist!" << std::endl;
+	    exit(EXIT_FAILURE);
+	  }
+	columns.push_back({ SPRING_FORCE, std::size_t(spring->getIndex()), output.id });
+      }
+    else
+      {
+	std::size_t i = getNodeByID(output.id)->getIndex();
+	columns.push_back({ DISPLACEMENT, i, output.id });
+	columns.push_back({ FORCE, i, output.id });
+      }
+  if (sweep.outputs().empty())
+    for (const auto& node : getNodes())
+      {
+	columns.push_back({ DISPLACEMENT, std::size_t(node->getIndex()), node->getID() });
+	columns.push_back({ FORCE, std::size_t(node->getIndex()), node->getID() });
+      }
+
+  bool forces = false;
+  for (const Column &column : columns)
+    forces |= column.result != DISPLACEMENT;
+
+  os << "point";
+  for (const typename Spec::Parameter &parameter : parameters)
+    os << "\tparam." << (parameter.kind == Spec::SPRING_CONSTANT ? "k" : parameter.kind == Spec::FORCE ? "f" : "d")
+       << ":" << parameter.id;
+  for (const Column &column : columns)
+    os << "\t" << (column.result == DISPLACEMENT ? "u" : column.result == FORCE ? "f" : "s") << ":" << column.id;
+  os << std::endl;
+
+  // =====================================
+  // The pattern of the points
+  // -------------------------------------
+
+  BasicVector<Real> givenForces = assembleGlobalForceVector();
+  BasicVector<Real> forceVector = constraints.gather(givenForces);
+  BasicSymmetricSMatrix<Real> nominal = applyBoundaryConditions(forceVector);
+  ReducedSystem<Real> reduced(_springNodeIndex1, _springNodeIndex2, constraints, nominal);
+
+  LinearSolverBase::Type solverType = _solverType;
+  if (solverType == LinearSolverBase::AUTO)
+    {
+      std::string reason;
+      solverType = analyse().recommendSolver(reason);
+    }
+  bool refactor = LinearSolverBase::isDirect(solverType);
+
+  BasicSparseSolver<Real> factorization;
+  factorization.factorSymmetric(nominal);
+
+  // =====================================
+  // The points
+  // -------------------------------------
+
+  std::size_t points = sweep.points();
+  std::size_t threads = ThreadPool::instance().size();
+  std::size_t batch = std::min(points, 16 * threads);
+  std::vector<Real> rows(batch * columns.size());
+
+  // The solver of each thread, created by the thread
+  std::vector<std::unique_ptr<PatternSolver<Real> > > solvers(threads);
+
+  for (std::size_t first = 0; first < points; first += batch)
+    {
+      std::size_t count = std::min(batch, points - first);
+
+      std::atomic<std::size_t> next(0);
+      ThreadPool::instance().parallelFor(threads, 1, [&] (std::size_t begin, std::size_t) {
+	  if (springsChange && !solvers[begin])
+	    solvers[begin].reset(new PatternSolver<Real>(factorization, nominal, refactor));
+
+	  std::vector<Real> k(_springConstants);
+	  std::vector<Real> prescribed(constraints.values());
+	  BasicVector<Real> given(givenForces);
+	  std::vector<Real> u(nodes), force(nodes);
+
+	  for (std::size_t c = next++; c < count; c = next++)
+	    {
+	      // The values of the point
+	      for (std::size_t j = 0; j < parameters.size(); ++j)
+		{
+		  Real value = sweep.value(j, first + c);
+		  switch (parameters[j].kind)
+		    {
+		    case Spec::SPRING_CONSTANT: k[index[j]] = value;          break;
+		    case Spec::FORCE:           given(index[j]) = value;      break;
+		    default:                     prescribed[index[j]] = value; break;
+		    }
+		}
+
+	      BasicVector<Real> f = constraints.gather(given);
+	      reduced.assembleForces(k.data(), prescribed.data(), f);
+
+	      bool fellBack;
+	      if (springsChange) reduced.assembleMatrix(k.data(), solvers[begin]->matrix.values());
+	      BasicVector<Real> x = springsChange ? solvers[begin]->solve(f, fellBack) : factorization.solve(f);
+
+	      for (std::size_t i = 0; i < nodes; ++i)
+		{
+		  u[i] = constraints.isConstrained(i) ? prescribed[i] : x(freeIndex[i]);
+		  force[i] = constraints.isConstrained(i) ? Real(0) : given(i);
+		}
+
+	      // The reaction forces at the constrained nodes
+	      if (forces)
+		{
+		  for (std::size_t s = 0; s < springs; ++s)
+		    {
+		      std::size_t a = _springNodeIndex1[s];
+		      std::size_t b = _springNodeIndex2[s];
+		      Real fs = k[s] * u[b] - k[s] * u[a];
+		      if (constraints.isConstrained(a)) force[a] -= fs;
+		      if (constraints.isConstrained(b)) force[b] += fs;
+		    }
+		  Profiler::countFlops(5 * springs);
+		}
+
+	      Real *row = rows.data() + c * columns.size();
+	      for (std::size_t l = 0; l < columns.size(); ++l)
+		{
+		  const Column &column = columns[l];
+		  std::size_t i = column.index;
+		  if (column.result == DISPLACEMENT) row[l] = u[i];
+		  else if (column.result == FORCE) row[l] = force[i];
+		  else row[l] = k[i] * u[_springNodeIndex2[i]] - k[i] * u[_springNodeIndex1[i]];
+		}
+	    }
+	});
+
+      // Stream the rows of the batch in the order of the points
+      ScopedTimer timer("output");
+      for (std::size_t c = 0; c < count; ++c)
+	{
+	  os << first + c;
+	  for (std::size_t j = 0; j < parameters.size(); ++j)
+	    os << "\t" << sweep.value(j, first + c);
+	  const Real *row = rows.data() + c * columns.size();
+	  for (std::size_t l = 0; l < columns.size(); ++l)
+	    os << "\t" << row[l];
+	  os << "\n";
+	}
+      os.flush();
+    }
 }
 
-// =========================================================
-// Methods
-// ---------------------------------------------------------
+/**
+   Sensitivity of J = w^T u (w: a weight per node, u: the
+   displacements) with respect to the spring constants, indexed by
+   the internal spring index.
+
+   Adjoint method: with the reduced system K x = f - K_fc u_c and K
+   lambda = w (free nodes, lambda = 0 at the constrained nodes)
 
-DVector FEM::getGlobalForceVector()
+     dJ/dk_s = -(lambda_a - lambda_b) (u_a - u_b)
+
+   for the spring s between the nodes a and b: one solve for all
+   springs instead of one solve per spring.  The solve reuses the
+   factorization kept by solve() (the matrix is factorized again
+   when spring constants have been updated since).  The weights of
+   constrained nodes do not count: their displacements are given.
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::sensitivity(const BasicVector<Real> &weights)
 {
-  return *_globalForceVector;
+  ScopedTimer timer("sensitivity");
+
+  return adjointGradient(adjointSolve(weights));
 }
 
-double FEM::getGlobalForce(const int nodeID)
+/**
+   Sensitivity of the displacement of a node with respect to the
+   spring constants (0 for a node with a prescribed displacement).
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::displacementSensitivity(const int nodeID)
 {
-  // Get index of node
-  int i = _nodeIDToIndexMap[nodeID];
+  ScopedTimer timer("sensitivity");
 
-  // Return the corresponding force
-  return (*_globalForceVector)(i);
+  BasicVector<Real> weights(_nodes.size());
+  weights(getNodeByID(nodeID)->getIndex()) = 1;
+
+  return adjointGradient(adjointSolve(weights));
 }
 
-DMatrix FEM::getGlobalStiffnessMatrix()
+/**
+   Sensitivity of the reaction force at a node with a prescribed
+   displacement with respect to the spring constants.
+
+   The reaction R_c = sum over the springs at c of k (u_c - u_j)
+   depends on the spring constants directly and through the
+   displacements: the adjoint system has the coupling K_fc e_c of
+   the node to the free nodes as right side, and the direct term
+   adds lambda_c = -1.
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::reactionSensitivity(const int nodeID)
 {
-  return *_globalStiffnessMatrix;
+  int c = getNodeByID(nodeID)->getIndex();
+  if (!_nodes[c]->getDisplacement().isDefined())
+    {
+      std::cerr << "ERROR Node " << nodeID << " has no prescribed displacement and no reaction force!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  ScopedTimer timer("sensitivity");
+
+  // K_fc e_c: -k at the other node of every spring at c
+  BasicVector<Real> weights(_nodes.size());
+  for (std::size_t s = 0; s < _springConstants.size(); ++s)
+    {
+      int a = _springNodeIndex1[s];
+      int b = _springNodeIndex2[s];
+      if (a == b) continue;
+      if (a == c) weights(b) -= _springConstants[s];
+      if (b == c) weights(a) -= _springConstants[s];
+    }
+
+  BasicVector<Real> adjoint = adjointSolve(weights);
+  adjoint(c) = -1;
+
+  return adjointGradient(adjoint);
 }
 
-DVector FEM::getGlobalDisplacementVector()
+/**
+   Sensitivity of the compliance f^T u (the work of the given forces)
+   with respect to the spring constants.
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::complianceSensitivity()
 {
-  return *_globalDisplacementVector;
+  ScopedTimer timer("sensitivity");
+
+  return adjointGradient(adjointSolve(assembleGlobalForceVector()));
 }
 
-double FEM::getGlobalDisplacement(const int nodeID)
+/**
+   Solve the adjoint system K lambda = w for the free nodes with the
+   kept factorization; lambda is 0 at the constrained nodes.
+*/
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::adjointSolve(const BasicVector<Real> &weights)
 {
-  // Get index of node
-  int i = _nodeIDToIndexMap[nodeID];
+  if (!_globalDisplacementVector)
+    {
+      std::cerr << "ERROR The model has to be solved before calculating sensitivities!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
 
-  // Return the corresponding force
-  return (*_globalDisplacementVector)(i);
+  assembleForUpdates();
+  if (!_lowRank || _lowRank->rank() > 0) factorizeForUpdates();
+
+  const BasicConstraints<Real> &constraints = *_constraints;
+  BasicVector<Real> adjoint = _lowRank->solver().solve(constraints.gather(weights));
+
+  // 0 at the constrained nodes
+  BasicVector<Real> full(_nodes.size());
+  const std::vector<std::size_t> &freeDofs = constraints.freeDofs();
+  for (std::size_t k = 0; k < freeDofs.size(); ++k)
+    full(freeDofs[k]) = adjoint(k);
+
+  return full;
 }
-  
+
 /**
-   Solve the finite element model.
+   Assemble the gradient -(lambda_a - lambda_b) (u_a - u_b) of every
+   spring from the adjoint solution lambda (see sensitivity()).
 */
-void FEM::solve()
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::adjointGradient(const BasicVector<Real> &adjoint)
 {
-  // =====================================
-  // Assemble the FEM model
-  // -------------------------------------
-  
-  // Assemble the global force vector
-  DVector globalForceVector = assembleGlobalForceVector();
+  std::size_t n = _springs.size();
+  BasicVector<Real> gradient(n);
 
-  // Assemble the global stiffness matrix
-  DMatrix globalStiffnessMatrix = assembleGlobalStiffnessMatrix();
+  const int  *node1 = _springNodeIndex1.data();
+  const int  *node2 = _springNodeIndex2.data();
+  const Real *u     = _globalDisplacementVector->span().data();
+  const Real *l     = adjoint.span().data();
+  Real       *g     = gradient.span().data();
 
-  // Store a copy of the global stiffness matrix for later use
-  _globalStiffnessMatrix = new DMatrix(globalStiffnessMatrix);
+  Profiler::countFlops(3 * n);
 
-  // Assemble the global displacement vector
-  FVector globalDisplacementVector = assembleGlobalDisplacementVector();
+  // Number of springs per block
+  const std::size_t block = 256;
 
-  // =====================================
-  // Apply boundary conditions
-  // -------------------------------------
+  ThreadPool::instance().parallelFor(n, 16 * 1024, [=] (std::size_t begin, std::size_t end) {
+      Real du[block], dl[block];
+
+      for (std::size_t b = begin; b < end; b += block)
+	{
+	  std::size_t m = std::min(block, end - b);
+
+	  // Gather the differences at the nodes of the springs
+	  for (std::size_t i = 0; i < m; ++i)
+	    {
+	      du[i] = u[node1[b + i]] - u[node2[b + i]];
+	      dl[i] = l[node1[b + i]] - l[node2[b + i]];
+	    }
+
+	  // Contiguous: vectorized
+	  Real *gb = g + b;
+	  for (std::size_t i = 0; i < m; ++i)
+	    gb[i] = -dl[i] * du[i];
+	}
+    });
 
-  // Apply the boundary conditions
-  applyBoundaryConditions(globalForceVector, globalStiffnessMatrix, globalDisplacementVector);
+  return gradient;
+}
 
-  // Calculate the unconstrained global displacements 
-  // by solving the partitioned stiffness matrix and force vector
-  DVector unconstrainedDisplacements = globalStiffnessMatrix.gaussianElimination(globalForceVector);
-  
-  // Add the calculated global displacements to the original displacement vector
-  _globalDisplacementVector = new DVector(globalDisplacementVector.setUndefinedElements(unconstrainedDisplacements));
-  
-  // =====================================
-  // Solve the original displacement matrix 
-  // by applying the calculated global displacements
-  // -------------------------------------
-  _globalForceVector = new DVector(*_globalStiffnessMatrix * *_globalDisplacementVector);
+/**
+   Assemble what updateSpringConstant(), contingencyAnalysis() and
+   the sensitivities need and solve() does not keep when the model
+   has been reduced.
+*/
+template <typename Real>
+void BasicFEM<Real>::assembleForUpdates()
+{
+  if (!_constraints) _constraints = new BasicConstraints<Real>(assembleConstraints());
+  if (!_globalStiffnessMatrix) _globalStiffnessMatrix = new BasicSymmetricSMatrix<Real>(assembleGlobalStiffnessMatrix());
 }
 
 /**
-   Apply boundary conditions
+   Factorize the reduced stiffness matrix of the current spring
+   constants for updateSpringConstant(), contingencyAnalysis() and
+   the sensitivities (`direct': with a direct solver, the sparse
+   solver when an iterative one is selected).
 */
-void FEM::applyBoundaryConditions(DVector &globalForceVector,
-				  DMatrix &globalStiffnessMatrix, 
-				  FVector &globalDisplacementVector)
+template <typename Real>
+void BasicFEM<Real>::factorizeForUpdates(bool direct)
 {
-  // A lambda function
-  // which returns true for elements for which a displacement is defined
-  auto displacementDefined = [&globalDisplacementVector] (std::size_t i) -> bool { 
-    return globalDisplacementVector(i).isDefined(); 
-  };
+  BasicVector<Real> forceVector = _constraints->gather(assembleGlobalForceVector());
+  BasicSymmetricSMatrix<Real> stiffnessMatrix = applyBoundaryConditions(forceVector);
+
+  LinearSolverBase::Type solverType = _solverType;
+  if (solverType == LinearSolverBase::AUTO)
+    {
+      std::string reason;
+      solverType = analyse().recommendSolver(reason);
+    }
+  if (direct && !LinearSolverBase::isDirect(solverType))
+    solverType = LinearSolverBase::SPARSE;
+
+  BasicLinearSolver<Real> *solver = BasicLinearSolver<Real>::create(solverType);
+  solver->factorSymmetric(stiffnessMatrix);
+
+  delete _lowRank;
+  _lowRank = new BasicLowRankSolver<Real>(solver, solver->solve(forceVector));
+}
+
+/**
+   Calculate the global force vector.
+
+   At the unconstrained nodes the forces are the given forces.  Only
+   at the nodes with a prescribed displacement the (reaction) forces
+   are unknown - they are calculated by multiplying the corresponding
+   rows of the sparse global stiffness matrix with the global
+   displacements.  Only the upper triangle is stored: an element
+   (i, j) contributes to row i and, mirrored, to row j.
+*/
+template <typename Real>
+void BasicFEM<Real>::calculateGlobalForceVector()
+{
+  ScopedTimer timer("reaction forces");
+
+  // The force vector at the unconstrained nodes
+  BasicVector<Real> *globalForceVector = new BasicVector<Real>(assembleGlobalForceVector());
+
+  // The reaction forces at the constrained nodes
+  const BasicConstraints<Real> &constraints = *_constraints;
+  const BasicSMatrix<Real> &K = _globalStiffnessMatrix->upper();
+  const BasicVector<Real> &u = *_globalDisplacementVector;
+  for (std::size_t i : constraints.constrainedDofs())
+    (*globalForceVector)(i) = 0;
+  std::size_t products = 0;
+  for (std::size_t i = 0; i < _nodes.size(); ++i)
+    {
+      bool constrained = constraints.isConstrained(i);
+      for (std::size_t k = K.rowStart()[i]; k < K.rowStart()[i + 1]; ++k)
+	{
+	  std::size_t j = K.colIndex()[k];
+	  if (constrained)
+	    {
+	      (*globalForceVector)(i) += K.values()[k] * u(j);
+	      ++products;
+	    }
+	  if (j != i && constraints.isConstrained(j))
+	    {
+	      (*globalForceVector)(j) += K.values()[k] * u(i);
+	      ++products;
+	    }
+	}
+    }
+  Profiler::countFlops(2 * products);
+
+  _globalForceVector = globalForceVector;
+}
+
+/**
+   Apply boundary conditions.
+
+   Returns the stiffness matrix partitioned to the rows and columns
+   of the unconstrained nodes; `forceVector' (the given forces at the
+   unconstrained nodes) is updated with the forces caused by the
+   prescribed displacements.  Both matrices are stored as their upper
+   triangle: the free indices keep the order of the nodes, so that
+   the partitioned matrix stays upper triangular.
+*/
+template <typename Real>
+BasicSymmetricSMatrix<Real> BasicFEM<Real>::applyBoundaryConditions(BasicVector<Real> &forceVector)
+{
+  ScopedTimer timer("boundary conditions");
+
+  const BasicSMatrix<Real> &K = _globalStiffnessMatrix->upper();
+  const BasicConstraints<Real> &constraints = *_constraints;
+
+  // The index of each unconstrained node in the partitioned system
+  const std::vector<std::size_t> &freeIndex = constraints.freeIndex();
   
   // Bring the values in those columns which correspond to a
   // given displacement to the left side by muliplying them
   // with the corresponding displacement and subtracting
-  // their sum from the given force on the left side:
-  for (std::size_t i = 0; i < globalDisplacementVector.size(); ++i)
-    { 
-      // The displacement has to be calculated 
-      // only for the rows for which no displacement has been given already:
-      if (!displacementDefined(i))
+  // their sum from the given force on the left side.
+  // The other values are copied to the partitioned matrix.
+  // A stored element (i, j) stands for (j, i) as well: when
+  // only row j is unconstrained, it is moved to the force of j.
+  std::vector<BasicTriplet<Real>> entries;
+  entries.reserve(K.nnz());
+  std::size_t products = 0;
+  for (std::size_t i = 0; i < constraints.size(); ++i)
+    {
+      bool constrainedI = constraints.isConstrained(i);
+      for (std::size_t k = K.rowStart()[i]; k < K.rowStart()[i + 1]; ++k)
 	{
-	  double &f = globalForceVector(i);
-	  for (std::size_t j = 0; j < globalDisplacementVector.size(); ++j)
-	    if (displacementDefined(j))
-	      f -= globalStiffnessMatrix(i, j) * globalDisplacementVector(j).getValue();
+	  std::size_t j = K.colIndex()[k];
+	  bool constrainedJ = constraints.isConstrained(j);
+	  if (!constrainedI && !constrainedJ)
+	    entries.push_back({ freeIndex[i], freeIndex[j], K.values()[k] });
+	  else if (!constrainedI)
+	    {
+	      forceVector(freeIndex[i]) -= K.values()[k] * constraints.value(j);
+	      ++products;
+	    }
+	  else if (!constrainedJ)
+	    {
+	      forceVector(freeIndex[j]) -= K.values()[k] * constraints.value(i);
+	      ++products;
+	    }
 	}
     }
+  Profiler::countFlops(2 * products);
 
-  // Remove rows and columns for which displacements are defined
-  // i.e. for which displacementDefined(<index of row / column>) is true
-  globalStiffnessMatrix.deleteRowsAndColumns(displacementDefined);
-  
-  // Remove elements for which displacements are defined
-  // i.e. for which displacementDefined(<index of element>) is true
-  globalForceVector.deleteElements(displacementDefined);
+  return BasicSymmetricSMatrix<Real>(constraints.numberOfFree(), entries);
 }
     
 /**
    Add a node.
 */
-void FEM::addNode(const int id)
+template <typename Real>
+void BasicFEM<Real>::addNode(const int id)
 {
   // Check if a node with the same index has been defined already
   if ( _nodeIDToIndexMap.find(id) != _nodeIDToIndexMap.end() )
@@ -200,17 +2084,18 @@ void FEM::addNode(const int id)
   _nodeIndexToIDMap[index] = id;
   
   // Add node
-  Node *node = new Node(index, id);
+  BasicNode<Real> *node = new BasicNode<Real>(index, id);
   _nodes.push_back(node);
 }
 
 /**
    Add a displacement.
 */
-void FEM::addDisplacement(const int nodeID, const double displacement)
+template <typename Real>
+void BasicFEM<Real>::addDisplacement(const int nodeID, const Real displacement)
 {
   // Get node object
-  Node *node = getNodeByID(nodeID);
+  BasicNode<Real> *node = getNodeByID(nodeID);
 
   // Add displacement
   node->addDisplacement(displacement);
@@ -219,10 +2104,11 @@ void FEM::addDisplacement(const int nodeID, const double displacement)
 /**
    Add a force.
 */
-void FEM::addForce(const int nodeID, const double force)
+template <typename Real>
+void BasicFEM<Real>::addForce(const int nodeID, const Real force)
 {
   // Get node object
-  Node *node = getNodeByID(nodeID);
+  BasicNode<Real> *node = getNodeByID(nodeID);
 
   // Add displacement
   node->addForce(force);
@@ -231,7 +2117,8 @@ void FEM::addForce(const int nodeID, const double force)
 /**
    Get the nodes.
 */
-std::vector<Node*>  &FEM::getNodes()
+template <typename Real>
+std::vector<BasicNode<Real>*>  &BasicFEM<Real>::getNodes()
 {
   return _nodes;
 }
@@ -239,7 +2126,8 @@ std::vector<Node*>  &FEM::getNodes()
 /**
    Get the node with the given internal id.
 */
-Node *FEM::getNodeByIndex(const int i)
+template <typename Real>
+BasicNode<Real> *BasicFEM<Real>::getNodeByIndex(const int i)
 {
   if (i >= _nodes.size())
     {
@@ -253,7 +2141,8 @@ Node *FEM::getNodeByIndex(const int i)
 /**
    Get the node with the given external id.
 */
-Node *FEM::getNodeByID(const int id)
+template <typename Real>
+BasicNode<Real> *BasicFEM<Real>::getNodeByID(const int id)
 {
   std::map<int, int>::const_iterator it = _nodeIDToIndexMap.find(id);
   if (it == _nodeIDToIndexMap.end())
@@ -268,7 +2157,8 @@ Node *FEM::getNodeByID(const int id)
 /**
    Get the number of nodes.
 */
-int FEM::getNumberOfNodes()
+template <typename Real>
+int BasicFEM<Real>::getNumberOfNodes()
 {
   return _nodes.size();
 }
@@ -276,9 +2166,10 @@ int FEM::getNumberOfNodes()
 /**
    Add a spring.
 */
-void FEM::addSpring(const int id,
+template <typename Real>
+void BasicFEM<Real>::addSpring(const int id,
 		      const int node1, const int node2, 
-		      const double springConstant)
+		      const Real springConstant)
 {
   // Check if a spring with the same index has been defined already
   if ( _springIDToIndexMap.find(id) != _springIDToIndexMap.end() )
@@ -288,8 +2179,8 @@ void FEM::addSpring(const int id,
     }
   
   // Get nodes
-  Node *nodep1 = getNodeByID(node1);
-  Node *nodep2 = getNodeByID(node2);
+  BasicNode<Real> *nodep1 = getNodeByID(node1);
+  BasicNode<Real> *nodep2 = getNodeByID(node2);
   
   // Exit if nodep1 has not been defined
   if (nodep1 == nullptr) {
@@ -311,14 +2202,20 @@ void FEM::addSpring(const int id,
   _springIndexToIDMap[index] = id;
   
   // Add spring
-  Spring *spring = new Spring(index, id, nodep1, nodep2, springConstant);
+  BasicSpring<Real> *spring = new BasicSpring<Real>(index, id, nodep1, nodep2, springConstant);
   _springs.push_back(spring);
+
+  // Add the spring data to the structure of arrays
+  _springNodeIndex1.push_back(nodep1->getIndex());
+  _springNodeIndex2.push_back(nodep2->getIndex());
+  _springConstants.push_back(springConstant);
 }
 
 /**
    Get the springs.
 */
-std::vector<Spring*> &FEM::getSprings()
+template <typename Real>
+std::vector<BasicSpring<Real>*> &BasicFEM<Real>::getSprings()
 {
   return _springs;
 }
@@ -326,7 +2223,8 @@ std::vector<Spring*> &FEM::getSprings()
 /**
    Get the spring with the given internal id.
 */
-Spring *FEM::getSpringByIndex(const int i)
+template <typename Real>
+BasicSpring<Real> *BasicFEM<Real>::getSpringByIndex(const int i)
 {
   return _springs[i];
 }
@@ -334,7 +2232,8 @@ Spring *FEM::getSpringByIndex(const int i)
 /**
    Get the spring with the given external id.
 */
-Spring *FEM::getSpringByID(const int id)
+template <typename Real>
+BasicSpring<Real> *BasicFEM<Real>::getSpringByID(const int id)
 {
   std::map<int, int>::const_iterator it = _springIDToIndexMap.find(id);
   if (it == _springIDToIndexMap.end())
@@ -346,7 +2245,8 @@ Spring *FEM::getSpringByID(const int id)
 /**
    Get the number of springs.
 */
-int FEM::getNumberOfSprings()
+template <typename Real>
+int BasicFEM<Real>::getNumberOfSprings()
 {
   return _springs.size();
 }
@@ -354,7 +2254,8 @@ int FEM::getNumberOfSprings()
 /**
    Calculate the degrees of freedom.
 */
-int FEM::degreesOfFreedom()
+template <typename Real>
+int BasicFEM<Real>::degreesOfFreedom()
 {
   // Calculate the degrees of freedom (corresponding to the size of
   // the global stiffness matrix) by multiplying the number of nodes
@@ -365,15 +2266,20 @@ int FEM::degreesOfFreedom()
 /**
    Calculate the global stiffness matrix.
 */
-DMatrix FEM::assembleGlobalStiffnessMatrix()
+template <typename Real>
+BasicSymmetricSMatrix<Real> BasicFEM<Real>::assembleGlobalStiffnessMatrix()
 {
+  ScopedTimer timer("assemble");
+
   // The size of the global stiffness matrix
   // is equal to the degrees of freedom
   // (Number of nodes * dimension of space (1 as we are in 1D))
   int dimension = degreesOfFreedom();
   
-  // The global stiffness matrix
-  DMatrix globalStiffnessMatrix(dimension, dimension);
+  // The entries of the upper triangle of the global stiffness matrix
+  // (Entries with the same row and column are summed up)
+  std::vector<BasicTriplet<Real>> entries;
+  entries.reserve(3 * _springs.size());
 
   // Calculating the global stiffness matrix
   // by summing the spring stiffness matrices
@@ -384,7 +2290,7 @@ DMatrix FEM::assembleGlobalStiffnessMatrix()
       int nodeIndex2 = spring->getNode2()->getIndex();
       
       // Get the stiffness matrix of the spring
-      DMatrix springStiffnessMatrix = spring->stiffnessMatrix();
+      BasicMatrix<Real> springStiffnessMatrix = spring->stiffnessMatrix();
       
       // Array of global indices
       int gOffset[2] = {
@@ -409,43 +2315,47 @@ DMatrix FEM::assembleGlobalStiffnessMatrix()
 	    int lColumn = j;
   	      
 	    // Get value of the spring stiffness matrix
-	    double value = springStiffnessMatrix(lRow, lColumn);
+	    Real value = springStiffnessMatrix(lRow, lColumn);
 
-	    // Add value to the global stiffness matrix
-	    globalStiffnessMatrix(gRow, gColumn) += value;
+	    // Add value to the global stiffness matrix:
+	    // the elements below the diagonal are not stored
+	    if (gRow <= gColumn)
+	      entries.push_back({ (std::size_t) gRow, (std::size_t) gColumn, value });
   	  }
     }
 
   // Return the calculated global stiffness matrix
-  return globalStiffnessMatrix;
+  return BasicSymmetricSMatrix<Real>(dimension, entries);
 }
 
 /**
-   Calculate the global displacement vector.
+   Collect the prescribed displacements.
 */
-FVector FEM::assembleGlobalDisplacementVector()
+template <typename Real>
+BasicConstraints<Real> BasicFEM<Real>::assembleConstraints()
 {
-  // The size of the displacement vector
-  // is equal to the degrees of freedom
-  // (Number of nodes * dimension of space (1 as we are in 1D))
-  int dimension = degreesOfFreedom();
-  
-  // The global displacement vector
-  FVector globalDisplacementVector(dimension);
-  
-  // Calculating the displacement vector
-  // from the spring displacements
+  std::vector<std::size_t> dofs;
+  std::vector<Real> values;
   for (std::size_t i = 0; i < _nodes.size(); ++i)
-    globalDisplacementVector(i) = _nodes[i]->getDisplacement();
-  
-  // Return the displacement vector
-  return globalDisplacementVector;
+    {
+      BasicFValue<Real> displacement = _nodes[i]->getDisplacement();
+      if (displacement.isDefined())
+	{
+	  dofs.push_back(i);
+	  values.push_back(displacement.getValue());
+	}
+    }
+
+  // One bit and value per degree of freedom
+  // (Number of nodes * dimension of space (1 as we are in 1D))
+  return BasicConstraints<Real>(degreesOfFreedom(), dofs, values);
 }
 
 /**
    Calculate the force vector.
 */
-DVector FEM::assembleGlobalForceVector()
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::assembleGlobalForceVector()
 {
   // The size of the force vector
   // is equal to the degrees of freedom
@@ -453,7 +2363,7 @@ DVector FEM::assembleGlobalForceVector()
   int dimension = degreesOfFreedom();
   
   // The force vector
-  DVector globalForceVector(dimension);
+  BasicVector<Real> globalForceVector(dimension);
   
   // Calculating the force vector
   // from the spring forces
@@ -467,32 +2377,100 @@ DVector FEM::assembleGlobalForceVector()
 /**
    Get the local forces.
 */
-DVector FEM::getLocalForces(const int springID)
+template <typename Real>
+BasicVector<Real> BasicFEM<Real>::getLocalForces(const int springID)
 {
-  Spring *spring = getSpringByID(springID);
+  BasicSpring<Real> *spring = getSpringByID(springID);
   
   // Get the indices of the nodes of the spring
   int node1 = spring->getNode1()->getIndex();
   int node2 = spring->getNode2()->getIndex();
   
   // Extract the displacements of the nodes of the current spring
-  const DVector &displacements = *_globalDisplacementVector;
-  DVector displacements2({ displacements(node1), displacements(node2) });
+  const BasicVector<Real> &displacements = *_globalDisplacementVector;
+  BasicVector<Real> displacements2({ displacements(node1), displacements(node2) });
   
   // Get the stiffness matrix of the spring
-  DMatrix stiffnessMatrix = spring->stiffnessMatrix();
+  BasicMatrix<Real> stiffnessMatrix = spring->stiffnessMatrix();
   
   // Calculate the forces at the current spring
-  DVector forces = stiffnessMatrix * displacements2;
+  BasicVector<Real> forces = stiffnessMatrix * displacements2;
   
   return forces;
 }
 
+/**
+   Calculate the local forces, elongation and strain energy 
+   of all springs in one pass.
+
+   The results are written into the given (preallocated) columns,
+   which are resized when necessary.  The springs are processed in
+   blocks in parallel; inside a block the displacements of the nodes
+   are gathered first, so that the arithmetic runs over contiguous
+   arrays and can be vectorized by the compiler.
+*/
+template <typename Real>
+void BasicFEM<Real>::calculateElementResults(BasicElementResults<Real> &results)
+{
+  ScopedTimer timer("element results");
+
+  std::size_t n = _springs.size();
+  if (results.localForce1.size() != n) results.resize(n);
+
+  const int    *node1 = _springNodeIndex1.data();
+  const int    *node2 = _springNodeIndex2.data();
+  const Real *k     = _springConstants.data();
+  const Real *u     = _globalDisplacementVector->span().data();
+
+  Profiler::countFlops(9 * n);
+
+  Real *f1 = results.localForce1.span().data();
+  Real *f2 = results.localForce2.span().data();
+  Real *e  = results.elongation.span().data();
+  Real *w  = results.strainEnergy.span().data();
+
+  // Number of springs per block
+  const std::size_t block = 256;
+
+  ThreadPool::instance().parallelFor(n, 16 * 1024, [=] (std::size_t begin, std::size_t end) {
+      Real u1[block], u2[block];
+      
+      for (std::size_t b = begin; b < end; b += block)
+	{
+	  std::size_t m = std::min(block, end - b);
+
+	  // Gather the displacements of the nodes
+	  for (std::size_t i = 0; i < m; ++i)
+	    {
+	      u1[i] = u[node1[b + i]];
+	      u2[i] = u[node2[b + i]];
+	    }
+
+	  // The local forces are calculated the same way as by
+	  // multiplying the spring stiffness matrix with the
+	  // displacements (see getLocalForces())
+	  const Real *kb = k + b;
+	  Real *f1b = f1 + b, *f2b = f2 + b, *eb = e + b, *wb = w + b;
+	  for (std::size_t i = 0; i < m; ++i)
+	    {
+	      Real d = u2[i] - u1[i];
+	      f1b[i] = kb[i] * u1[i] - kb[i] * u2[i];
+	      f2b[i] = kb[i] * u2[i] - kb[i] * u1[i];
+	      eb[i]  = d;
+	      wb[i]  = 0.5 * kb[i] * d * d;
+	    }
+	}
+    });
+}
+
 /**
    Print the results.
 */
-void FEM::printResults()
+template <typename Real>
+void BasicFEM<Real>::printResults()
 {
+  ScopedTimer timer("output");
+
   printGlobalDisplacements();
   printGlobalForces();
   printLocalForcesAtEachElement();
@@ -501,7 +2479,8 @@ void FEM::printResults()
 /**
    Print the node displacements.
 */
-void FEM::printGlobalDisplacements()
+template <typename Real>
+void BasicFEM<Real>::printGlobalDisplacements()
 {
   std::cout << "Global displacements:" << std::endl << std::endl;
   for (const auto& node : getNodes())
@@ -510,7 +2489,7 @@ void FEM::printGlobalDisplacements()
       int id = node->getID();
 
       // Get the node displacement
-      double displacement = getGlobalDisplacement(id);
+      Real displacement = getGlobalDisplacement(id);
 
       std::cout << "  - node " << id << ": " << displacement << std::endl;
     }
@@ -520,7 +2499,8 @@ void FEM::printGlobalDisplacements()
 /**
    Print the node forces.
 */
-void FEM::printGlobalForces()
+template <typename Real>
+void BasicFEM<Real>::printGlobalForces()
 {
   std::cout << "Global forces:" << std::endl << std::endl;
   for (const auto& node : getNodes())
@@ -529,7 +2509,7 @@ void FEM::printGlobalForces()
       int id = node->getID();
 
       // Get the force at the given node 
-      double force = getGlobalForce(id);
+      Real force = getGlobalForce(id);
 
       std::cout << "  - node " << id << ": " << force << std::endl;
     }
@@ -539,18 +2519,113 @@ void FEM::printGlobalForces()
 /**
    Calculate and print the local forces at each element.
 */
-void FEM::printLocalForcesAtEachElement()
+template <typename Real>
+void BasicFEM<Real>::printLocalForcesAtEachElement()
 {
+  // Calculate the local forces of all springs at once
+  BasicElementResults<Real> results(_springs.size());
+  calculateElementResults(results);
+
   std::cout << "Local forces at each element:" << std::endl << std::endl;
   for (const auto& spring : getSprings())
     {
-      // Get the id of the spring
+      // Get the id and index of the spring
       int id = spring->getID();
+      int i  = spring->getIndex();
+
+      std::cout << "  - element " << id << ": (" 
+		<< results.localForce1(i) << ", " 
+		<< results.localForce2(i) << ")" << std::endl;
+    }
+  std::cout << std::endl;
+}
+
+/**
+   Run the contingency analysis and print the worst cases.
+*/
+template <typename Real>
+void BasicFEM<Real>::printContingencyAnalysis()
+{
+  BasicContingencyResults<Real> results;
+  contingencyAnalysis(results);
+
+  ScopedTimer timer("output");
+
+  // The removed spring of a case
+  std::size_t springs = _springs.size();
+  auto removed = [this, springs] (std::size_t c) -> std::string {
+    if (c == springs) return "no spring removed";
+    return "spring " + std::to_string(_springs[c]->getID()) + " removed";
+  };
+
+  std::cout << "Contingency analysis (each spring removed in turn):" << std::endl << std::endl;
+  if (results.unstable.empty())
+    std::cout << "  - no removal makes the assemblage unstable" << std::endl;
+  else
+    {
+      std::cout << "  - " << results.unstable.size() << " removal(s) make the assemblage unstable: springs";
+      for (std::size_t s : results.unstable)
+	std::cout << " " << _springs[s]->getID();
+      std::cout << std::endl;
+    }
+  std::cout << std::endl;
+
+  std::cout << "Worst-case displacements:" << std::endl << std::endl;
+  for (const auto& node : getNodes())
+    {
+      int i = node->getIndex();
+      std::cout << "  - node " << node->getID() << ": " << results.displacement(i)
+		<< " (" << removed(results.displacementCase[i]) << ")" << std::endl;
+    }
+  std::cout << std::endl;
+
+  std::cout << "Worst-case forces:" << std::endl << std::endl;
+  for (const auto& node : getNodes())
+    {
+      int i = node->getIndex();
+      std::cout << "  - node " << node->getID() << ": " << results.force(i)
+		<< " (" << removed(results.forceCase[i]) << ")" << std::endl;
+    }
+  std::cout << std::endl;
+
+  std::cout << "Worst-case forces in each element:" << std::endl << std::endl;
+  for (const auto& spring : getSprings())
+    {
+      int i = spring->getIndex();
+      std::cout << "  - element " << spring->getID() << ": " << results.springForce(i)
+		<< " (" << removed(results.springForceCase[i]) << ")" << std::endl;
+    }
+  std::cout << std::endl;
+}
+
+/**
+   Print the statistics of the displacements of the Monte Carlo
+   analysis (see monteCarlo()).
+*/
+template <typename Real>
+void BasicFEM<Real>::printMonteCarlo(std::size_t samples, double variation, std::uint64_t seed)
+{
+  BasicMonteCarloResults<Real> results;
+  monteCarlo(results, samples, variation, seed);
+
+  ScopedTimer timer("output");
 
-      // Get local forces at the spring
-      DVector forces = getLocalForces(id);
+  std::cout << "Monte Carlo analysis (" << results.samples << " samples, lognormal spring constants"
+	    << " with a coefficient of variation of " << variation << ", seed " << seed << "):" << std::endl
+	    << std::endl;
+  if (results.fallbacks > 0)
+    std::cout << "  - " << results.fallbacks << " sample(s) solved by preconditioned conjugate gradients"
+	      << std::endl << std::endl;
 
-      std::cout << "  - element " << id << ": (" << forces(0) << ", " << forces(1) << ")" << std::endl;
+  std::cout << "Displacement statistics (mean, standard deviation, quantiles):" << std::endl << std::endl;
+  for (const auto& node : getNodes())
+    {
+      int i = node->getIndex();
+      std::cout << "  - node " << node->getID() << ": mean " << results.mean(i)
+		<< ", deviation " << results.deviation(i);
+      for (std::size_t j = 0; j < results.probabilities.size(); ++j)
+	std::cout << ", " << 100 * results.probabilities[j] << "%: " << results.quantiles[j](i);
+      std::cout << std::endl;
     }
   std::cout << std::endl;
 }
@@ -559,7 +2634,8 @@ void FEM::printLocalForcesAtEachElement()
 // Friends
 // ---------------------------------------------------------
 
-std::ostream& operator<<(std::ostream& os, const FEM& fgfem)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFEM<Real>& fgfem)
 {
   // Print nodes
   os << "// Nodes" << std::endl;
@@ -576,6 +2652,20 @@ std::ostream& operator<<(std::ostream& os, const FEM& fgfem)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicElementResults)
+NSL_INSTANTIATE(BasicContingencyResults)
+NSL_INSTANTIATE(BasicMonteCarloResults)
+NSL_INSTANTIATE(BasicFEM)
+
+#define INSTANTIATE(Real)						\
+  template std::ostream& operator<<(std::ostream& os, const BasicFEM<Real>& fgfem);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
@@ -4,7 +4,7 @@
    
    FEM.h
    
-   Class: FEM
+   Class: BasicFEM, FEM
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -15,6 +15,7 @@
 #ifndef __FEM__
 #define __FEM__
 
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -22,8 +23,15 @@
 
 #include "DVector.h"
 #include "DMatrix.h"
+#include "SMatrix.h"
+#include "SymmetricSMatrix.h"
 #include "FDouble.h"
 #include "FVector.h"
+#include "Constraints.h"
+#include "LinearSolver.h"
+#include "LowRankSolver.h"
+#include "ModelAnalysis.h"
+#include "Sweep.h"
 
 namespace nsl {
 
@@ -31,81 +39,233 @@ namespace nsl {
 // Forward definitions
 // ---------------------------------------------------------
 
-class Node;
-class Spring;
+template <typename Real> class BasicNode;
+template <typename Real> class BasicSpring;
+template <typename Real> class BasicFEM;
+
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFEM<Real>& fgfem);
+
+// =========================================================
+// struct BasicElementResults
+// ---------------------------------------------------------
+
+/**
+   Results at each element (spring), indexed by the internal spring
+   index (the order in which the springs have been defined).
+
+   Allocate once and pass to FEM::calculateElementResults() as often
+   as needed.
+*/
+template <typename Real>
+struct BasicElementResults {
+  BasicVector<Real> localForce1;   // Local force at the first node
+  BasicVector<Real> localForce2;   // Local force at the second node
+  BasicVector<Real> elongation;    // Displacement of node 2 - displacement of node 1
+  BasicVector<Real> strainEnergy;  // k * elongation^2 / 2
+
+  BasicElementResults(std::size_t springs = 0);
+  void resize(std::size_t springs);
+};
+
+typedef BasicElementResults<double> ElementResults;
 
 // =========================================================
-// class FEM
+// struct BasicContingencyResults
 // ---------------------------------------------------------
 
-class FEM {
+/**
+   The worst cases of the N-1 contingency analysis (see
+   FEM::contingencyAnalysis()): for each node and spring the value
+   with the largest absolute value over the base case and the
+   removal of each single spring, and the case it occurs in: the
+   index of the removed spring, or the number of springs for the base
+   case.  Nodes are indexed by the internal node index, springs by
+   the internal spring index.
+
+   Removals which leave a part of the assemblage without prescribed
+   displacement have no solution: they are listed in `unstable' and
+   left out of the worst cases.
+*/
+template <typename Real>
+struct BasicContingencyResults {
+  BasicVector<Real> displacement;              // Displacement of each node
+  std::vector<std::size_t> displacementCase;
+  BasicVector<Real> force;                     // Force at each node (reaction forces at the constrained nodes)
+  std::vector<std::size_t> forceCase;
+  BasicVector<Real> springForce;               // Force in each spring: k * (u2 - u1)
+  std::vector<std::size_t> springForceCase;
+  std::vector<std::size_t> unstable;           // The springs whose removal makes the model unstable
+
+  BasicContingencyResults(std::size_t nodes = 0, std::size_t springs = 0);
+  void resize(std::size_t nodes, std::size_t springs);
+};
+
+typedef BasicContingencyResults<double> ContingencyResults;
+
+// =========================================================
+// struct BasicMonteCarloResults
+// ---------------------------------------------------------
+
+/**
+   The statistics of the displacements of the Monte Carlo analysis
+   (see FEM::monteCarlo()), indexed by the internal node index.
+   The quantiles are estimated for the given probabilities (0 < p <
+   1): quantiles[j](i) is the probabilities[j] quantile at node i.
+*/
+template <typename Real>
+struct BasicMonteCarloResults {
+  std::vector<double> probabilities;          // The probabilities of the quantiles
+  std::size_t samples;
+  std::size_t fallbacks;                      // Samples solved by conjugate gradients
+  BasicVector<Real> mean;                     // Mean displacement of each node
+  BasicVector<Real> deviation;                // Standard deviation of the displacement
+  std::vector<BasicVector<Real> > quantiles;
+
+  BasicMonteCarloResults(std::size_t nodes = 0,
+			 const std::vector<double> &probabilities = { 0.05, 0.5, 0.95 });
+  void resize(std::size_t nodes);
+};
+
+typedef BasicMonteCarloResults<double> MonteCarloResults;
+
+// =========================================================
+// class BasicFEM
+// ---------------------------------------------------------
+
+/**
+   The finite element model with all calculations done in the
+   floating point type Real (see Precision.h).
+*/
+template <typename Real>
+class BasicFEM {
   
 private:
   int _dimension = 1; // Working in 1D
 
-  std::vector<Node*>   _nodes;
-  std::vector<Spring*> _springs;
+  std::vector<BasicNode<Real>*>   _nodes;
+  std::vector<BasicSpring<Real>*> _springs;
 
   std::map<int, int> _nodeIndexToIDMap;
   std::map<int, int> _nodeIDToIndexMap;
   std::map<int, int> _springIndexToIDMap;
   std::map<int, int> _springIDToIndexMap;
 
-  DVector *_globalForceVector        = nullptr;
-  DMatrix *_globalStiffnessMatrix    = nullptr;
-  DVector *_globalDisplacementVector = nullptr;
+  // The spring data as structure of arrays (indexed by spring index)
+  // for the bulk calculations
+  std::vector<int>    _springNodeIndex1;
+  std::vector<int>    _springNodeIndex2;
+  std::vector<Real>   _springConstants;
+
+  BasicSymmetricSMatrix<Real> *_globalStiffnessMatrix = nullptr;
+  BasicConstraints<Real>      *_constraints = nullptr;
+  BasicVector<Real>  *_globalDisplacementVector = nullptr;
+
+  // Calculated lazily by getGlobalForceVector() / getGlobalForce()
+  BasicVector<Real>  *_globalForceVector        = nullptr;
+
+  // The solver backend (AUTO: chosen by analyse())
+  LinearSolverBase::Type _solverType = LinearSolverBase::AUTO;
+
+  // Fix a node of each part without prescribed displacement
+  // instead of rejecting the model
+  bool _stabilize = false;
+
+  // Merge parallel and series springs before solving
+  bool _reduce = false;
+
+  // Factorize in single precision and refine the solution
+  bool _mixedPrecision = false;
+
+  // The factorization kept for updateSpringConstant()
+  // and the springs changed since
+  BasicLowRankSolver<Real> *_lowRank = nullptr;
+
+  // Number of changed springs after which the matrix is factorized again
+  static const std::size_t maxUpdateRank = 32;
   
 public:
-  FEM();
-  FEM(const std::vector<std::string> &files);
-  ~FEM();
+  BasicFEM();
+  BasicFEM(const std::vector<std::string> &files);
+  ~BasicFEM();
   
 public:
   void addNode(const int id);
-  void addDisplacement(const int nodeID, const double displacement);
-  void addForce(const int nodeID, const double force);
+  void addDisplacement(const int nodeID, const Real displacement);
+  void addForce(const int nodeID, const Real force);
   void addSpring(const int id,
 		 const int node1, const int node2, 
-		 const double springConstant);
-
-  DMatrix getGlobalStiffnessMatrix();
-  DVector getGlobalDisplacementVector();
-  double getGlobalDisplacement(const int nodeID);
-  DVector getGlobalForceVector();
-  double getGlobalForce(const int nodeID);
-  DVector getLocalForces(const int springID);
+		 const Real springConstant);
+
+  BasicMatrix<Real> getGlobalStiffnessMatrix();
+  BasicVector<Real> getGlobalDisplacementVector();
+  Real getGlobalDisplacement(const int nodeID);
+  BasicVector<Real> getGlobalForceVector();
+  Real getGlobalForce(const int nodeID);
+  BasicVector<Real> getLocalForces(const int springID);
+  void calculateElementResults(BasicElementResults<Real> &results);
+
+  void setSolver(LinearSolverBase::Type type);
+  void setStabilize(bool stabilize);
+  void setReduce(bool reduce);
+  void setMixedPrecision(bool mixedPrecision);
+  ModelAnalysis analyse();
+  std::vector<std::vector<int> > floatingComponents();
   
   void solve();
+  void updateSpringConstant(const int springID, const Real springConstant);
+  bool tryUpdateSpringConstant(const int springID, const Real springConstant);
+  void contingencyAnalysis(BasicContingencyResults<Real> &results);
+  void printContingencyAnalysis();
+  void monteCarlo(BasicMonteCarloResults<Real> &results, std::size_t samples,
+		  double variation, std::uint64_t seed = 1);
+  void printMonteCarlo(std::size_t samples, double variation, std::uint64_t seed = 1);
+  void sweep(const BasicSweep<Real> &sweep, std::ostream &os);
+
+  BasicVector<Real> sensitivity(const BasicVector<Real> &weights);
+  BasicVector<Real> displacementSensitivity(const int nodeID);
+  BasicVector<Real> reactionSensitivity(const int nodeID);
+  BasicVector<Real> complianceSensitivity();
   void printResults();
   
 private:
-  void applyBoundaryConditions(DVector &globalForceVector,
-			       DMatrix &globalStiffnessMatrix, 
-			       FVector &globalDisplacementVector);
+  void checkConnectivity();
+  void solveReduced();
+  void assembleForUpdates();
+  std::vector<bool> unstableRemovals();
+  BasicVector<Real> adjointSolve(const BasicVector<Real> &weights);
+  BasicVector<Real> adjointGradient(const BasicVector<Real> &adjoint);
+  void factorizeForUpdates(bool direct = false);
+  BasicVector<Real> solveReducedSystem(const BasicSymmetricSMatrix<Real> &stiffnessMatrix, const BasicVector<Real> &forceVector);
+  BasicSymmetricSMatrix<Real> applyBoundaryConditions(BasicVector<Real> &forceVector);
 
-  std::vector<Node*> &getNodes();
-  Node *getNodeByIndex(const int i);
-  Node *getNodeByID(const int id);
+  std::vector<BasicNode<Real>*> &getNodes();
+  BasicNode<Real> *getNodeByIndex(const int i);
+  BasicNode<Real> *getNodeByID(const int id);
   int getNumberOfNodes();
 
-  std::vector<Spring*> &getSprings();
-  Spring *getSpringByIndex(const int i);
-  Spring *getSpringByID(const int id);
+  std::vector<BasicSpring<Real>*> &getSprings();
+  BasicSpring<Real> *getSpringByIndex(const int i);
+  BasicSpring<Real> *getSpringByID(const int id);
   int getNumberOfSprings();
 
   int degreesOfFreedom();
 
-  DMatrix assembleGlobalStiffnessMatrix();
-  FVector assembleGlobalDisplacementVector();
-  DVector assembleGlobalForceVector();
+  BasicSymmetricSMatrix<Real> assembleGlobalStiffnessMatrix();
+  BasicConstraints<Real> assembleConstraints();
+  BasicVector<Real> assembleGlobalForceVector();
+
+  void calculateGlobalForceVector();
 
   void printGlobalDisplacements();
   void printGlobalForces();
   void printLocalForcesAtEachElement();
   
-  friend std::ostream& operator<<(std::ostream& os, const FEM& fgfem);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicFEM& fgfem);
 };
 
+typedef BasicFEM<double> FEM;
+
 } // namespace nsl
 
 #endif /* defined(__FEM__) */
@@ -4,7 +4,7 @@
    
    FVector.cpp
 
-   Class: FVector
+   Class: BasicFVector
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -22,29 +22,32 @@
 namespace nsl {
 
 // =========================================================
-// Class FVector
+// Class BasicFVector
 // ---------------------------------------------------------
 
 /** 
     Constructor.
 */
-FVector::FVector(std::size_t size)
+template <typename Real>
+BasicFVector<Real>::BasicFVector(std::size_t size)
 {
-  _v = new std::vector<FDouble> (size);
+  _v = new std::vector<BasicFValue<Real> > (size);
 }
 
 /** 
     Copy constructor.
 */
-FVector::FVector(const FVector &v)
+template <typename Real>
+BasicFVector<Real>::BasicFVector(const BasicFVector &v)
 {
-  _v = new std::vector<FDouble> (*v._v);
+  _v = new std::vector<BasicFValue<Real> > (*v._v);
 }
 
 /** 
     Destructor.
 */
-FVector::~FVector()
+template <typename Real>
+BasicFVector<Real>::~BasicFVector()
 {
   delete _v;
 }
@@ -56,7 +59,8 @@ FVector::~FVector()
 /**
    Get size.
  */
-std::size_t FVector::size() const
+template <typename Real>
+std::size_t BasicFVector<Real>::size() const
 {
   return _v->size();
 }
@@ -64,7 +68,8 @@ std::size_t FVector::size() const
 /**
    Get size.
  */
-std::size_t FVector::numberOfDefinedElements() const
+template <typename Real>
+std::size_t BasicFVector<Real>::numberOfDefinedElements() const
 {
   std::size_t n = 0;
   for (std::size_t i = 0; i < _v->size(); ++i)
@@ -76,7 +81,8 @@ std::size_t FVector::numberOfDefinedElements() const
 /**
    Set an element.
  */
-void FVector::setElement(std::size_t i, double value)
+template <typename Real>
+void BasicFVector<Real>::setElement(std::size_t i, Real value)
 {
   assert(0 <= i && i < _v->size());
 
@@ -90,18 +96,17 @@ void FVector::setElement(std::size_t i, double value)
    correspond to the number of undefined values in the current
    FVector.
  */
-DVector FVector::setUndefinedElements(DVector &values)
+template <typename Real>
+BasicVector<Real> BasicFVector<Real>::setUndefinedElements(BasicVector<Real> &values)
 {
   std::size_t sd  = size();
-  std::size_t sdd = numberOfDefinedElements();
-  std::size_t sud = values.size();
 
   // Assert that the size of the values vector given as parameter
   // corresponds to the number of undefined values in the current
   // FVector
-  assert(sd == sdd + sud);
+  assert(sd == numberOfDefinedElements() + values.size());
 
-  DVector values2(sd);
+  BasicVector<Real> values2(sd);
   std::size_t j = 0;
   for (std::size_t i = 0; i < sd; ++i)
     if ((*_v)[i].isDefined())
@@ -120,7 +125,8 @@ DVector FVector::setUndefinedElements(DVector &values)
 /**
    Element accessor.
  */
-FDouble &FVector::operator() (std::size_t i)
+template <typename Real>
+BasicFValue<Real> &BasicFVector<Real>::operator() (std::size_t i)
 {
   assert(0 <= i && i < _v->size());
 
@@ -130,7 +136,8 @@ FDouble &FVector::operator() (std::size_t i)
 /**
    Constant element accessor.
  */
-FDouble FVector::operator() (std::size_t i) const
+template <typename Real>
+BasicFValue<Real> BasicFVector<Real>::operator() (std::size_t i) const
 {
   assert(0 <= i && i < _v->size());
 
@@ -144,13 +151,14 @@ FDouble FVector::operator() (std::size_t i) const
 /**   
   os <<
 */
-std::ostream& operator<<(std::ostream& os, const FVector &fvector)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFVector<Real> &fvector)
 {
   for (std::size_t i = 0; i < fvector._v->size(); ++i)
     {
       if (i > 0) os << " ";
 
-      FDouble &element = (*fvector._v)[i];
+      BasicFValue<Real> &element = (*fvector._v)[i];
       if (element.isDefined())
 	os << element.getValue();
       else
@@ -160,6 +168,17 @@ std::ostream& operator<<(std::ostream& os, const FVector &fvector)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicFVector)
+
+#define INSTANTIATE(Real)						\
+  template std::ostream& operator<<(std::ostream& os, const BasicFVector<Real> &fvector);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
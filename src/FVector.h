@@ -4,7 +4,7 @@
    
    FVector.h   
    
-   Class: FVector
+   Class: BasicFVector, FVector
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -21,34 +21,41 @@
 
 namespace nsl {
 
-class DVector;
+template <typename Real> class BasicVector;
+template <typename Real> class BasicFVector;
+
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicFVector<Real> &fvector);
 
 // =========================================================
-// class FVector
+// class BasicFVector
 // ---------------------------------------------------------
 
-class FVector {
+template <typename Real>
+class BasicFVector {
 
 private:
-  std::vector<FDouble> *_v;
+  std::vector<BasicFValue<Real> > *_v;
 
 public:
-  FVector(size_t size = 0);
-  FVector(const FVector &v);
-  ~FVector();
+  BasicFVector(size_t size = 0);
+  BasicFVector(const BasicFVector &v);
+  ~BasicFVector();
 
   size_t size() const;
   size_t numberOfDefinedElements() const;
-  void setElement(size_t i, const double value);
-  DVector setUndefinedElements(DVector &values);
+  void setElement(size_t i, const Real value);
+  BasicVector<Real> setUndefinedElements(BasicVector<Real> &values);
 
-  FDouble &operator() (size_t i);
-  FDouble operator() (size_t i) const;
+  BasicFValue<Real> &operator() (size_t i);
+  BasicFValue<Real> operator() (size_t i) const;
 
   // Friends  
-  friend std::ostream& operator<<(std::ostream& os, const FVector &fvector);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicFVector &fvector);
 };
 
+typedef BasicFVector<double> FVector;
+
 } // namespace nsl
 
 #endif /* defined(__FVector__) */
@@ -0,0 +1,434 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Generator.cpp
+
+   Class: Generator
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+
+#include "Generator.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   SplitMix64 random number generator.
+
+   Small, fast and - other than the standard library distributions -
+   generating the same sequence on every platform.
+*/
+class Random {
+  std::uint64_t _state;
+
+public:
+  Random(std::uint64_t seed) : _state(seed) {}
+  
+  std::uint64_t next()
+  {
+    std::uint64_t z = (_state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // Uniformly distributed in [0, n)
+  std::size_t below(std::size_t n)
+  {
+    return next() % n;
+  }
+
+  // Uniformly distributed in [0, 1)
+  double uniform()
+  {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+};
+
+/**
+   A random number in [0, 1) depending only on the seed and i.
+
+   Used for the properties of the nodes, which have to be known
+   independently of the order in which the nodes are written.
+*/
+double hashUniform(std::uint64_t seed, std::uint64_t i)
+{
+  Random random(seed ^ (0x2545f4914f6cdd1dULL * (i + 1)));
+  return random.uniform();
+}
+
+/**
+   Greatest common divisor.
+*/
+std::uint64_t gcd(std::uint64_t a, std::uint64_t b)
+{
+  while (b != 0)
+    {
+      std::uint64_t t = a % b;
+      a = b;
+      b = t;
+    }
+  return a;
+}
+
+/**
+   Inverse of a modulo n (a and n have to be coprime).
+*/
+std::uint64_t inverse(std::uint64_t a, std::uint64_t n)
+{
+  // Extended Euclidean algorithm
+  std::int64_t t = 0, newT = 1;
+  std::int64_t r = n, newR = a % n;
+  while (newR != 0)
+    {
+      std::int64_t q = r / newR;
+      std::int64_t tmp;
+      tmp = t - q * newT; t = newT; newT = tmp;
+      tmp = r - q * newR; r = newR; newR = tmp;
+    }
+  return t < 0 ? t + n : t;
+}
+
+} // namespace
+
+// =========================================================
+// Class Generator
+// ---------------------------------------------------------
+
+Generator::Generator(Topology topology, std::size_t nodes, std::uint64_t seed)
+  : _topology(topology), _nodes(nodes < 2 ? 2 : nodes), _seed(seed) {}
+
+/**
+   Name of a topology.
+*/
+const char *Generator::topologyName(Topology topology)
+{
+  switch (topology)
+    {
+    case CHAIN:  return "chain";
+    case BUNDLE: return "bundle";
+    case TREE:   return "tree";
+    case GRID:   return "grid";
+    case RANDOM: return "random";
+    }
+
+  return "unknown";
+}
+
+/**
+   Topology with the given name.
+
+   Returns false when there is no topology with this name.
+*/
+bool Generator::parseTopology(const std::string &name, Topology &topology)
+{
+  for (int t = CHAIN; t <= RANDOM; ++t)
+    if (name == topologyName((Topology) t))
+      {
+	topology = (Topology) t;
+	return true;
+      }
+
+  return false;
+}
+
+/**
+   Name of a load pattern.
+*/
+const char *Generator::loadPatternName(LoadPattern pattern)
+{
+  switch (pattern)
+    {
+    case END:          return "end";
+    case UNIFORM:      return "uniform";
+    case RANDOM_LOADS: return "random";
+    }
+
+  return "unknown";
+}
+
+/**
+   Load pattern with the given name.
+
+   Returns false when there is no load pattern with this name.
+*/
+bool Generator::parseLoadPattern(const std::string &name, LoadPattern &pattern)
+{
+  for (int p = END; p <= RANDOM_LOADS; ++p)
+    if (name == loadPatternName((LoadPattern) p))
+      {
+	pattern = (LoadPattern) p;
+	return true;
+      }
+
+  return false;
+}
+
+/**
+   Number of parallel springs between two nodes of a bundle.
+*/
+void Generator::setBundleWidth(std::size_t width)
+{
+  _bundleWidth = width < 1 ? 1 : width;
+}
+
+/**
+   Number of children of each node of a tree.
+*/
+void Generator::setBranching(std::size_t branching)
+{
+  _branching = branching < 1 ? 1 : branching;
+}
+
+/**
+   Average node degree of a random network.
+
+   The spanning tree alone has the average degree 2 (almost), so
+   smaller values give a tree.
+*/
+void Generator::setAverageDegree(double degree)
+{
+  _averageDegree = degree;
+}
+
+/**
+   Probability of a node (other than the first one) to be fixed.
+*/
+void Generator::setConstraintDensity(double density)
+{
+  _constraintDensity = density;
+}
+
+/**
+   Distribution of the forces.
+*/
+void Generator::setLoadPattern(LoadPattern pattern)
+{
+  _loadPattern = pattern;
+}
+
+/**
+   Permute the node numbers.
+*/
+void Generator::setShuffle(bool shuffle)
+{
+  _shuffle = shuffle;
+
+  if (!shuffle)
+    {
+      _a = _aInverse = 1;
+      _c = 0;
+      return;
+    }
+
+  // The node numbering is an affine permutation of the node indices,
+  // which can be evaluated (and inverted) without storing it
+  Random random(_seed ^ 0x5851f42d4c957f2dULL);
+  _a = 1 + random.below(_nodes - 1);
+  while (gcd(_a, _nodes) != 1) 
+    _a = _a % (_nodes - 1) + 1;
+  _aInverse = inverse(_a, _nodes);
+  _c = random.below(_nodes);
+}
+
+/**
+   Number of nodes.
+*/
+std::size_t Generator::numberOfNodes() const
+{
+  return _nodes;
+}
+
+/**
+   Number of springs.
+*/
+std::size_t Generator::numberOfSprings() const
+{
+  std::size_t n = _nodes;
+  
+  switch (_topology)
+    {
+    case CHAIN:
+    case TREE:   
+      return n - 1;
+
+    case BUNDLE:
+      return _bundleWidth * (n - 1);
+      
+    case GRID:
+      {
+	// Springs to the right and lower neighbours
+	std::size_t w = gridWidth();
+	std::size_t right = n - (n + w - 1) / w;
+	std::size_t down  = n > w ? n - w : 0;
+	return right + down;
+      }
+
+    case RANDOM:
+      return n - 1 + randomSprings();
+    }
+
+  return 0;
+}
+
+/**
+   Width of the grid.
+*/
+std::size_t Generator::gridWidth() const
+{
+  std::size_t w = (std::size_t) std::ceil(std::sqrt((double) _nodes));
+  return w < 2 ? 2 : w;
+}
+
+/**
+   Number of the springs of a random network 
+   in addition to those of the spanning tree.
+*/
+std::size_t Generator::randomSprings() const
+{
+  double total = std::floor(0.5 * _averageDegree * _nodes + 0.5);
+  return total > _nodes - 1 ? (std::size_t) total - (_nodes - 1) : 0;
+}
+
+/**
+   Node number (1, 2, ...) of the node with the index i (0, 1, ...).
+*/
+std::size_t Generator::nodeNumber(std::size_t i) const
+{
+  return (_a * i + _c) % _nodes + 1;
+}
+
+/**
+   Index of the node with the given number.
+*/
+std::size_t Generator::nodeOfNumber(std::size_t number) const
+{
+  return (_aInverse * ((number - 1 + _nodes - _c) % _nodes)) % _nodes;
+}
+
+/**
+   Write the model as FEM definition file.
+*/
+void Generator::write(std::ostream &os) const
+{
+  os << "// Generated by nslfem: " << topologyName(_topology) 
+     << ", " << numberOfNodes() << " nodes"
+     << ", " << numberOfSprings() << " springs" 
+     << ", seed " << _seed << "\n\n";
+
+  writeNodes(os);
+  os << "\n";
+  writeSprings(os);
+  os << "\n// fin.\n";
+}
+
+/**
+   Write the node definitions.
+   
+   The nodes are written in the order of their numbers.
+*/
+void Generator::writeNodes(std::ostream &os) const
+{
+  for (std::size_t number = 1; number <= _nodes; ++number)
+    {
+      std::size_t i = nodeOfNumber(number);
+
+      bool fixed = (i == 0 || hashUniform(_seed, i) < _constraintDensity);
+      
+      os << "node " << number;
+      if (fixed)
+	os << "  d 0";
+      else
+	switch (_loadPattern)
+	  {
+	  case END:
+	    if (i == _nodes - 1) os << "  f 1";
+	    break;
+	  case UNIFORM:
+	    os << "  f 1";
+	    break;
+	  case RANDOM_LOADS:
+	    os << "  f " << 2 * hashUniform(~_seed, i) - 1;
+	    break;
+	  }
+      os << "\n";
+    }
+}
+
+/**
+   Write a spring definition.
+*/
+void Generator::writeSpring(std::ostream &os, std::size_t id, 
+			    std::size_t node1, std::size_t node2, double k) const
+{
+  os << "spring " << id << "  " << nodeNumber(node1) << " " << nodeNumber(node2) << "  " << k << "\n";
+}
+
+/**
+   Write the spring definitions.
+*/
+void Generator::writeSprings(std::ostream &os) const
+{
+  Random random(_seed);
+  std::size_t n  = _nodes;
+  std::size_t id = 0;
+  
+  switch (_topology)
+    {
+    case CHAIN:
+      for (std::size_t i = 0; i + 1 < n; ++i)
+	writeSpring(os, ++id, i, i + 1, 1 + random.below(10));
+      break;
+
+    case BUNDLE:
+      for (std::size_t i = 0; i + 1 < n; ++i)
+	for (std::size_t j = 0; j < _bundleWidth; ++j)
+	  writeSpring(os, ++id, i, i + 1, 1 + random.below(10));
+      break;
+      
+    case TREE:
+      for (std::size_t i = 1; i < n; ++i)
+	writeSpring(os, ++id, (i - 1) / _branching, i, 1 + random.below(10));
+      break;
+      
+    case GRID:
+      {
+	std::size_t w = gridWidth();
+	for (std::size_t i = 0; i < n; ++i)
+	  {
+	    if ((i + 1) % w != 0 && i + 1 < n)
+	      writeSpring(os, ++id, i, i + 1, 1 + random.below(10));
+	    if (i + w < n)
+	      writeSpring(os, ++id, i, i + w, 1 + random.below(10));
+	  }
+      }
+      break;
+
+    case RANDOM:
+      // A random spanning tree keeps the model connected
+      for (std::size_t i = 1; i < n; ++i)
+	writeSpring(os, ++id, random.below(i), i, 1 + 9 * random.uniform());
+
+      // Additional springs between random pairs of different nodes
+      for (std::size_t i = randomSprings(); i > 0; --i)
+	{
+	  std::size_t a = random.below(n);
+	  std::size_t b = random.below(n - 1);
+	  if (b >= a) ++b;
+	  writeSpring(os, ++id, a, b, 1 + 9 * random.uniform());
+	}
+      break;
+    }
+}
+
+} // namespace nsl
+
+/* fin */
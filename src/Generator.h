@@ -0,0 +1,129 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Generator.h
+
+   Class: Generator
+
+   Generates synthetic spring assemblages of a given topology and
+   size and writes them as FEM definition files.  The model is
+   written while it is generated and never held in memory, so that
+   models with hundreds of millions of springs can be generated.
+
+   Topologies:
+
+     chain    Springs in series:  1 - 2 - 3 - ... - n
+     bundle   A chain with several parallel springs 
+              between consecutive nodes (see setBundleWidth())
+     tree     Tree, node i is attached to node (i - 2) / b + 1
+              (b: branching factor, see setBranching())
+     grid     Square grid graph, each node is connected
+              to its right and lower neighbour
+     random   Random spanning tree plus random additional springs
+              (see setAverageDegree())
+
+   Boundary conditions:
+
+     The first node always has the prescribed displacement 0, the
+     other nodes are fixed with the probability given by
+     setConstraintDensity().
+
+   Loads (setLoadPattern()):
+
+     end      The last node is loaded with the force 1
+     uniform  All unconstrained nodes are loaded with the force 1
+     random   All unconstrained nodes are loaded with a random
+              force between -1 and 1
+
+   With setShuffle(true) the node numbers are permuted randomly, so
+   that the node numbering does not follow the structure.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Generator__
+#define __Generator__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <iostream>
+
+namespace nsl {
+
+// =========================================================
+// class Generator
+// ---------------------------------------------------------
+
+class Generator {
+
+ public:
+  enum Topology {
+    CHAIN,
+    BUNDLE,
+    TREE,
+    GRID,
+    RANDOM
+  };
+
+  enum LoadPattern {
+    END,
+    UNIFORM,
+    RANDOM_LOADS
+  };
+
+ private:
+  Topology _topology;
+  std::size_t _nodes;
+  std::uint64_t _seed;
+
+  std::size_t _bundleWidth   = 3;
+  std::size_t _branching     = 2;
+  double _averageDegree      = 4;
+  double _constraintDensity  = 0;
+  LoadPattern _loadPattern   = END;
+  bool _shuffle              = false;
+
+  // Node numbering: number(i) = (_a * i + _c) % _nodes + 1
+  std::uint64_t _a = 1, _aInverse = 1, _c = 0;
+  
+ public:
+  Generator(Topology topology, std::size_t nodes, std::uint64_t seed = 1);
+
+  static const char *topologyName(Topology topology);
+  static bool parseTopology(const std::string &name, Topology &topology);
+  static const char *loadPatternName(LoadPattern pattern);
+  static bool parseLoadPattern(const std::string &name, LoadPattern &pattern);
+
+  void setBundleWidth(std::size_t width);
+  void setBranching(std::size_t branching);
+  void setAverageDegree(double degree);
+  void setConstraintDensity(double density);
+  void setLoadPattern(LoadPattern pattern);
+  void setShuffle(bool shuffle);
+
+  std::size_t numberOfNodes() const;
+  std::size_t numberOfSprings() const;
+
+  void write(std::ostream &os) const;
+
+ private:
+  void writeNodes(std::ostream &os) const;
+  void writeSprings(std::ostream &os) const;
+  void writeSpring(std::ostream &os, std::size_t id, 
+		   std::size_t node1, std::size_t node2, double k) const;
+  std::size_t gridWidth() const;
+  std::size_t randomSprings() const;
+  std::size_t nodeNumber(std::size_t i) const;
+  std::size_t nodeOfNumber(std::size_t number) const;
+};
+
+} // namespace nsl
+
+#endif /* defined(__Generator__) */
+
+/* fin */
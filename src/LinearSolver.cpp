@@ -0,0 +1,122 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   LinearSolver.cpp
+
+   Class: LinearSolverBase, BasicLinearSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <iostream>
+
+#include "DenseSolver.h"
+#include "BandSolver.h"
+#include "SparseSolver.h"
+#include "CGSolver.h"
+#include "TreeSolver.h"
+#include "TreeCGSolver.h"
+#include "AMGSolver.h"
+#include "AMGCGSolver.h"
+#include "LinearSolver.h"
+
+namespace nsl {
+
+namespace {
+
+const char *typeNames[] = { "auto", "dense", "band", "sparse", "cg", "tree", "tree-cg", "amg", "amg-cg" };
+
+} // namespace
+
+// =========================================================
+// Class LinearSolverBase
+// ---------------------------------------------------------
+
+/**
+   Name of a solver type as used by the --solver option.
+*/
+const char *LinearSolverBase::typeName(Type type)
+{
+  return typeNames[type];
+}
+
+/**
+   Parse a solver type name.  Returns false for an unknown name.
+*/
+bool LinearSolverBase::parseType(const std::string &name, Type &type)
+{
+  for (int t = AUTO; t <= AMG_CG; ++t)
+    if (name == typeNames[t])
+      {
+	type = (Type) t;
+	return true;
+      }
+
+  return false;
+}
+
+/**
+   True for the solvers which factorize the matrix: their solve()
+   does not change the solver and can be called concurrently.
+*/
+bool LinearSolverBase::isDirect(Type type)
+{
+  return type == DENSE || type == BAND || type == SPARSE || type == TREE;
+}
+
+// =========================================================
+// Class BasicLinearSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+BasicLinearSolver<Real>::~BasicLinearSolver() {}
+
+/**
+   Create a solver of the given type.
+*/
+template <typename Real>
+BasicLinearSolver<Real> *BasicLinearSolver<Real>::create(Type type)
+{
+  switch (type)
+    {
+    case DENSE:  return new BasicDenseSolver<Real>();
+    case BAND:   return new BasicBandSolver<Real>();
+    case SPARSE: return new BasicSparseSolver<Real>();
+    case CG:     return new BasicCGSolver<Real>();
+    case TREE:   return new BasicTreeSolver<Real>();
+    case TREE_CG: return new BasicTreeCGSolver<Real>();
+    case AMG:    return new BasicAMGSolver<Real>();
+    case AMG_CG: return new BasicAMGCGSolver<Real>();
+    default:
+      std::cerr << "ERROR No solver of type " << typeName(type) << "!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+/**
+   Factorize a symmetric matrix given by its upper triangle.
+
+   The default expands the matrix to full rows and factorizes the
+   expanded copy; the direct solvers override it to work on the
+   upper triangle only.
+*/
+template <typename Real>
+void BasicLinearSolver<Real>::factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  _expanded = matrix.toFull();
+  factor(_expanded);
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicLinearSolver)
+
+} // namespace nsl
+
+/* fin */
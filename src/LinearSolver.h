@@ -0,0 +1,114 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   LinearSolver.h
+
+   Class: LinearSolverBase, BasicLinearSolver, LinearSolver
+
+   Interface of the backends solving the reduced (symmetric,
+   positive definite) stiffness system K u = f:
+
+     dense   Gaussian elimination in symmetric packed storage (DenseSolver)
+     band    Band Cholesky factorization in the given node order (BandSolver)
+     sparse  Reverse Cuthill-McKee ordering and sparse Cholesky
+             factorization (SparseSolver)
+     cg      Conjugate gradients with Jacobi preconditioning (CGSolver)
+     tree    Leaf to root elimination of tree-shaped (acyclic) 
+             matrix graphs in linear time (TreeSolver)
+     tree-cg Conjugate gradients preconditioned with a maximum
+             weight spanning tree (TreeCGSolver)
+     amg     Smoothed aggregation algebraic multigrid (AMGSolver)
+     amg-cg  Conjugate gradients preconditioned with a multigrid
+             V-cycle (AMGCGSolver)
+
+   Usage:
+
+     LinearSolver *solver = LinearSolver::create(LinearSolver::BAND);
+     solver->factor(K);
+     DVector u = solver->solve(f);
+     delete solver;
+
+   The factorization is kept, so that solve() can be called for
+   several right hand sides.
+
+   The stiffness matrices are stored as their upper triangle (see
+   SymmetricSMatrix.h) and factorized with factorSymmetric(): the
+   direct solvers (dense, band, sparse) read the upper triangle
+   directly; the others work on full rows and factorize an expanded
+   copy, which is kept for the lifetime of the factorization.
+
+   The solvers are templates on the scalar type (see Precision.h);
+   LinearSolver is the double precision solver.  The solver types
+   are defined in the common base class LinearSolverBase.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __LinearSolver__
+#define __LinearSolver__
+
+#include <string>
+
+#include "DVector.h"
+#include "SMatrix.h"
+#include "SymmetricSMatrix.h"
+
+namespace nsl {
+
+// =========================================================
+// class LinearSolverBase
+// ---------------------------------------------------------
+
+class LinearSolverBase {
+
+ public:
+  enum Type {
+    AUTO = 0,
+    DENSE,
+    BAND,
+    SPARSE,
+    CG,
+    TREE,
+    TREE_CG,
+    AMG,
+    AMG_CG
+  };
+
+  static const char *typeName(Type type);
+  static bool parseType(const std::string &name, Type &type);
+  static bool isDirect(Type type);
+};
+
+// =========================================================
+// class BasicLinearSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicLinearSolver : public LinearSolverBase {
+
+ public:
+  static BasicLinearSolver *create(Type type);
+
+  virtual ~BasicLinearSolver();
+
+  virtual Type type() const = 0;
+  virtual void factor(const BasicSMatrix<Real> &matrix) = 0;
+  virtual void factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  virtual BasicVector<Real> solve(const BasicVector<Real> &b) const = 0;
+
+ protected:
+  // The full matrix factorized by the default factorSymmetric()
+  BasicSMatrix<Real> _expanded;
+};
+
+typedef BasicLinearSolver<double> LinearSolver;
+
+} // namespace nsl
+
+#endif /* defined(__LinearSolver__) */
+
+/* fin */
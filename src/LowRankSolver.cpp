@@ -0,0 +1,173 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   LowRankSolver.cpp
+
+   Class: BasicLowRankSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+
+#include "Profiler.h"
+#include "DVector.h"
+#include "DMatrix.h"
+#include "LowRankSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicLowRankSolver
+// ---------------------------------------------------------
+
+/**
+    Constructor: takes the ownership of the factorization `solver'
+    of K0; `solution' is K0^-1 b.
+*/
+template <typename Real>
+BasicLowRankSolver<Real>::BasicLowRankSolver(BasicLinearSolver<Real> *solver, const BasicVector<Real> &solution)
+  : _solver(solver), _solution(solution) {}
+
+/**
+    Destructor.
+*/
+template <typename Real>
+BasicLowRankSolver<Real>::~BasicLowRankSolver()
+{
+  delete _solver;
+}
+
+/**
+   Size of the system.
+*/
+template <typename Real>
+std::size_t BasicLowRankSolver<Real>::size() const
+{
+  return _solution.size();
+}
+
+/**
+   Number of changed springs.
+*/
+template <typename Real>
+std::size_t BasicLowRankSolver<Real>::rank() const
+{
+  return _changes.size();
+}
+
+/**
+   The factorization of the original matrix K0.
+*/
+template <typename Real>
+const BasicLinearSolver<Real> &BasicLowRankSolver<Real>::solver() const
+{
+  return *_solver;
+}
+
+/**
+   The solution of the original system K0^-1 b.
+*/
+template <typename Real>
+const BasicVector<Real> &BasicLowRankSolver<Real>::solution() const
+{
+  return _solution;
+}
+
+/**
+   True when the spring `key' has been changed before.
+*/
+template <typename Real>
+bool BasicLowRankSolver<Real>::contains(std::size_t key) const
+{
+  for (const Change &change : _changes)
+    if (change.key == key) return true;
+
+  return false;
+}
+
+/**
+   Add d v v^T, v = e_p - e_q, to the matrix and subtract d c v from
+   the right side.  The changes of the same spring (`key') add up;
+   a new spring costs a solve with the factorization.
+*/
+template <typename Real>
+void BasicLowRankSolver<Real>::update(std::size_t key, std::size_t p, std::size_t q, Real delta, Real shift)
+{
+  std::size_t n = size();
+
+  for (Change &change : _changes)
+    if (change.key == key)
+      {
+	change.delta += delta;
+	change.shift = shift;
+	return;
+      }
+
+  BasicVector<Real> v(n);
+  if (p < n) v(p) = 1;
+  if (q < n) v(q) = -1;
+  BasicVector<Real> z = _solver->solve(v);
+
+  const Real *zz = z.span().data();
+  _changes.push_back({ key, p, q, delta, shift, std::vector<Real>(zz, zz + n) });
+}
+
+/**
+   Solve the changed system.
+*/
+template <typename Real>
+BasicVector<Real> BasicLowRankSolver<Real>::solve() const
+{
+  std::size_t n = size();
+  std::size_t r = rank();
+
+  // y = K0^-1 b - Z D c
+  const Real *y0 = _solution.span().data();
+  std::vector<Real> y(y0, y0 + n);
+  for (const Change &change : _changes)
+    if (change.shift != 0)
+      for (std::size_t i = 0; i < n; ++i)
+	y[i] -= change.z[i] * change.delta * change.shift;
+
+  if (r == 0) return BasicVector<Real>(y);
+
+  // v^T w, v = e_p - e_q
+  auto dot = [n] (const Change &change, const std::vector<Real> &w) -> Real {
+    return (change.p < n ? w[change.p] : 0) - (change.q < n ? w[change.q] : 0);
+  };
+
+  // (I + D V^T Z) a = D V^T y
+  BasicMatrix<Real> capacitance(r, r);
+  BasicVector<Real> rhs(r);
+  for (std::size_t s = 0; s < r; ++s)
+    {
+      const Change &change = _changes[s];
+      for (std::size_t t = 0; t < r; ++t)
+	capacitance(s, t) = (s == t ? 1 : 0) + change.delta * dot(change, _changes[t].z);
+      rhs(s) = change.delta * dot(change, y);
+    }
+  BasicVector<Real> a = capacitance.gaussianElimination(rhs);
+
+  // x = y - Z a
+  for (std::size_t s = 0; s < r; ++s)
+    for (std::size_t i = 0; i < n; ++i)
+      y[i] -= _changes[s].z[i] * a(s);
+
+  Profiler::countFlops(std::uint64_t(4) * r * n + 3 * r * r);
+
+  return BasicVector<Real>(y);
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicLowRankSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,96 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   LowRankSolver.h
+
+   Class: BasicLowRankSolver, LowRankSolver
+
+   Re-solve a factorized system after low-rank changes of its matrix,
+   without factorizing it again.  Changing the spring constant of a
+   spring between the degrees of freedom p and q by d changes the
+   stiffness matrix by the rank-1 matrix d v v^T, v = e_p - e_q.
+   With the factorization of the original matrix K0 and the
+   Sherman-Morrison-Woodbury formula, the system with r changed
+   springs
+
+     (K0 + V D V^T) x = b - V D c
+
+   (V = [v_1 ... v_r], D = diag(d_1 ... d_r)) is solved by
+
+     y = K0^-1 b - Z D c,     Z = K0^-1 V
+     x = y - Z (I + D V^T Z)^-1 D V^T y
+
+   Every new spring costs one solve with the factorization (its
+   column z of Z), every solution O(r^2 + r^3 + n r) on top of it.
+   The right side term c_s is the prescribed displacement difference
+   at the constrained end of a spring (0 when both ends are free): it
+   moves the change of the coupling to the constrained degrees of
+   freedom to the right side.  A constrained end is left out of v
+   (given as an index >= size(), as in Constraints::freeIndex()).
+
+   I + D V^T Z is singular when the changes make the matrix singular
+   (a spring cut through which releases a part of the model): the
+   caller has to rule such changes out (see
+   FEM::tryUpdateSpringConstant()).
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __LowRankSolver__
+#define __LowRankSolver__
+
+#include <cstddef>
+#include <vector>
+
+#include "DVector.h"
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicLowRankSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicLowRankSolver {
+
+  // The factorization of K0 (owned) and the solution K0^-1 b
+  BasicLinearSolver<Real> *_solver;
+  BasicVector<Real> _solution;
+
+  // A changed spring: the key given by the caller, the indices of
+  // its ends (>= size() for a constrained end), the summed changes d,
+  // c and the column z = K0^-1 v
+  struct Change {
+    std::size_t key, p, q;
+    Real delta, shift;
+    std::vector<Real> z;
+  };
+  std::vector<Change> _changes;
+
+ public:
+  BasicLowRankSolver(BasicLinearSolver<Real> *solver, const BasicVector<Real> &solution);
+  ~BasicLowRankSolver();
+
+  std::size_t size() const;
+  std::size_t rank() const;
+
+  const BasicLinearSolver<Real> &solver() const;
+  const BasicVector<Real> &solution() const;
+  bool contains(std::size_t key) const;
+
+  void update(std::size_t key, std::size_t p, std::size_t q, Real delta, Real shift);
+  BasicVector<Real> solve() const;
+};
+
+typedef BasicLowRankSolver<double> LowRankSolver;
+
+} // namespace nsl
+
+#endif /* defined(__LowRankSolver__) */
+
+/* fin */
@@ -0,0 +1,260 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   MemoryTracker.cpp
+
+   Class: MemoryTracker
+
+   The size of a block which is freed is taken from the allocator
+   (malloc_usable_size / malloc_size), so that no header has to be
+   added to the blocks and tracking can be switched on at any time.
+   Consequently the tracked sizes are the usable sizes of the
+   blocks, which may be slightly larger than the requested ones.
+   On other systems only the number of allocations is tracked.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdlib>
+#include <new>
+#include <iostream>
+
+#if defined(__GLIBC__)
+#  include <malloc.h>
+#  define NSL_BLOCK_SIZE(p) malloc_usable_size(p)
+#elif defined(__APPLE__)
+#  include <malloc/malloc.h>
+#  define NSL_BLOCK_SIZE(p) malloc_size(p)
+#else
+#  define NSL_BLOCK_SIZE(p) 0
+#endif
+
+#include "Profiler.h"
+#include "MemoryTracker.h"
+
+namespace nsl {
+
+// =========================================================
+// Class MemoryTracker
+// ---------------------------------------------------------
+
+bool MemoryTracker::_enabled = false;
+std::atomic<std::uint64_t> MemoryTracker::_current(0);
+std::atomic<std::uint64_t> MemoryTracker::_peak(0);
+std::atomic<std::uint64_t> MemoryTracker::_budget(0);
+std::atomic<std::uint64_t> MemoryTracker::_warned(0);
+
+/**
+   Switch the tracking on.
+*/
+void MemoryTracker::enable()
+{
+  _enabled = true;
+}
+
+/**
+   Bytes currently allocated (since the tracking has been switched on).
+*/
+std::uint64_t MemoryTracker::current()
+{
+  return _current.load(std::memory_order_relaxed);
+}
+
+/**
+   High-water mark of the allocated bytes.
+*/
+std::uint64_t MemoryTracker::peak()
+{
+  return _peak.load(std::memory_order_relaxed);
+}
+
+/**
+   Start measuring the peak of a phase: the high-water mark is set
+   to the bytes currently in use.  Returns the previous high-water
+   mark, which has to be passed to endPeak().
+*/
+std::uint64_t MemoryTracker::beginPeak()
+{
+  return _peak.exchange(current(), std::memory_order_relaxed);
+}
+
+/**
+   End measuring the peak of a phase.  Returns the peak of the
+   phase and restores the high-water mark of the enclosing scope.
+*/
+std::uint64_t MemoryTracker::endPeak(std::uint64_t outerPeak)
+{
+  std::uint64_t phasePeak = peak();
+  if (outerPeak > phasePeak)
+    _peak.store(outerPeak, std::memory_order_relaxed);
+
+  return phasePeak;
+}
+
+/**
+   Set the memory budget in bytes (0: no budget).
+*/
+void MemoryTracker::setBudget(std::uint64_t bytes)
+{
+  _budget = bytes;
+  _warned = 0;
+}
+
+/**
+   Memory budget in bytes (0: no budget).
+*/
+std::uint64_t MemoryTracker::budget()
+{
+  return _budget.load(std::memory_order_relaxed);
+}
+
+/**
+   Check whether allocating `bytes' more bytes for `what' stays
+   within the budget.  Otherwise print a warning and return false.
+   The warning is only printed for projections larger than the
+   ones already warned about.
+*/
+bool MemoryTracker::checkBudget(std::uint64_t bytes, const char *what)
+{
+  std::uint64_t budget = MemoryTracker::budget();
+  if (budget == 0) return true;
+
+  std::uint64_t projected = current() + bytes;
+  if (projected <= budget) return true;
+
+  std::uint64_t warned = _warned.load(std::memory_order_relaxed);
+  while (projected > warned)
+    if (_warned.compare_exchange_weak(warned, projected, std::memory_order_relaxed))
+      {
+	std::cerr << "WARNING: Allocating " << what << " of " << bytes / (1 << 20) << " MB"
+		  << " exceeds the memory budget of " << budget / (1 << 20) << " MB"
+		  << " (projected: " << projected / (1 << 20) << " MB)" << std::endl;
+	break;
+      }
+
+  return false;
+}
+
+/**
+   Record an allocation (called by operator new).
+*/
+void MemoryTracker::allocated(std::size_t bytes)
+{
+  std::uint64_t current = _current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+  std::uint64_t peak = _peak.load(std::memory_order_relaxed);
+  while (current > peak && 
+	 !_peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+    ;
+
+  Profiler::count(Profiler::HEAP_ALLOCATIONS, 1);
+  Profiler::count(Profiler::HEAP_BYTES, bytes);
+}
+
+/**
+   Record a deallocation (called by operator delete).
+*/
+void MemoryTracker::released(std::size_t bytes)
+{
+  // Blocks allocated before the tracking has been switched on
+  // must not make the counter wrap around
+  std::uint64_t current = _current.load(std::memory_order_relaxed);
+  std::uint64_t next;
+  do
+    next = (bytes < current) ? current - bytes : 0;
+  while (!_current.compare_exchange_weak(current, next, std::memory_order_relaxed));
+}
+
+} // namespace nsl
+
+// =========================================================
+// Global operators new and delete
+// ---------------------------------------------------------
+
+namespace {
+
+void *allocate(std::size_t size)
+{
+  if (size == 0) size = 1;
+
+  void *p;
+  while ((p = std::malloc(size)) == nullptr)
+    {
+      std::new_handler handler = std::get_new_handler();
+      if (!handler) throw std::bad_alloc();
+      handler();
+    }
+
+  if (nsl::MemoryTracker::enabled())
+    nsl::MemoryTracker::allocated(NSL_BLOCK_SIZE(p));
+
+  return p;
+}
+
+void release(void *p)
+{
+  if (!p) return;
+
+  if (nsl::MemoryTracker::enabled())
+    nsl::MemoryTracker::released(NSL_BLOCK_SIZE(p));
+
+  std::free(p);
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+  return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+  return allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void *p) noexcept
+{
+  release(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  release(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  release(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+  release(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+  release(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+  release(p);
+}
+
+/* fin */
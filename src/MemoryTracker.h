@@ -0,0 +1,83 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   MemoryTracker.h
+
+   Class: MemoryTracker
+
+   Opt-in tracking of the heap.  The global operators new and
+   delete are replaced (see MemoryTracker.cpp); once the tracker is
+   switched on they count every allocation and keep track of the
+   bytes currently in use and of their high-water mark.  While
+   profiling is switched on as well the allocations are attributed
+   to the running phase (see Profiler.h) and the peak of each phase
+   is reported.
+
+   Independently of the tracking a memory budget can be set.
+   Allocating a dense DMatrix whose projected size would push the
+   heap over the budget prints a warning before the memory is
+   actually requested.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __MemoryTracker__
+#define __MemoryTracker__
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+
+namespace nsl {
+
+// =========================================================
+// class MemoryTracker
+// ---------------------------------------------------------
+
+class MemoryTracker {
+
+  static bool _enabled;
+  static std::atomic<std::uint64_t> _current;
+  static std::atomic<std::uint64_t> _peak;
+  static std::atomic<std::uint64_t> _budget;
+  static std::atomic<std::uint64_t> _warned;
+
+ public:
+  static void enable();
+  static bool enabled();
+
+  static std::uint64_t current();
+  static std::uint64_t peak();
+
+  static std::uint64_t beginPeak();
+  static std::uint64_t endPeak(std::uint64_t outerPeak);
+
+  static void setBudget(std::uint64_t bytes);
+  static std::uint64_t budget();
+  static bool checkBudget(std::uint64_t bytes, const char *what);
+
+  static void allocated(std::size_t bytes);
+  static void released(std::size_t bytes);
+};
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   True when the heap is tracked.
+*/
+inline bool MemoryTracker::enabled()
+{
+  return _enabled;
+}
+
+} // namespace nsl
+
+#endif /* defined(__MemoryTracker__) */
+
+/* fin */
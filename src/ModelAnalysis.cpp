@@ -0,0 +1,280 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ModelAnalysis.cpp
+
+   Struct: ModelAnalysis
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "UnionFind.h"
+#include "ModelAnalysis.h"
+
+namespace nsl {
+
+namespace {
+
+// Largest system solved with the dense solver
+const std::size_t maxDenseDofs = 250;
+
+// Largest bandwidth for which the band solver is chosen
+const std::size_t maxBandwidth = 64;
+
+// Largest estimated work (dofs * bandwidth^2) of the sparse direct
+// solver for a cyclic network; its reordering usually does better than
+// the given numbering, so the estimate is an upper bound
+const double maxSparseWork = 1e10;
+
+// Smallest ratio of the largest to the smallest spring constant
+// for which conjugate gradients are preconditioned with a spanning tree
+// instead of the diagonal
+const double minTreePreconditionerSpread = 100;
+
+// Largest bandwidth, relative to the number of free DOFs, for which a
+// large network counts as mesh like (nodes only coupled to nodes with
+// nearby numbers) and conjugate gradients are preconditioned with
+// algebraic multigrid
+const double maxMultigridBandwidthFraction = 0.1;
+
+} // namespace
+
+// =========================================================
+// Struct ModelAnalysis
+// ---------------------------------------------------------
+
+ModelAnalysis::ModelAnalysis() {}
+
+/**
+   Analyse the spring graph.  
+   `constrained' is true for the nodes with a prescribed displacement.
+   The spring constants are optional; springs with a spring constant
+   of 0 are no edges of the graph (as in FEM::floatingComponents()).
+*/
+ModelAnalysis::ModelAnalysis(std::size_t numberOfNodes,
+			     const std::vector<int> &springNode1,
+			     const std::vector<int> &springNode2,
+			     const std::vector<bool> &constrained,
+			     const std::vector<double> &springConstants)
+{
+  ScopedTimer timer("analysis");
+
+  // The ratio of the largest to the smallest (nonzero) spring constant
+  double minK = 0, maxK = 0;
+  for (double k : springConstants)
+    if (k != 0)
+      {
+	k = std::fabs(k);
+	if (minK == 0 || k < minK) minK = k;
+	if (k > maxK) maxK = k;
+      }
+  if (minK > 0) stiffnessSpread = maxK / minK;
+
+  nodes   = numberOfNodes;
+  springs = springNode1.size();
+
+  // Index of each node in the reduced system
+  std::vector<std::size_t> freeIndex(nodes);
+  for (std::size_t i = 0; i < nodes; ++i)
+    {
+      freeIndex[i] = dofs;
+      if (constrained[i]) ++constrainedNodes;
+      else ++dofs;
+    }
+
+  // The springs by their node with the smaller index, in a counting
+  // pass (compressed rows).  Springs from a node to itself and
+  // springs without stiffness do not couple any nodes.
+  auto couples = [&] (std::size_t s) -> bool {
+    return springNode1[s] != springNode2[s] && (springConstants.empty() || springConstants[s] != 0);
+  };
+  std::vector<std::size_t> rowStart(nodes + 1, 0);
+  for (std::size_t s = 0; s < springs; ++s)
+    if (couples(s)) ++rowStart[std::min(springNode1[s], springNode2[s]) + 1];
+  for (std::size_t i = 0; i < nodes; ++i)
+    rowStart[i + 1] += rowStart[i];
+  std::vector<std::size_t> neighbour(rowStart[nodes]);
+  std::vector<std::size_t> next(rowStart.begin(), rowStart.end() - 1);
+  for (std::size_t s = 0; s < springs; ++s)
+    if (couples(s))
+      {
+	std::size_t a = springNode1[s];
+	std::size_t b = springNode2[s];
+	neighbour[next[std::min(a, b)]++] = std::max(a, b);
+      }
+
+  std::vector<std::size_t> degree(nodes, 0);
+  UnionFind components(nodes), freeComponents(nodes);
+  bool cycle = false, freeCycle = false;
+
+  // Every node pair once: parallel springs connect the same
+  // pair and do not change the structure
+  const std::size_t none = nodes;
+  std::vector<std::size_t> seenFrom(nodes, none);
+  nnz = dofs;
+  for (std::size_t a = 0; a < nodes; ++a)
+    for (std::size_t k = rowStart[a]; k < rowStart[a + 1]; ++k)
+      {
+	std::size_t b = neighbour[k];
+	if (seenFrom[b] == a) continue;
+	seenFrom[b] = a;
+
+	++degree[a];
+	++degree[b];
+	if (!components.unite(a, b)) cycle = true;
+
+	if (!constrained[a] && !constrained[b])
+	  {
+	    nnz += 2;
+	    bandwidth = std::max(bandwidth, freeIndex[b] - freeIndex[a]);
+	    if (!freeComponents.unite(a, b)) freeCycle = true;
+	  }
+      }
+
+  for (std::size_t i = 0; i < nodes; ++i)
+    {
+      maxDegree = std::max(maxDegree, degree[i]);
+      averageDegree += degree[i];
+    }
+  if (nodes > 0) averageDegree /= nodes;
+
+  degreeHistogram.assign(maxDegree + 1, 0);
+  for (std::size_t i = 0; i < nodes; ++i)
+    ++degreeHistogram[degree[i]];
+
+  this->components = components.sets();
+  forest = !cycle;
+  chains = forest && maxDegree <= 2;
+  freeForest = !freeCycle;
+}
+
+/**
+   Analyse the graph of a (reduced) stiffness matrix: 
+   each row is a free node, each off-diagonal element a spring.
+*/
+template <typename Real>
+ModelAnalysis::ModelAnalysis(const BasicSMatrix<Real> &stiffnessMatrix)
+{
+  std::vector<int> node1, node2;
+  std::vector<double> springConstants;
+  for (std::size_t i = 0; i < stiffnessMatrix.rows(); ++i)
+    for (std::size_t k = stiffnessMatrix.rowStart()[i]; k < stiffnessMatrix.rowStart()[i + 1]; ++k)
+      if (stiffnessMatrix.colIndex()[k] > i)
+	{
+	  node1.push_back(i);
+	  node2.push_back(stiffnessMatrix.colIndex()[k]);
+	  springConstants.push_back(double(stiffnessMatrix.values()[k]));
+	}
+
+  *this = ModelAnalysis(stiffnessMatrix.rows(), node1, node2, 
+			std::vector<bool>(stiffnessMatrix.rows(), false), springConstants);
+}
+
+/**
+   Choose the solver backend for the analysed model:
+
+     - small systems are solved exactly by the dense solver,
+     - forests (chains, trees) by the tree solver in linear time;
+       as the constrained nodes are eliminated before solving, 
+       it is enough that the graph of the free nodes has no cycles,
+     - systems with a small bandwidth by the band solver,
+     - moderately sized or slim cyclic networks by the sparse direct
+       solver,
+     - large, well connected networks (random networks, grids with
+       shuffled node numbers, ...) by conjugate gradients, which 
+       converge fast for them while a factorization would fill in;
+       when the spring constants vary over orders of magnitude, 
+       Jacobi preconditioning stalls and a spanning tree 
+       preconditioner is used instead; on large mesh like networks
+       (a bandwidth much smaller than the number of DOFs) the
+       iterations of Jacobi preconditioned CG grow with the diameter
+       and multigrid is used as preconditioner.
+
+   `reason' is set to a short explanation of the decision.
+*/
+LinearSolver::Type ModelAnalysis::recommendSolver(std::string &reason) const
+{
+  std::ostringstream os;
+  LinearSolver::Type type;
+
+  if (dofs <= maxDenseDofs)
+    {
+      os << dofs << " free DOFs <= " << maxDenseDofs;
+      type = LinearSolver::DENSE;
+    }
+  else if (freeForest)
+    {
+      os << (chains ? "chains" : (forest ? "forest" : "acyclic free nodes")) << ", no fill-in";
+      type = LinearSolver::TREE;
+    }
+  else if (bandwidth <= maxBandwidth)
+    {
+      os << "bandwidth " << bandwidth << " <= " << maxBandwidth;
+      type = LinearSolver::BAND;
+    }
+  else if (double(dofs) * bandwidth * bandwidth <= maxSparseWork)
+    {
+      os << dofs << " free DOFs, bandwidth " << bandwidth;
+      type = LinearSolver::SPARSE;
+    }
+  else if (stiffnessSpread >= minTreePreconditionerSpread)
+    {
+      os << dofs << " free DOFs, bandwidth " << bandwidth << ", stiffness spread " << stiffnessSpread;
+      type = LinearSolver::TREE_CG;
+    }
+  else if (bandwidth <= maxMultigridBandwidthFraction * dofs)
+    {
+      os << dofs << " free DOFs, bandwidth " << bandwidth << ", mesh like";
+      type = LinearSolver::AMG_CG;
+    }
+  else
+    {
+      os << dofs << " free DOFs, bandwidth " << bandwidth << ", average degree " << averageDegree;
+      type = LinearSolver::CG;
+    }
+
+  reason = os.str();
+  return type;
+}
+
+/**
+   Print the analysis.
+*/
+std::ostream& operator<<(std::ostream& os, const ModelAnalysis& analysis)
+{
+  os << "nodes: "       << analysis.nodes
+     << ", springs: "    << analysis.springs
+     << ", constrained: " << analysis.constrainedNodes
+     << ", DOFs: "       << analysis.dofs
+     << ", nnz: "        << analysis.nnz
+     << ", bandwidth: "  << analysis.bandwidth
+     << ", degree: "     << analysis.averageDegree << " (max " << analysis.maxDegree << ")"
+     << ", components: " << analysis.components
+     << ", stiffness spread: " << analysis.stiffnessSpread
+     << (analysis.chains ? ", chains" : (analysis.forest ? ", forest" : ""))
+     << (!analysis.forest && analysis.freeForest ? ", acyclic free nodes" : "");
+
+  return os;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+#define INSTANTIATE(Real)						\
+  template ModelAnalysis::ModelAnalysis(const BasicSMatrix<Real> &stiffnessMatrix);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
+} // namespace nsl
+
+/* fin */
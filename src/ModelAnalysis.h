@@ -0,0 +1,78 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ModelAnalysis.h
+
+   Struct: ModelAnalysis
+
+   A cheap structural analysis of the spring graph, done in linear
+   time O(n + m) (n nodes, m springs) after parsing: the size of the
+   reduced system (free degrees of freedom, nonzeros), its bandwidth
+   in the given node numbering, the node degrees, the number of
+   connected components and whether the assemblage is a forest or a
+   set of chains.  The results are used to choose the fastest solver
+   backend (see recommendSolver()).
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __ModelAnalysis__
+#define __ModelAnalysis__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iostream>
+
+#include "SMatrix.h"
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// struct ModelAnalysis
+// ---------------------------------------------------------
+
+struct ModelAnalysis {
+  std::size_t nodes = 0;
+  std::size_t springs = 0;
+  std::size_t constrainedNodes = 0;
+
+  std::size_t dofs = 0;              // Free degrees of freedom (size of the reduced system)
+  std::size_t nnz = 0;               // Nonzeros of the reduced system
+  std::size_t bandwidth = 0;         // Of the reduced system in the given node numbering
+
+  std::size_t maxDegree = 0;         // Number of neighbours of a node
+  double averageDegree = 0;
+  std::vector<std::size_t> degreeHistogram;  // Number of nodes by degree
+
+  std::size_t components = 0;        // Connected components of the spring graph
+  bool forest = false;               // No cycles (parallel springs count as one)
+  bool chains = false;               // Forest with no node of degree > 2
+  bool freeForest = false;           // No cycles between the free nodes (reduced system)
+
+  double stiffnessSpread = 1;        // Largest / smallest spring constant
+
+  ModelAnalysis();
+  ModelAnalysis(std::size_t numberOfNodes,
+		const std::vector<int> &springNode1,
+		const std::vector<int> &springNode2,
+		const std::vector<bool> &constrained,
+		const std::vector<double> &springConstants = std::vector<double>());
+  template <typename Real>
+  ModelAnalysis(const BasicSMatrix<Real> &stiffnessMatrix);
+
+  LinearSolver::Type recommendSolver(std::string &reason) const;
+
+  friend std::ostream& operator<<(std::ostream& os, const ModelAnalysis& analysis);
+};
+
+} // namespace nsl
+
+#endif /* defined(__ModelAnalysis__) */
+
+/* fin */
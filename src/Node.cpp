@@ -4,7 +4,7 @@
    
    DMatrix.h
    
-   Class: Node
+   Class: BasicNode
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -19,13 +19,15 @@
 namespace nsl {
 
 // =========================================================
-// Class Node
+// Class BasicNode
 // ---------------------------------------------------------
 
-Node::Node(const int index, const int id)
+template <typename Real>
+BasicNode<Real>::BasicNode(const int index, const int id)
   : _index(index), _id(id), _force(0.0) {}
 
-Node::~Node() {}
+template <typename Real>
+BasicNode<Real>::~BasicNode() {}
 
 // =========================================================
 // Accessors
@@ -34,7 +36,8 @@ Node::~Node() {}
 /**
    Get index.
 */
-int Node::getIndex() const 
+template <typename Real>
+int BasicNode<Real>::getIndex() const 
 {
   return _index;
 }
@@ -42,7 +45,8 @@ int Node::getIndex() const
 /**
    Get ID.
 */
-int Node::getID() const 
+template <typename Real>
+int BasicNode<Real>::getID() const 
 {
   return _id;
 }
@@ -50,7 +54,8 @@ int Node::getID() const
 /**
    Get displacement.
 */
-FDouble Node::getDisplacement() const 
+template <typename Real>
+BasicFValue<Real> BasicNode<Real>::getDisplacement() const 
 {
   return _displacement;
 }
@@ -58,7 +63,8 @@ FDouble Node::getDisplacement() const
 /**
    Get force.
 */
-double Node::getForce() const 
+template <typename Real>
+Real BasicNode<Real>::getForce() const 
 {
   return _force;
 }
@@ -70,7 +76,8 @@ double Node::getForce() const
 /**
    Add a displacement.
 */
-void Node::addDisplacement(const double displacement) 
+template <typename Real>
+void BasicNode<Real>::addDisplacement(const Real displacement) 
 {
   _displacement.set(displacement);
 }
@@ -78,7 +85,8 @@ void Node::addDisplacement(const double displacement)
 /**
    Add a force.
 */
-void Node::addForce(const double force)
+template <typename Real>
+void BasicNode<Real>::addForce(const Real force)
 {
   _force = force;
 }
@@ -87,7 +95,8 @@ void Node::addForce(const double force)
 // Friends
 // ---------------------------------------------------------
 
-std::ostream& operator<<(std::ostream& os, const Node& node)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicNode<Real>& node)
 {
   os << "node " << node._id;
   if (node._displacement.isDefined()) os << "  d " << node._displacement.getValue();
@@ -96,6 +105,17 @@ std::ostream& operator<<(std::ostream& os, const Node& node)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicNode)
+
+#define INSTANTIATE(Real)						\
+  template std::ostream& operator<<(std::ostream& os, const BasicNode<Real>& node);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
@@ -4,7 +4,7 @@
 
    Node.h
    
-   Class: Node
+   Class: BasicNode, Node
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -21,35 +21,43 @@
 
 namespace nsl {
 
+template <typename Real> class BasicNode;
+
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicNode<Real>& node);
+
 /**
-   Class Node
+   Class BasicNode
 */
-class Node
+template <typename Real>
+class BasicNode
 {
 private:
   int _index; // for internal use
   int _id;    // for external use
-  FDouble _displacement;
-  double _force;
+  BasicFValue<Real> _displacement;
+  Real _force;
 
 public:
-  Node(const int index, const int id);
-  ~Node();
+  BasicNode(const int index, const int id);
+  ~BasicNode();
 
   // Accessors
   int getIndex() const;
   int getID() const;
-  FDouble getDisplacement() const;
-  double getForce() const;
+  BasicFValue<Real> getDisplacement() const;
+  Real getForce() const;
   
   // Methods
-  void addDisplacement(const double displacement);
-  void addForce(const double force);
+  void addDisplacement(const Real displacement);
+  void addForce(const Real force);
 
   // Friends  
-  friend std::ostream& operator<<(std::ostream& os, const Node& node);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicNode& node);
 };
 
+typedef BasicNode<double> Node;
+
 } // namespace nsl
 
 #endif /* defined(__Node__) */
@@ -0,0 +1,248 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   PMatrix.cpp
+
+   Class: BasicPackedMatrix
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cassert>
+#include <cmath>
+#include <sstream>
+
+#include "Profiler.h"
+#include "MemoryTracker.h"
+#include "DVector.h"
+#include "DMatrix.h"
+#include "PMatrix.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   Warn when a packed matrix of the given size
+   would exceed the memory budget.
+*/
+template <typename Real>
+void checkMemoryBudget(std::size_t n)
+{
+  if (MemoryTracker::budget() == 0) return;
+
+  std::ostringstream what;
+  what << "a packed symmetric " << n << " x " << n << " matrix";
+  MemoryTracker::checkBudget(std::uint64_t(n) * (n + 1) / 2 * sizeof(Real), what.str().c_str());
+}
+
+} // namespace
+
+/**
+    Constructor: an n x n zero matrix.
+*/
+template <typename Real>
+BasicPackedMatrix<Real>::BasicPackedMatrix(std::size_t n)
+  : _n(n)
+{
+  checkMemoryBudget<Real>(n);
+
+  _v.assign(n * (n + 1) / 2, 0.0);
+  Profiler::countAllocation(_v.size() * sizeof(Real));
+}
+
+/**
+   Number of columns.
+*/
+template <typename Real>
+std::size_t BasicPackedMatrix<Real>::cols() const
+{
+  return _n;
+}
+
+/**
+   Number of rows.
+*/
+template <typename Real>
+std::size_t BasicPackedMatrix<Real>::rows() const
+{
+  return _n;
+}
+
+/**
+   The packed upper triangle.
+*/
+template <typename Real>
+const std::vector<Real> &BasicPackedMatrix<Real>::values() const
+{
+  return _v;
+}
+
+/**
+   Convert to a dense matrix (both triangles).
+*/
+template <typename Real>
+BasicMatrix<Real> BasicPackedMatrix<Real>::toDense() const
+{
+  BasicMatrix<Real> m(_n, _n);
+  for (std::size_t i = 0; i < _n; ++i)
+    for (std::size_t j = i; j < _n; ++j)
+      m(i, j) = m(j, i) = _v[index(i, j)];
+
+  return m;
+}
+
+/**
+   Gaussian elimination in place, without pivoting (the stiffness
+   matrices are positive definite).
+
+   Eliminating column k subtracts m(k, r) = a(k, r) / a(k, k) times
+   row k from every row r > k.  Only the elements (r, c), c >= r, are
+   updated: the lower triangle stays the transpose of the upper one.
+   The eliminated matrix U (A = U^T D^-1 U, D the diagonal of U) is
+   left in place; both row k and row r are contiguous.  The
+   arithmetic is the same as the one of
+   DMatrix::gaussianElimination() on the upper triangle.
+
+   Returns false when the matrix is not positive definite; pivot and
+   value are then the failing row and its diagonal value.
+*/
+template <typename Real>
+bool BasicPackedMatrix<Real>::eliminate(std::size_t &pivot, Real &value)
+{
+  std::uint64_t flops = 0;
+  for (std::size_t k = 0; k < _n; ++k)
+    {
+      const Real *rowK = &_v[index(k, k)];
+      if (!(rowK[0] > 0))
+	{
+	  Profiler::countFlops(flops);
+	  pivot = k;
+	  value = rowK[0];
+	  return false;
+	}
+
+      for (std::size_t r = k + 1; r < _n; ++r)
+	{
+	  Real m = rowK[r - k] / rowK[0];
+	  if (m == 0) continue;
+
+	  Real *rowR = &_v[index(r, r)];
+	  for (std::size_t c = r; c < _n; ++c)
+	    rowR[c - r] -= m * rowK[c - k];
+	  flops += 2 * (_n - r) + 1;
+	}
+    }
+  Profiler::countFlops(flops);
+
+  return true;
+}
+
+/**
+   Solve A x = b with the matrix calculated by eliminate(): the
+   elimination steps are repeated on b (the multipliers are
+   recalculated from the rows of U), then U x = y is solved by back
+   substitution.
+*/
+template <typename Real>
+BasicVector<Real> BasicPackedMatrix<Real>::eliminateSolve(const BasicVector<Real> &b) const
+{
+  assert(b.size() == _n);
+
+  BasicVector<Real> x(_n);
+  const Real *bb = b.span().data();
+  std::vector<Real> y(bb, bb + _n);
+
+  // U^T D^-1 y = b
+  for (std::size_t k = 0; k < _n; ++k)
+    {
+      const Real *rowK = &_v[index(k, k)];
+      if (y[k] == 0) continue;
+      for (std::size_t r = k + 1; r < _n; ++r)
+	y[r] -= rowK[r - k] / rowK[0] * y[k];
+    }
+
+  // U x = y
+  Real *xx = x.span().data();
+  for (std::size_t i = _n; i-- > 0; )
+    {
+      const Real *rowI = &_v[index(i, i)];
+      Real s = y[i];
+      for (std::size_t j = i + 1; j < _n; ++j)
+	s -= rowI[j - i] * xx[j];
+      xx[i] = s / rowI[0];
+    }
+
+  Profiler::countFlops(std::uint64_t(_n) * (2 * _n + 1));
+
+  return x;
+}
+
+/**
+   Multiplication operator: PMatrix * DVector -> DVector
+
+   Every stored off-diagonal element contributes to two rows.
+*/
+template <typename Real>
+BasicVector<Real> operator* (const BasicPackedMatrix<Real> &m, const BasicVector<Real> &v)
+{
+  assert(m.cols() == v.size());
+
+  std::size_t n = m._n;
+  const Real *vv = v.span().data();
+  std::vector<Real> r(n, 0.0);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      const Real *ai = &m._v[m.index(i, i)];
+      Real s = ai[0] * vv[i];
+      for (std::size_t j = i + 1; j < n; ++j)
+	{
+	  s += ai[j - i] * vv[j];
+	  r[j] += ai[j - i] * vv[i];
+	}
+      r[i] += s;
+    }
+
+  Profiler::countFlops(2 * std::uint64_t(n) * n);
+
+  return BasicVector<Real>(r);
+}
+
+/**
+      os <<
+*/
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicPackedMatrix<Real>& m)
+{
+  for (std::size_t row = 0; row < m._n; ++row)
+    {
+      for (std::size_t col = 0; col < m._n; ++col)
+	{
+	  if (col > 0) os << " ";
+	  os << m(row, col);
+	}
+      os << std::endl;
+    }
+
+  return os;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicPackedMatrix)
+
+#define INSTANTIATE(Real)						\
+  template BasicVector<Real> operator* (const BasicPackedMatrix<Real> &m, const BasicVector<Real> &v); \
+  template std::ostream& operator<<(std::ostream& os, const BasicPackedMatrix<Real>& m);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
+} // namespace nsl
+
+/* fin */
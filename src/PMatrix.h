@@ -0,0 +1,127 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   PMatrix.h
+
+   Class: BasicPackedMatrix, PMatrix
+
+   Symmetric dense matrix in packed storage: only the upper triangle
+   is stored, row by row, so that row i (the elements (i, i) ...
+   (i, n - 1)) is contiguous.  Needs half the memory of a DMatrix;
+   A(i, j) and A(j, i) are the same element.
+
+   eliminate() runs Gaussian elimination on the upper triangle only:
+   for a symmetric matrix the eliminated lower triangle is the
+   transpose of the upper one, so that half of the work and memory
+   suffice.  eliminateSolve() then solves the system by forward and
+   back substitution with the eliminated matrix.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __PMatrix__
+#define __PMatrix__
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "Access.h"
+#include "DVector.h"
+#include "DMatrix.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicPackedMatrix
+// ---------------------------------------------------------
+
+template <typename Real> class BasicPackedMatrix;
+
+template <typename Real>
+BasicVector<Real> operator* (const BasicPackedMatrix<Real> &m, const BasicVector<Real> &v);
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicPackedMatrix<Real>& m);
+
+template <typename Real>
+class BasicPackedMatrix {
+
+  std::size_t _n;
+
+  // A(i, j), i <= j, is stored at _v[index(i, j)]
+  std::vector<Real> _v;
+
+ public:
+
+  BasicPackedMatrix(std::size_t n = 0);
+
+  std::size_t cols() const;
+  std::size_t rows() const;
+
+  Real &operator() (std::size_t row, std::size_t column);
+  Real operator() (std::size_t row, std::size_t column) const;
+
+  const std::vector<Real> &values() const;
+
+  BasicMatrix<Real> toDense() const;
+
+  bool eliminate(std::size_t &pivot, Real &value);
+  BasicVector<Real> eliminateSolve(const BasicVector<Real> &b) const;
+
+  friend BasicVector<Real> operator* <>(const BasicPackedMatrix &m, const BasicVector<Real> &v);
+
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicPackedMatrix& m);
+
+ private:
+  std::size_t index(std::size_t i, std::size_t j) const;
+};
+
+typedef BasicPackedMatrix<double> PMatrix;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   Position of the element (i, j), i <= j: row i starts after the
+   rows 0 ... i - 1 with n, n - 1, ... n - i + 1 elements.
+*/
+template <typename Real>
+inline std::size_t BasicPackedMatrix<Real>::index(std::size_t i, std::size_t j) const
+{
+  return i * (2 * _n - i + 1) / 2 + j - i;
+}
+
+/**
+   Element accessor: (row, column) and (column, row) are the same element.
+*/
+template <typename Real>
+inline Real &BasicPackedMatrix<Real>::operator() (std::size_t row, std::size_t col)
+{
+  NSL_CHECK_ACCESS(row < _n);
+  NSL_CHECK_ACCESS(col < _n);
+
+  return row <= col ? _v[index(row, col)] : _v[index(col, row)];
+}
+
+/**
+   Constant element accessor.
+*/
+template <typename Real>
+inline Real BasicPackedMatrix<Real>::operator() (std::size_t row, std::size_t col) const
+{
+  NSL_CHECK_ACCESS(row < _n);
+  NSL_CHECK_ACCESS(col < _n);
+
+  return row <= col ? _v[index(row, col)] : _v[index(col, row)];
+}
+
+} // namespace nsl
+
+#endif /* defined(__PMatrix__) */
+
+/* fin */
@@ -4,7 +4,7 @@
    
    Parser.cpp
 
-   Class: Parser
+   Class: BasicParser
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -17,22 +17,25 @@
 #include <vector>
 #include <string>
 
+#include "Profiler.h"
 #include "FEM.h"
 #include "Parser.h"
 
 namespace nsl {
 
 // =========================================================
-// Class Parser
+// Class BasicParser
 // ---------------------------------------------------------
 
-Parser::Parser(FEM *fgfem, const std::vector<std::string> &files) : _in(nullptr)
+template <typename Real>
+BasicParser<Real>::BasicParser(BasicFEM<Real> *fgfem, const std::vector<std::string> &files) : _in(nullptr)
 {
   _fgfem = fgfem;
   _files = new std::vector<std::string>(files);
 }
 
-Parser::~Parser() 
+template <typename Real>
+BasicParser<Real>::~BasicParser() 
 {
   delete _files;
 }
@@ -44,8 +47,11 @@ Parser::~Parser()
 /**
    Parse a FEM definition file.
 */
-void Parser::parse() 
+template <typename Real>
+void BasicParser<Real>::parse() 
 {
+  ScopedTimer timer("parse");
+
   // Print message
   std::cout << "Input files: " << std::endl << std::endl;
 
@@ -81,7 +87,8 @@ void Parser::parse()
 /**
    Open the FEM definition file.
 */
-void Parser::open(const std::string &file) 
+template <typename Real>
+void BasicParser<Real>::open(const std::string &file) 
 {
   // Open the ifstream  
   _in = new std::ifstream(file, std::ios_base::in);
@@ -96,7 +103,8 @@ void Parser::open(const std::string &file)
 /**
    Close the FEM definition file.
 */
-void Parser::close()
+template <typename Real>
+void BasicParser<Real>::close()
 {
   _in->close();
   delete _in;
@@ -106,7 +114,8 @@ void Parser::close()
 /**
    Get the next token.
 */
-void Parser::getNextToken()
+template <typename Real>
+void BasicParser<Real>::getNextToken()
 {
   if (_in->eof())
     _token = "eof";
@@ -120,7 +129,8 @@ void Parser::getNextToken()
 /**
    Get the next character.
 */
-int Parser::getNextChar()
+template <typename Real>
+int BasicParser<Real>::getNextChar()
 {
   int c;
   if (_in->eof())
@@ -137,7 +147,8 @@ int Parser::getNextChar()
 /**
    Parse an integer.
 */
-int Parser::parseInt()
+template <typename Real>
+int BasicParser<Real>::parseInt()
 {
   int i;
   if (*_in >> i) 
@@ -150,11 +161,12 @@ int Parser::parseInt()
 }
 
 /**
-   Parse a double.
+   Parse a number.
 */
-double Parser::parseDouble()
+template <typename Real>
+Real BasicParser<Real>::parseReal()
 {
-  double d;
+  Real d;
   if (*_in >> d) 
     return d;
   else
@@ -167,7 +179,8 @@ double Parser::parseDouble()
 /**
    Parse a multiline comment
 */
-void Parser::parseSinglelineComment()
+template <typename Real>
+void BasicParser<Real>::parseSinglelineComment()
 {
   // Skip the rest of the line
   int c;
@@ -182,7 +195,8 @@ void Parser::parseSinglelineComment()
 /**
    Parse a multiline comment
 */
-void Parser::parseMultilineComment()
+template <typename Real>
+void BasicParser<Real>::parseMultilineComment()
 {
   // Skip characters until next "*/"
   int c1, c2;
@@ -201,7 +215,8 @@ void Parser::parseMultilineComment()
 /**
    Parse a node definition.
 */
-void Parser::parseNode()
+template <typename Real>
+void BasicParser<Real>::parseNode()
 {
   // Parse node id
   int id = parseInt();
@@ -215,12 +230,12 @@ void Parser::parseNode()
     {
       if (_token == "d")
 	{
-	  double displacement = parseDouble();
+	  Real displacement = parseReal();
 	  _fgfem->addDisplacement(id, displacement);
 	}
       else // _token == "f"
 	{
-	  double force = parseDouble();
+	  Real force = parseReal();
 	  _fgfem->addForce(id, force);
 	}
 
@@ -232,7 +247,8 @@ void Parser::parseNode()
 /**
    Parse a spring definition.
 */
-void Parser::parseSpring()
+template <typename Real>
+void BasicParser<Real>::parseSpring()
 {
   // Parse spring id
   int id = parseInt();
@@ -242,7 +258,7 @@ void Parser::parseSpring()
   int node2 = parseInt();
   
   // Parse spring constant
-  double springConstant = parseDouble();
+  Real springConstant = parseReal();
   
   // Add the spring
   _fgfem->addSpring(id, node1, node2, springConstant);
@@ -251,6 +267,12 @@ void Parser::parseSpring()
   getNextToken();
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicParser)
+
 } // namespace nsl
 
 /* fin */
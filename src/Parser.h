@@ -4,7 +4,7 @@
    
    Parser.h
 
-   Class: Parser
+   Class: BasicParser, Parser
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -22,23 +22,24 @@
 namespace nsl {
 
 // =========================================================
-// class Parser
+// class BasicParser
 // ---------------------------------------------------------
 
-class FEM;
+template <typename Real> class BasicFEM;
 
-class Parser {
+template <typename Real>
+class BasicParser {
 
 private:
-  FEM *_fgfem;
+  BasicFEM<Real> *_fgfem;
   std::vector<std::string> *_files;
   
   std::ifstream *_in;
   std::string _token;
 
 public:
-  Parser(FEM *fgfem, const std::vector<std::string> &files);
-  ~Parser();
+  BasicParser(BasicFEM<Real> *fgfem, const std::vector<std::string> &files);
+  ~BasicParser();
 
   void parse();
 
@@ -48,13 +49,15 @@ private:
   void getNextToken();
   int getNextChar();
   int parseInt();
-  double parseDouble();
+  Real parseReal();
   void parseSinglelineComment();
   void parseMultilineComment();
   void parseNode();
   void parseSpring();
 };
 
+typedef BasicParser<double> Parser;
+
 } // namespace nsl
 
 #endif /* defined(__Parser__) */
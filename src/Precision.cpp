@@ -0,0 +1,54 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Precision.cpp
+
+   Class: Precision
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include "Precision.h"
+
+namespace nsl {
+
+namespace {
+
+const char *typeNames[] = { "float", "double", "long-double" };
+
+} // namespace
+
+// =========================================================
+// Class Precision
+// ---------------------------------------------------------
+
+/**
+   Name of a precision as used by the --precision option.
+*/
+const char *Precision::typeName(Type type)
+{
+  return typeNames[type];
+}
+
+/**
+   Parse a precision name.  Returns false for an unknown name.
+*/
+bool Precision::parseType(const std::string &name, Type &type)
+{
+  for (int t = FLOAT; t <= LONG_DOUBLE; ++t)
+    if (name == typeNames[t])
+      {
+	type = (Type) t;
+	return true;
+      }
+
+  return false;
+}
+
+} // namespace nsl
+
+/* fin */
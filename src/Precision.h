@@ -0,0 +1,90 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   Precision.h
+
+   Class: Precision
+
+   The floating point types the numerics are instantiated for:
+
+     float        Single precision: half the memory and memory
+                  traffic of double, for large batches of models
+     double       Double precision (default)
+     long double  Extended precision (80 bit on x86) for
+                  ill-conditioned stiffness matrices
+
+   The vectors, matrices, model and solvers are class templates on
+   the scalar type (BasicVector<Real>, ..., BasicFEM<Real>), with the
+   double instantiations under their usual names (DVector, ..., FEM).
+   The templates are defined in the .cpp files and explicitly
+   instantiated there for the three types (NSL_INSTANTIATE()).  The
+   precision is chosen once at the top (--precision): the kernels
+   are compiled for each type and run without any run-time dispatch.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Precision__
+#define __Precision__
+
+#include <string>
+#include <limits>
+#include <algorithm>
+
+/**
+   Apply the macro M to each of the supported scalar types.
+*/
+#define NSL_FOR_EACH_REAL(M) M(float) M(double) M(long double)
+
+/**
+   Explicitly instantiate the class template C for each scalar type.
+*/
+#define NSL_INSTANTIATE(C)			\
+  template class C<float>;			\
+  template class C<double>;			\
+  template class C<long double>;
+
+namespace nsl {
+
+// =========================================================
+// class Precision
+// ---------------------------------------------------------
+
+class Precision {
+
+ public:
+  enum Type {
+    FLOAT = 0,
+    DOUBLE,
+    LONG_DOUBLE
+  };
+
+  static const char *typeName(Type type);
+  static bool parseType(const std::string &name, Type &type);
+
+  template <typename Real> static double iterativeTolerance();
+};
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   Default relative residual of the iterative solvers: 1e-12, but
+   not below what can be reached in the precision (100 eps).
+*/
+template <typename Real>
+inline double Precision::iterativeTolerance()
+{
+  return std::max(1e-12, 100 * double(std::numeric_limits<Real>::epsilon()));
+}
+
+} // namespace nsl
+
+#endif /* defined(__Precision__) */
+
+/* fin */
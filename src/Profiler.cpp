@@ -0,0 +1,278 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Profiler.cpp
+
+   Class: Profiler, ScopedTimer
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <iomanip>
+
+#include "Trace.h"
+#include "MemoryTracker.h"
+#include "Profiler.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   Accumulated data of a phase.
+*/
+struct Phase {
+  std::string name;
+  std::size_t calls;
+  double seconds;
+  std::uint64_t counters[Profiler::NUMBER_OF_COUNTERS];
+  std::uint64_t peakBytes;
+};
+
+// The phases in the order in which they have been entered first
+std::vector<Phase> phases;
+std::mutex phasesMutex;
+
+const char *counterNames[Profiler::NUMBER_OF_COUNTERS] = {
+  "allocations",
+  "bytes",
+  "flops",
+  "heap_allocations",
+  "heap_bytes"
+};
+
+/**
+   Number of counters to report: the heap counters
+   are only shown when the heap is tracked.
+*/
+int reportedCounters()
+{
+  return MemoryTracker::enabled() ? Profiler::NUMBER_OF_COUNTERS : Profiler::HEAP_ALLOCATIONS;
+}
+
+} // namespace
+
+// =========================================================
+// Class Profiler
+// ---------------------------------------------------------
+
+bool Profiler::_enabled = false;
+std::atomic<std::uint64_t> Profiler::_counters[Profiler::NUMBER_OF_COUNTERS];
+
+/**
+   Switch profiling on.
+*/
+void Profiler::enable()
+{
+  _enabled = true;
+}
+
+/**
+   Current value of a counter.
+*/
+std::uint64_t Profiler::counter(Counter counter)
+{
+  return _counters[counter].load(std::memory_order_relaxed);
+}
+
+/**
+   Add a measurement to the phase with the given name.
+*/
+void Profiler::addPhase(const char *name, double seconds, const std::uint64_t *counters,
+			std::uint64_t peakBytes)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  Phase *phase = nullptr;
+  for (auto &p : phases)
+    if (p.name == name) 
+      phase = &p;
+
+  if (!phase)
+    {
+      phases.push_back(Phase());
+      phase = &phases.back();
+      phase->name = name;
+      phase->calls = 0;
+      phase->seconds = 0;
+      phase->peakBytes = 0;
+      for (int c = 0; c < NUMBER_OF_COUNTERS; ++c) phase->counters[c] = 0;
+    }
+
+  phase->calls   += 1;
+  phase->seconds += seconds;
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c) 
+    phase->counters[c] += counters[c];
+  if (peakBytes > phase->peakBytes)
+    phase->peakBytes = peakBytes;
+}
+
+/**
+   Accumulated time of the phase with the given name 
+   (0 when the phase has not been run).
+*/
+double Profiler::phaseSeconds(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  for (const auto &phase : phases)
+    if (phase.name == name)
+      return phase.seconds;
+
+  return 0;
+}
+
+/**
+   Accumulated counter of the phase with the given name 
+   (0 when the phase has not been run).
+*/
+std::uint64_t Profiler::phaseCounter(const std::string &name, Counter counter)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  for (const auto &phase : phases)
+    if (phase.name == name)
+      return phase.counters[counter];
+
+  return 0;
+}
+
+/**
+   Largest number of bytes allocated at the same time while the phase 
+   with the given name was running (0 when the heap is not tracked).
+*/
+std::uint64_t Profiler::phasePeakBytes(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  for (const auto &phase : phases)
+    if (phase.name == name)
+      return phase.peakBytes;
+
+  return 0;
+}
+
+/**
+   Forget all phases and reset the counters.
+*/
+void Profiler::reset()
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  phases.clear();
+  for (int c = 0; c < NUMBER_OF_COUNTERS; ++c) 
+    _counters[c] = 0;
+}
+
+/**
+   Print the phases as a table.
+*/
+void Profiler::printTable(std::ostream &os)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  os << "Profile:" << std::endl << std::endl;
+  os << "  " 
+     << std::left  << std::setw(24) << "phase"
+     << std::right << std::setw(7)  << "calls"
+     << std::setw(14) << "time [ms]";
+  for (int c = 0; c < reportedCounters(); ++c)
+    os << std::setw(18) << counterNames[c];
+  if (MemoryTracker::enabled())
+    os << std::setw(18) << "peak_bytes";
+  os << std::endl;
+
+  for (const auto &phase : phases)
+    {
+      os << "  " 
+	 << std::left  << std::setw(24) << phase.name
+	 << std::right << std::setw(7)  << phase.calls
+	 << std::setw(14) << std::fixed << std::setprecision(3) << 1e3 * phase.seconds;
+      os.unsetf(std::ios_base::floatfield);
+      for (int c = 0; c < reportedCounters(); ++c)
+	os << std::setw(18) << phase.counters[c];
+      if (MemoryTracker::enabled())
+	os << std::setw(18) << phase.peakBytes;
+      os << std::endl;
+    }
+  os << std::endl;
+
+  if (MemoryTracker::enabled())
+    os << "  Peak heap usage: " << MemoryTracker::peak() << " bytes" << std::endl << std::endl;
+}
+
+/**
+   Write the phases as JSON.
+*/
+void Profiler::writeJSON(std::ostream &os)
+{
+  std::lock_guard<std::mutex> lock(phasesMutex);
+
+  os << "{" << std::endl
+     << "  \"phases\": [";
+  for (std::size_t i = 0; i < phases.size(); ++i)
+    {
+      const Phase &phase = phases[i];
+      
+      os << (i > 0 ? "," : "") << std::endl
+	 << "    { \"name\": \"" << phase.name << "\""
+	 << ", \"calls\": " << phase.calls
+	 << ", \"seconds\": " << std::setprecision(9) << phase.seconds;
+      for (int c = 0; c < reportedCounters(); ++c)
+	os << ", \"" << counterNames[c] << "\": " << phase.counters[c];
+      if (MemoryTracker::enabled())
+	os << ", \"peak_bytes\": " << phase.peakBytes;
+      os << " }";
+    }
+  os << std::endl 
+     << "  ]";
+  if (MemoryTracker::enabled())
+    os << "," << std::endl
+       << "  \"peak_bytes\": " << MemoryTracker::peak();
+  os << std::endl
+     << "}" << std::endl;
+}
+
+// =========================================================
+// Class ScopedTimer
+// ---------------------------------------------------------
+
+ScopedTimer::ScopedTimer(const char *name)
+  : _name(name), _active(Profiler::enabled()), _traced(Trace::enabled()),
+    _tracked(MemoryTracker::enabled()), _outerPeak(0)
+{
+  if (_traced) Trace::begin(_name);
+  if (!_active) return;
+
+  if (_tracked) _outerPeak = MemoryTracker::beginPeak();
+
+  for (int c = 0; c < Profiler::NUMBER_OF_COUNTERS; ++c)
+    _counters[c] = Profiler::counter((Profiler::Counter) c);
+  _start = std::chrono::steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+  if (_traced) Trace::end(_name);
+  if (!_active) return;
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start;
+
+  for (int c = 0; c < Profiler::NUMBER_OF_COUNTERS; ++c)
+    _counters[c] = Profiler::counter((Profiler::Counter) c) - _counters[c];
+
+  std::uint64_t peakBytes = _tracked ? MemoryTracker::endPeak(_outerPeak) : 0;
+
+  Profiler::addPhase(_name, elapsed.count(), _counters, peakBytes);
+}
+
+} // namespace nsl
+
+/* fin */
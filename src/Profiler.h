@@ -0,0 +1,168 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Profiler.h
+
+   Class: Profiler, ScopedTimer
+
+   Phase timers and counters (allocations, bytes, floating point
+   operations).  Profiling is switched off by default; while it is
+   off a timer or counter costs a single test of a flag.
+
+   Usage:
+
+     Profiler::enable();
+     ...
+     {
+       ScopedTimer timer("assemble");
+       ...
+       Profiler::countFlops(2 * n);
+     }
+     ...
+     Profiler::printTable(std::cout);
+     Profiler::writeJSON(out);
+
+   The counters accumulated while a timer is running are attributed
+   to its phase.  Phases can be nested; times and counters of the
+   outer phase include those of the inner phases.
+
+   When tracing is switched on (see Trace.h) a ScopedTimer also
+   records the begin and end events of its phase.
+
+   When the heap is tracked (see MemoryTracker.h) all allocations
+   are counted in HEAP_ALLOCATIONS and HEAP_BYTES and the peak of
+   the allocated bytes is recorded for each phase.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Profiler__
+#define __Profiler__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <iostream>
+#include <atomic>
+#include <chrono>
+
+namespace nsl {
+
+// =========================================================
+// class Profiler
+// ---------------------------------------------------------
+
+class Profiler {
+
+ public:
+
+  enum Counter {
+    ALLOCATIONS = 0,
+    BYTES,
+    FLOPS,
+    HEAP_ALLOCATIONS,
+    HEAP_BYTES,
+    NUMBER_OF_COUNTERS
+  };
+  
+ private:
+  static bool _enabled;
+  static std::atomic<std::uint64_t> _counters[NUMBER_OF_COUNTERS];
+
+ public:
+  static void enable();
+  static bool enabled();
+
+  static void count(Counter counter, std::uint64_t amount);
+  static void countAllocation(std::size_t bytes);
+  static void countFlops(std::uint64_t flops);
+  static std::uint64_t counter(Counter counter);
+
+  static void addPhase(const char *name, double seconds, const std::uint64_t *counters,
+		       std::uint64_t peakBytes = 0);
+  static double phaseSeconds(const std::string &name);
+  static std::uint64_t phaseCounter(const std::string &name, Counter counter);
+  static std::uint64_t phasePeakBytes(const std::string &name);
+  static void reset();
+
+  static void printTable(std::ostream &os);
+  static void writeJSON(std::ostream &os);
+};
+
+// =========================================================
+// class ScopedTimer
+// ---------------------------------------------------------
+
+/**
+   Measures the time and counters between its construction and
+   destruction and adds them to the phase with the given name.
+*/
+class ScopedTimer {
+
+  const char *_name;
+  bool _active;
+  bool _traced;
+  bool _tracked;
+  std::uint64_t _outerPeak;
+  std::chrono::steady_clock::time_point _start;
+  std::uint64_t _counters[Profiler::NUMBER_OF_COUNTERS];
+  
+ public:
+  ScopedTimer(const char *name);
+  ~ScopedTimer();
+
+ private:
+  ScopedTimer(const ScopedTimer &);
+  ScopedTimer &operator= (const ScopedTimer &);
+};
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   True when profiling is switched on.
+*/
+inline bool Profiler::enabled()
+{
+  return _enabled;
+}
+
+/**
+   Increment a counter.
+*/
+inline void Profiler::count(Counter counter, std::uint64_t amount)
+{
+  if (_enabled)
+    _counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+/**
+   Count an allocation of the given size.
+*/
+inline void Profiler::countAllocation(std::size_t bytes)
+{
+  if (_enabled)
+    {
+      _counters[ALLOCATIONS].fetch_add(1, std::memory_order_relaxed);
+      _counters[BYTES].fetch_add(bytes, std::memory_order_relaxed);
+    }
+}
+
+/**
+   Count floating point operations.
+*/
+inline void Profiler::countFlops(std::uint64_t flops)
+{
+  count(FLOPS, flops);
+}
+
+} // namespace nsl
+
+#endif /* defined(__Profiler__) */
+
+/* fin */
@@ -0,0 +1,130 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Random.cpp
+
+   Class: Random
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+
+#include "Random.h"
+
+namespace nsl {
+
+// =========================================================
+// Class Random
+// ---------------------------------------------------------
+
+/**
+   Constructor: the stream `stream' of the seed `seed'.
+*/
+Random::Random(std::uint64_t seed, std::uint64_t stream)
+  : _stream(stream)
+{
+  _key[0] = std::uint32_t(seed);
+  _key[1] = std::uint32_t(seed >> 32);
+}
+
+/**
+   The Philox4x32-10 bijection: encrypt the counter with the key, in place.
+*/
+void Random::philox(const std::uint32_t key[2], std::uint32_t counter[4])
+{
+  const std::uint64_t m0 = 0xD2511F53, m1 = 0xCD9E8D57;
+  const std::uint32_t w0 = 0x9E3779B9, w1 = 0xBB67AE85;
+
+  std::uint32_t k0 = key[0], k1 = key[1];
+  std::uint32_t *c = counter;
+  for (int round = 0; round < 10; ++round)
+    {
+      std::uint64_t p0 = m0 * c[0];
+      std::uint64_t p1 = m1 * c[2];
+      std::uint32_t c0 = std::uint32_t(p1 >> 32) ^ c[1] ^ k0;
+      std::uint32_t c2 = std::uint32_t(p0 >> 32) ^ c[3] ^ k1;
+      c[0] = c0;
+      c[1] = std::uint32_t(p1);
+      c[2] = c2;
+      c[3] = std::uint32_t(p0);
+      k0 += w0;
+      k1 += w1;
+    }
+}
+
+/**
+   The next 32 random bits.
+*/
+std::uint32_t Random::next()
+{
+  if (_used == 4)
+    {
+      _block[0] = std::uint32_t(_counter);
+      _block[1] = std::uint32_t(_counter >> 32);
+      _block[2] = std::uint32_t(_stream);
+      _block[3] = std::uint32_t(_stream >> 32);
+      philox(_key, _block);
+      ++_counter;
+      _used = 0;
+    }
+
+  return _block[_used++];
+}
+
+/**
+   Uniformly distributed in (0, 1), with 53 random bits: 
+   0 and 1 do not occur.
+*/
+double Random::uniform()
+{
+  std::uint64_t a = next() >> 5, b = next() >> 6;
+
+  return (double(a * 67108864 + b) + 0.5) / 9007199254740992.0;
+}
+
+/**
+   Standard normally distributed (Box-Muller transform: 
+   two uniform numbers give two independent normal ones).
+*/
+double Random::normal()
+{
+  if (_hasNormal)
+    {
+      _hasNormal = false;
+      return _normal;
+    }
+
+  const double pi = 3.14159265358979323846;
+  double r = std::sqrt(-2 * std::log(uniform()));
+  double phi = 2 * pi * uniform();
+
+  _normal = r * std::sin(phi);
+  _hasNormal = true;
+
+  return r * std::cos(phi);
+}
+
+/**
+   Lognormally distributed with the given mean and coefficient of
+   variation (standard deviation / mean): exp(mu + sigma z) with
+   sigma^2 = log(1 + variation^2) and mu = log(mean) - sigma^2 / 2.
+   Positive for a positive mean; 0 for a mean of 0.
+*/
+double Random::lognormal(double mean, double variation)
+{
+  double z = normal();
+  if (mean == 0) return 0;
+
+  double sigma2 = std::log1p(variation * variation);
+
+  return mean * std::exp(std::sqrt(sigma2) * z - sigma2 / 2);
+}
+
+} // namespace nsl
+
+/* fin */
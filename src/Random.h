@@ -0,0 +1,63 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Random.h
+
+   Class: Random
+
+   Counter-based random numbers: Philox4x32-10 (Salmon et al.,
+   "Parallel random numbers: as easy as 1, 2, 3", SC 2011).  The
+   numbers are a bijective function of a key (the seed) and a
+   counter (the stream and the position in the stream) instead of
+   the successor of a state: stream s of seed k is the same
+   sequence, whichever thread draws it in whichever order.  A thread
+   simply creates the stream of each sample it works on; the streams
+   do not overlap (2^64 blocks of four numbers each).
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Random__
+#define __Random__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace nsl {
+
+// =========================================================
+// class Random
+// ---------------------------------------------------------
+
+class Random {
+
+  std::uint32_t _key[2];
+  std::uint64_t _stream;
+  std::uint64_t _counter = 0;  // The next block
+
+  std::uint32_t _block[4];
+  unsigned _used = 4;          // Numbers of the block already drawn
+
+  bool _hasNormal = false;     // The second number of the Box-Muller transform
+  double _normal = 0;
+
+ public:
+  Random(std::uint64_t seed, std::uint64_t stream = 0);
+
+  static void philox(const std::uint32_t key[2], std::uint32_t counter[4]);
+
+  std::uint32_t next();
+  double uniform();
+  double normal();
+  double lognormal(double mean, double variation);
+};
+
+} // namespace nsl
+
+#endif /* defined(__Random__) */
+
+/* fin */
@@ -0,0 +1,274 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   RefinementSolver.cpp
+
+   Class: BasicRefinementSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <limits>
+#include <iostream>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "BandSolver.h"
+#include "SparseSolver.h"
+#include "RefinementSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicRefinementSolver
+// ---------------------------------------------------------
+
+/**
+   True for the solvers which can factorize in single precision.
+*/
+template <typename Real>
+bool BasicRefinementSolver<Real>::refines(LinearSolverBase::Type type)
+{
+  return type == LinearSolverBase::BAND || type == LinearSolverBase::SPARSE;
+}
+
+/**
+   Constructor: `type' is BAND or SPARSE.
+*/
+template <typename Real>
+BasicRefinementSolver<Real>::BasicRefinementSolver(LinearSolverBase::Type type)
+  : _type(type)
+{
+  if (!refines(type))
+    {
+      std::cerr << "ERROR The " << LinearSolverBase::typeName(type) << " solver cannot factorize in single precision!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+}
+
+template <typename Real>
+BasicRefinementSolver<Real>::~BasicRefinementSolver()
+{
+  delete _single;
+  delete _double;
+}
+
+template <typename Real>
+LinearSolverBase::Type BasicRefinementSolver<Real>::type() const
+{
+  return _type;
+}
+
+/**
+   Factorize the upper triangle of a full symmetric matrix.
+*/
+template <typename Real>
+void BasicRefinementSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  _upper = BasicSymmetricSMatrix<Real>(matrix);
+  factorSymmetric(_upper);
+}
+
+/**
+   Factorize the matrix in single precision
+   (in the working precision if that fails).
+*/
+template <typename Real>
+void BasicRefinementSolver<Real>::factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  _matrix = &matrix;
+
+  delete _single;
+  delete _double;
+  _single = nullptr;
+  _double = nullptr;
+
+  // Row sums of |A|: every stored off-diagonal element counts in two rows
+  const BasicSMatrix<Real> &upper = matrix.upper();
+  std::vector<Real> rowSum(matrix.rows(), 0.0);
+  for (std::size_t i = 0; i < upper.rows(); ++i)
+    for (std::size_t k = upper.rowStart()[i]; k < upper.rowStart()[i + 1]; ++k)
+      {
+	Real a = std::fabs(upper.values()[k]);
+	rowSum[i] += a;
+	if (upper.colIndex()[k] != i) rowSum[upper.colIndex()[k]] += a;
+      }
+  _matrixNorm = 0;
+  for (Real s : rowSum)
+    _matrixNorm = std::max(_matrixNorm, double(s));
+
+  bool factorized;
+  if (_type == LinearSolverBase::BAND)
+    {
+      BasicBandSolver<Real> *band = new BasicBandSolver<Real>();
+      band->setSinglePrecision(true);
+      factorized = band->tryFactor(matrix);
+      _single = band;
+    }
+  else
+    {
+      BasicSparseSolver<Real> *sparse = new BasicSparseSolver<Real>();
+      sparse->setSinglePrecision(true);
+      factorized = sparse->tryFactor(matrix);
+      _single = sparse;
+    }
+
+  if (!factorized) fallBack();
+}
+
+/**
+   Replace the single by a working precision factorization.
+*/
+template <typename Real>
+void BasicRefinementSolver<Real>::fallBack() const
+{
+  delete _single;
+  _single = nullptr;
+
+  _double = BasicLinearSolver<Real>::create(_type);
+  _double->factorSymmetric(*_matrix);
+}
+
+/**
+   Solve the system and refine the solution.
+*/
+template <typename Real>
+BasicVector<Real> BasicRefinementSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  std::size_t n = _matrix->rows();
+  std::vector<Real> x(n, 0.0), r(n);
+
+  _iterations = 0;
+  _backwardError = 0;
+
+  if (_single)
+    {
+      ScopedTimer timer("refinement");
+
+      const double tolerance = std::sqrt(double(n)) * std::numeric_limits<Real>::epsilon();
+
+      // The right hand side (and later the residual) is scaled to a
+      // maximum of 1, keeping it in the range of single precision
+      BasicVector<Real> scaled(b);
+      double previous = std::numeric_limits<double>::max();
+      for (;;)
+	{
+	  double scale = 0;
+	  for (std::size_t i = 0; i < n; ++i) scale = std::max(scale, double(std::fabs(scaled(i))));
+	  if (scale == 0) break;
+
+	  for (std::size_t i = 0; i < n; ++i) scaled(i) /= scale;
+	  BasicVector<Real> correction = _single->solve(scaled);
+	  for (std::size_t i = 0; i < n; ++i) x[i] += scale * correction(i);
+
+	  _backwardError = residual(b, x, r);
+	  if (_backwardError <= tolerance) break;
+
+	  // Stagnating or diverging
+	  if (_iterations == _maxIterations || _backwardError >= previous)
+	    {
+	      fallBack();
+	      break;
+	    }
+
+	  previous = _backwardError;
+	  ++_iterations;
+	  for (std::size_t i = 0; i < n; ++i) scaled(i) = r[i];
+	}
+    }
+
+  if (_double)
+    {
+      BasicVector<Real> solution = _double->solve(b);
+      for (std::size_t i = 0; i < n; ++i) x[i] = solution(i);
+      _backwardError = residual(b, x, r);
+    }
+
+  return BasicVector<Real>(x);
+}
+
+/**
+   r = b - A x in the working precision; returns the normwise backward
+   error |r| / (|A| |x| + |b|) (infinity norms).
+*/
+template <typename Real>
+double BasicRefinementSolver<Real>::residual(const BasicVector<Real> &b, const std::vector<Real> &x, std::vector<Real> &r) const
+{
+  const BasicSMatrix<Real> &upper = _matrix->upper();
+  std::size_t n = upper.rows();
+
+  // r = b - A x, scattering the mirrored elements
+  for (std::size_t i = 0; i < n; ++i) r[i] = b(i);
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      Real s = r[i];
+      for (std::size_t k = upper.rowStart()[i]; k < upper.rowStart()[i + 1]; ++k)
+	{
+	  std::size_t j = upper.colIndex()[k];
+	  s -= upper.values()[k] * x[j];
+	  if (j != i) r[j] -= upper.values()[k] * x[i];
+	}
+      r[i] = s;
+    }
+  Profiler::countFlops(4 * upper.nnz());
+
+  Real normR = 0, normX = 0, normB = 0;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      normR = std::max(normR, std::fabs(r[i]));
+      normX = std::max(normX, std::fabs(x[i]));
+      normB = std::max(normB, std::fabs(b(i)));
+    }
+
+  double denominator = _matrixNorm * double(normX) + double(normB);
+  return denominator > 0 ? double(normR) / denominator : 0;
+}
+
+template <typename Real>
+void BasicRefinementSolver<Real>::setMaxIterations(std::size_t iterations)
+{
+  _maxIterations = iterations;
+}
+
+/**
+   Number of refinement steps (corrections after the first solution)
+   of the last solve().
+*/
+template <typename Real>
+std::size_t BasicRefinementSolver<Real>::iterations() const
+{
+  return _iterations;
+}
+
+/**
+   Normwise backward error of the solution of the last solve().
+*/
+template <typename Real>
+double BasicRefinementSolver<Real>::backwardError() const
+{
+  return _backwardError;
+}
+
+/**
+   True when the matrix had to be factorized in the working precision.
+*/
+template <typename Real>
+bool BasicRefinementSolver<Real>::fellBack() const
+{
+  return _double != nullptr;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicRefinementSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,99 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   RefinementSolver.h
+
+   Class: BasicRefinementSolver, RefinementSolver
+
+   Mixed precision solver: the matrix is factorized by the band or
+   sparse solver in single precision, which halves the memory of the
+   factor and the memory traffic of factorization and substitution.
+   The accuracy of the working precision Real (double for
+   RefinementSolver) is recovered by iterative refinement with
+   residuals computed in the working precision against the original
+   matrix:
+
+     x = solve(b),  repeat: r = b - A x,  x += solve(r)
+
+   until the normwise backward error
+
+     |b - A x| / (|A| |x| + |b|)      (infinity norms)
+
+   is below sqrt(n) eps (eps: working precision), as LAPACK's dsgesv.
+   When the single precision factorization fails (the matrix is too
+   ill-conditioned to be positive definite in single precision) or
+   the refinement does not converge within the maximal number of
+   iterations, the matrix is factorized in the working precision
+   instead.
+
+   The matrix is used in half storage (see SymmetricSMatrix.h): a
+   full matrix given to factor() is reduced to its upper triangle.
+   A matrix given to factorSymmetric() has to outlive the solver.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __RefinementSolver__
+#define __RefinementSolver__
+
+#include <vector>
+
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicRefinementSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicRefinementSolver : public BasicLinearSolver<Real> {
+
+  LinearSolverBase::Type _type;
+  const BasicSymmetricSMatrix<Real> *_matrix = nullptr;
+  BasicSymmetricSMatrix<Real> _upper;       // The matrix given to factor()
+  double _matrixNorm = 0;                   // Infinity norm
+
+  // The single precision factorization, replaced by one
+  // in the working precision when the refinement fails
+  mutable BasicLinearSolver<Real> *_single = nullptr;
+  mutable BasicLinearSolver<Real> *_double = nullptr;
+
+  std::size_t _maxIterations = 30;
+
+  mutable std::size_t _iterations = 0;
+  mutable double _backwardError = 0;
+
+ public:
+  static bool refines(LinearSolverBase::Type type);
+
+  BasicRefinementSolver(LinearSolverBase::Type type);
+  ~BasicRefinementSolver();
+
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  void factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+  void setMaxIterations(std::size_t iterations);
+
+  std::size_t iterations() const;
+  double backwardError() const;
+  bool fellBack() const;
+
+ private:
+  void fallBack() const;
+  double residual(const BasicVector<Real> &b, const std::vector<Real> &x, std::vector<Real> &r) const;
+};
+
+typedef BasicRefinementSolver<double> RefinementSolver;
+
+} // namespace nsl
+
+#endif /* defined(__RefinementSolver__) */
+
+/* fin */
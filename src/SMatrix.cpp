@@ -0,0 +1,350 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SMatrix.cpp
+   
+   Class: BasicSMatrix
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cassert>
+#include <algorithm>
+#include <utility>
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "DVector.h"
+#include "DMatrix.h"
+#include "SMatrix.h"
+
+namespace nsl {
+
+/** 
+    Constructor: an empty (all zero) matrix.
+*/
+template <typename Real>
+BasicSMatrix<Real>::BasicSMatrix(std::size_t rows, std::size_t cols)
+  : _rows(rows), _cols(cols), _rowStart(rows + 1, 0) {}
+
+/** 
+    Constructor: build the matrix from (row, column, value) triplets.
+
+    Triplets with the same row and column are summed up.
+*/
+template <typename Real>
+BasicSMatrix<Real>::BasicSMatrix(std::size_t rows, std::size_t cols, const std::vector<BasicTriplet<Real> > &triplets)
+  : _rows(rows), _cols(cols), _rowStart(rows + 1, 0)
+{
+  // Count the entries per row
+  for (const auto &t : triplets)
+    {
+      assert(t.row < rows);
+      assert(t.col < cols);
+      
+      ++_rowStart[t.row + 1];
+    }
+  for (std::size_t i = 0; i < rows; ++i)
+    _rowStart[i + 1] += _rowStart[i];
+
+  // Bucket the entries by row
+  std::vector<std::pair<std::size_t, Real> > entries(triplets.size());
+  std::vector<std::size_t> next(_rowStart.begin(), _rowStart.end() - 1);
+  for (const auto &t : triplets)
+    entries[next[t.row]++] = std::make_pair(t.col, t.value);
+
+  // Sort each row by column and sum up duplicates
+  _colIndex.reserve(entries.size());
+  _values.reserve(entries.size());
+  std::size_t begin = 0;
+  for (std::size_t i = 0; i < rows; ++i)
+    {
+      std::size_t end = _rowStart[i + 1];
+      // (stable, so that duplicates are summed up in the order they were given)
+      std::stable_sort(entries.begin() + begin, entries.begin() + end, 
+		       [] (const std::pair<std::size_t, Real> &a, 
+			   const std::pair<std::size_t, Real> &b) { return a.first < b.first; });
+      
+      _rowStart[i] = _colIndex.size();
+      for (std::size_t k = begin; k < end; ++k)
+	{
+	  if (k > begin && entries[k].first == _colIndex.back())
+	    _values.back() += entries[k].second;
+	  else
+	    {
+	      _colIndex.push_back(entries[k].first);
+	      _values.push_back(entries[k].second);
+	    }
+	}
+      
+      begin = end;
+    }
+  _rowStart[rows] = _colIndex.size();
+
+  Profiler::countAllocation(entries.size() * sizeof(entries[0]));
+  Profiler::countAllocation(_rowStart.size() * sizeof(std::size_t) + 
+			    _colIndex.size() * sizeof(std::size_t) + 
+			    _values.size() * sizeof(Real));
+}
+
+/**
+   Number of columns.
+*/
+template <typename Real>
+std::size_t BasicSMatrix<Real>::cols() const
+{
+  return _cols;
+}
+
+/**
+   Number of rows.
+*/
+template <typename Real>
+std::size_t BasicSMatrix<Real>::rows() const
+{
+  return _rows;
+}
+
+/**
+   Number of stored (structurally non-zero) elements.
+*/
+template <typename Real>
+std::size_t BasicSMatrix<Real>::nnz() const
+{
+  return _values.size();
+}
+
+/**
+   Constant element accessor.
+
+   Elements which are not stored are 0.
+*/
+template <typename Real>
+Real BasicSMatrix<Real>::operator() (std::size_t row, std::size_t col) const
+{
+  assert(row < _rows);
+  assert(col < _cols);
+
+  std::vector<std::size_t>::const_iterator begin = _colIndex.begin() + _rowStart[row];
+  std::vector<std::size_t>::const_iterator end   = _colIndex.begin() + _rowStart[row + 1];
+  std::vector<std::size_t>::const_iterator it    = std::lower_bound(begin, end, col);
+  
+  if (it == end || *it != col)
+    return 0;
+
+  return _values[it - _colIndex.begin()];
+}
+
+/**
+   Row start offsets (rows() + 1 elements).
+*/
+template <typename Real>
+const std::vector<std::size_t> &BasicSMatrix<Real>::rowStart() const
+{
+  return _rowStart;
+}
+
+/**
+   Column indices of the stored elements.
+*/
+template <typename Real>
+const std::vector<std::size_t> &BasicSMatrix<Real>::colIndex() const
+{
+  return _colIndex;
+}
+
+/**
+   Values of the stored elements.
+*/
+template <typename Real>
+const std::vector<Real> &BasicSMatrix<Real>::values() const
+{
+  return _values;
+}
+
+/**
+   Values of the stored elements.
+   
+   The sparsity pattern can not be changed, only the values.
+*/
+template <typename Real>
+std::vector<Real> &BasicSMatrix<Real>::values()
+{
+  return _values;
+}
+
+/**
+   Convert to a dense matrix.
+*/
+template <typename Real>
+BasicMatrix<Real> BasicSMatrix<Real>::toDense() const
+{
+  BasicMatrix<Real> m(_rows, _cols);
+  for (std::size_t row = 0; row < _rows; ++row)
+    for (std::size_t k = _rowStart[row]; k < _rowStart[row + 1]; ++k)
+      m(row, _colIndex[k]) = _values[k];
+
+  return m;
+}
+
+/**
+   Multiplication operator: SMatrix * DVector -> DVector
+*/
+template <typename Real>
+BasicVector<Real> operator* (const BasicSMatrix<Real> &m, const BasicVector<Real> &v)
+{
+  assert(m.cols() == v.size());
+
+  Profiler::countFlops(2 * m.nnz());
+
+  BasicVector<Real> r(m.rows());
+  for (std::size_t row = 0; row < m._rows; ++row)
+    r(row) = m.rowProduct(row, v);
+  
+  return r;
+}
+
+/**
+   The transposed matrix.
+*/
+template <typename Real>
+BasicSMatrix<Real> BasicSMatrix<Real>::transpose() const
+{
+  BasicSMatrix t(_cols, _rows);
+
+  for (std::size_t k = 0; k < nnz(); ++k)
+    ++t._rowStart[_colIndex[k] + 1];
+  for (std::size_t i = 0; i < _cols; ++i)
+    t._rowStart[i + 1] += t._rowStart[i];
+
+  // Walking the rows in order keeps the columns of t sorted
+  t._colIndex.resize(nnz());
+  t._values.resize(nnz());
+  std::vector<std::size_t> next(t._rowStart.begin(), t._rowStart.end() - 1);
+  for (std::size_t row = 0; row < _rows; ++row)
+    for (std::size_t k = _rowStart[row]; k < _rowStart[row + 1]; ++k)
+      {
+	std::size_t q = next[_colIndex[k]]++;
+	t._colIndex[q] = row;
+	t._values[q] = _values[k];
+      }
+
+  Profiler::countAllocation(t._rowStart.size() * sizeof(std::size_t) + 
+			    t._colIndex.size() * sizeof(std::size_t) + 
+			    t._values.size() * sizeof(Real));
+
+  return t;
+}
+
+/**
+   Product of two sparse matrices.
+
+   The rows of the product are calculated in parallel blocks: the
+   products of each row are summed up in a dense accumulator, then
+   the columns of the row are sorted.
+*/
+template <typename Real>
+BasicSMatrix<Real> operator* (const BasicSMatrix<Real> &a, const BasicSMatrix<Real> &b)
+{
+  assert(a.cols() == b.rows());
+
+  // Rows per block
+  const std::size_t blockSize = 1024;
+
+  std::size_t n = a.rows();
+  std::size_t blocks = (n + blockSize - 1) / blockSize;
+  std::vector<std::vector<std::size_t> > blockCols(blocks);
+  std::vector<std::vector<Real> > blockValues(blocks);
+  std::vector<std::uint64_t> blockFlops(blocks, 0);
+
+  BasicSMatrix<Real> c(n, b.cols());
+
+  ThreadPool::instance().parallelFor(blocks, 1, [&] (std::size_t begin, std::size_t end) {
+      std::vector<Real> accumulator(b.cols(), 0.0);
+      std::vector<char> used(b.cols(), 0);
+      for (std::size_t block = begin; block < end; ++block)
+	{
+	  std::vector<std::size_t> &cols = blockCols[block];
+	  std::vector<Real> &values = blockValues[block];
+	  for (std::size_t row = block * blockSize; row < std::min(n, (block + 1) * blockSize); ++row)
+	    {
+	      std::size_t first = cols.size();
+	      for (std::size_t k = a._rowStart[row]; k < a._rowStart[row + 1]; ++k)
+		{
+		  std::size_t j = a._colIndex[k];
+		  for (std::size_t q = b._rowStart[j]; q < b._rowStart[j + 1]; ++q)
+		    {
+		      std::size_t col = b._colIndex[q];
+		      if (!used[col])
+			{
+			  used[col] = 1;
+			  cols.push_back(col);
+			}
+		      accumulator[col] += a._values[k] * b._values[q];
+		    }
+		  blockFlops[block] += 2 * (b._rowStart[j + 1] - b._rowStart[j]);
+		}
+
+	      std::sort(cols.begin() + first, cols.end());
+	      for (std::size_t p = first; p < cols.size(); ++p)
+		{
+		  values.push_back(accumulator[cols[p]]);
+		  accumulator[cols[p]] = 0;
+		  used[cols[p]] = 0;
+		}
+	      c._rowStart[row + 1] = cols.size() - first;
+	    }
+	}
+    });
+
+  for (std::size_t i = 0; i < n; ++i)
+    c._rowStart[i + 1] += c._rowStart[i];
+  c._colIndex.reserve(c._rowStart[n]);
+  c._values.reserve(c._rowStart[n]);
+  for (std::size_t block = 0; block < blocks; ++block)
+    {
+      c._colIndex.insert(c._colIndex.end(), blockCols[block].begin(), blockCols[block].end());
+      c._values.insert(c._values.end(), blockValues[block].begin(), blockValues[block].end());
+      Profiler::countFlops(blockFlops[block]);
+    }
+
+  Profiler::countAllocation(c._rowStart.size() * sizeof(std::size_t) + 
+			    c._colIndex.size() * sizeof(std::size_t) + 
+			    c._values.size() * sizeof(Real));
+
+  return c;
+}
+
+/**   
+      os <<
+*/
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSMatrix<Real>& m)
+{
+  for (std::size_t row = 0; row < m._rows; ++row)
+    for (std::size_t k = m._rowStart[row]; k < m._rowStart[row + 1]; ++k)
+      os << "(" << row << ", " << m._colIndex[k] << "): " << m._values[k] << std::endl;
+
+  return os;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicSMatrix)
+
+#define INSTANTIATE(Real)						\
+  template BasicVector<Real> operator* (const BasicSMatrix<Real> &m, const BasicVector<Real> &v); \
+  template BasicSMatrix<Real> operator* (const BasicSMatrix<Real> &a, const BasicSMatrix<Real> &b); \
+  template std::ostream& operator<<(std::ostream& os, const BasicSMatrix<Real>& m);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,127 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SMatrix.h
+   
+   Class: BasicSMatrix, SMatrix
+
+   Sparse matrix in compressed sparse row (CSR) format.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __SMatrix__
+#define __SMatrix__
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "Access.h"
+#include "DVector.h"
+#include "DMatrix.h"
+
+namespace nsl {
+
+// =========================================================
+// struct BasicTriplet
+// ---------------------------------------------------------
+
+/**
+   A (row, column, value) entry used to build a sparse matrix.
+*/
+template <typename Real>
+struct BasicTriplet {
+  std::size_t row;
+  std::size_t col;
+  Real value;
+};
+
+typedef BasicTriplet<double> Triplet;
+
+// =========================================================
+// class BasicSMatrix
+// ---------------------------------------------------------
+
+template <typename Real> class BasicSMatrix;
+template <typename Real> class BasicSymmetricSMatrix;
+
+template <typename Real>
+BasicVector<Real> operator* (const BasicSMatrix<Real> &m, const BasicVector<Real> &v);
+template <typename Real>
+BasicSMatrix<Real> operator* (const BasicSMatrix<Real> &a, const BasicSMatrix<Real> &b);
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSMatrix<Real>& m);
+
+template <typename Real>
+class BasicSMatrix {
+
+  std::size_t _rows, _cols;
+
+  // Row i is stored in [_rowStart[i], _rowStart[i + 1]),
+  // the column indices of a row are sorted and unique
+  std::vector<std::size_t> _rowStart;
+  std::vector<std::size_t> _colIndex;
+  std::vector<Real>        _values;
+
+ public:
+  
+  BasicSMatrix(std::size_t rows = 0, std::size_t cols = 0);
+  BasicSMatrix(std::size_t rows, std::size_t cols, const std::vector<BasicTriplet<Real> > &triplets);
+  
+  std::size_t cols() const;
+  std::size_t rows() const;
+  std::size_t nnz() const;
+
+  Real operator() (std::size_t row, std::size_t column) const;
+
+  const std::vector<std::size_t> &rowStart() const;
+  const std::vector<std::size_t> &colIndex() const;
+  const std::vector<Real> &values() const;
+  std::vector<Real> &values();
+
+  Real rowProduct(std::size_t row, const BasicVector<Real> &v) const;
+
+  BasicMatrix<Real> toDense() const;
+  BasicSMatrix transpose() const;
+
+  friend BasicVector<Real> operator* <>(const BasicSMatrix &m, const BasicVector<Real> &v);
+  friend BasicSMatrix operator* <>(const BasicSMatrix &a, const BasicSMatrix &b);
+  
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicSMatrix& m);
+
+  template <typename> friend class BasicSymmetricSMatrix;
+};
+
+typedef BasicSMatrix<double> SMatrix;
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   Product of a single row with a vector.
+*/
+template <typename Real>
+inline Real BasicSMatrix<Real>::rowProduct(std::size_t row, const BasicVector<Real> &v) const
+{
+  NSL_CHECK_ACCESS(row < _rows);
+  NSL_CHECK_ACCESS(v.size() == _cols);
+
+  const Real *vv = v.span().data();
+  Real s = 0;
+  for (std::size_t k = _rowStart[row]; k < _rowStart[row + 1]; ++k)
+    s += _values[k] * vv[_colIndex[k]];
+  
+  return s;
+}
+
+} // namespace nsl
+
+#endif /* defined(__SMatrix__) */
+
+/* fin */
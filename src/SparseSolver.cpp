@@ -0,0 +1,653 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SparseSolver.cpp
+
+   Class: BasicSparseSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "SparseSolver.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   Breadth first search from `start' over the unvisited nodes of the
+   graph given by the pattern (rowStart, colIndex) of a full matrix.
+   Appends the nodes to `order' (neighbours by increasing degree)
+   and returns the number of levels; `lastLevel' is set to the
+   position in `order' where the last level starts.
+*/
+std::size_t breadthFirstSearch(const std::vector<std::size_t> &rowStart,
+			       const std::vector<std::size_t> &colIndex,
+			       std::size_t start,
+			       const std::vector<std::size_t> &degree,
+			       std::vector<char> &visited,
+			       std::vector<std::size_t> &order,
+			       std::size_t &lastLevel)
+{
+  std::size_t begin = order.size();
+  std::size_t levels = 0;
+  std::vector<std::size_t> neighbours;
+
+  order.push_back(start);
+  visited[start] = 1;
+
+  lastLevel = begin;
+  std::size_t levelEnd = order.size();
+  for (std::size_t q = begin; q < order.size(); ++q)
+    {
+      if (q == levelEnd) 
+	{
+	  ++levels;
+	  lastLevel = q;
+	  levelEnd = order.size();
+	}
+
+      std::size_t i = order[q];
+
+      neighbours.clear();
+      for (std::size_t k = rowStart[i]; k < rowStart[i + 1]; ++k)
+	{
+	  std::size_t j = colIndex[k];
+	  if (!visited[j])
+	    {
+	      visited[j] = 1;
+	      neighbours.push_back(j);
+	    }
+	}
+
+      std::stable_sort(neighbours.begin(), neighbours.end(),
+		       [&degree] (std::size_t a, std::size_t b) { return degree[a] < degree[b]; });
+      order.insert(order.end(), neighbours.begin(), neighbours.end());
+    }
+
+  return levels + 1;
+}
+
+/**
+   Reverse Cuthill-McKee ordering of the graph given by the pattern
+   (rowStart, colIndex) of a full symmetric matrix.
+   Returns the permutation: result[new index] = old index.
+
+   Each connected component is started at a pseudo-peripheral node,
+   found by repeated breadth first searches from a node of minimal
+   degree.
+*/
+std::vector<std::size_t> reverseCuthillMcKeeOrder(const std::vector<std::size_t> &rowStart,
+						  const std::vector<std::size_t> &colIndex)
+{
+  std::size_t n = rowStart.size() - 1;
+
+  std::vector<std::size_t> degree(n);
+  for (std::size_t i = 0; i < n; ++i)
+    degree[i] = rowStart[i + 1] - rowStart[i];
+
+  // Nodes by increasing degree: the candidates to start a component
+  std::vector<std::size_t> byDegree(n);
+  for (std::size_t i = 0; i < n; ++i) byDegree[i] = i;
+  std::stable_sort(byDegree.begin(), byDegree.end(),
+		   [&degree] (std::size_t a, std::size_t b) { return degree[a] < degree[b]; });
+
+  std::vector<char> visited(n, 0);
+  std::vector<std::size_t> order;
+  order.reserve(n);
+
+  std::vector<char> probeVisited(n, 0);
+  std::vector<std::size_t> probe;
+
+  for (std::size_t s = 0; s < n; ++s)
+    {
+      std::size_t start = byDegree[s];
+      if (visited[start]) continue;
+
+      // Find a pseudo-peripheral node: move to a node of minimal
+      // degree in the last level as long as the number of levels grows
+      std::size_t levels = 0, lastLevel;
+      for (int iteration = 0; iteration < 8; ++iteration)
+	{
+	  probe.clear();
+	  std::size_t l = breadthFirstSearch(rowStart, colIndex, start, degree, probeVisited, probe, lastLevel);
+	  for (std::size_t i : probe) probeVisited[i] = 0;
+
+	  if (l <= levels) break;
+	  levels = l;
+
+	  std::size_t candidate = probe[lastLevel];
+	  for (std::size_t k = lastLevel; k < probe.size(); ++k)
+	    if (degree[probe[k]] < degree[candidate])
+	      candidate = probe[k];
+
+	  if (candidate == start) break;
+	  start = candidate;
+	}
+
+      breadthFirstSearch(rowStart, colIndex, start, degree, visited, order, lastLevel);
+    }
+
+  std::reverse(order.begin(), order.end());
+
+  return order;
+}
+
+/**
+   The pattern of the full matrix (both triangles) of a symmetric
+   matrix given by its upper triangle.  The columns of every row are
+   sorted, as in the full CSR matrix.
+*/
+template <typename Real>
+void fullPattern(const BasicSMatrix<Real> &upper,
+		 std::vector<std::size_t> &rowStart,
+		 std::vector<std::size_t> &colIndex)
+{
+  std::size_t n = upper.rows();
+
+  rowStart.assign(n + 1, 0);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t p = upper.rowStart()[i]; p < upper.rowStart()[i + 1]; ++p)
+      {
+	++rowStart[i + 1];
+	if (upper.colIndex()[p] != i) ++rowStart[upper.colIndex()[p] + 1];
+      }
+  for (std::size_t i = 0; i < n; ++i)
+    rowStart[i + 1] += rowStart[i];
+
+  // Rows < i add their mirrored entries to row i before row i itself
+  colIndex.resize(rowStart[n]);
+  std::vector<std::size_t> next(rowStart.begin(), rowStart.end() - 1);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t p = upper.rowStart()[i]; p < upper.rowStart()[i + 1]; ++p)
+      {
+	std::size_t j = upper.colIndex()[p];
+	colIndex[next[i]++] = j;
+	if (j != i) colIndex[next[j]++] = i;
+      }
+}
+
+/**
+   The nonzero pattern of the rows of L: the nodes reached by walking
+   up the elimination tree from the nonzeros of row k of the lower
+   triangle of A.  operator() writes it to pattern[top ... n - 1] in
+   topological order and returns top.
+*/
+class RowPattern {
+
+  const std::vector<std::size_t> &_lowerStart;
+  const std::vector<std::size_t> &_lowerCol;
+  const std::vector<std::size_t> &_parent;
+  std::vector<std::size_t> _mark, _stack;
+
+ public:
+  std::vector<std::size_t> pattern;
+
+  RowPattern(const std::vector<std::size_t> &lowerStart,
+	     const std::vector<std::size_t> &lowerCol,
+	     const std::vector<std::size_t> &parent)
+    : _lowerStart(lowerStart), _lowerCol(lowerCol), _parent(parent),
+      _mark(parent.size(), (std::size_t) -1), _stack(parent.size()), pattern(parent.size()) {}
+
+  std::size_t operator() (std::size_t k)
+  {
+    std::size_t top = pattern.size();
+    _mark[k] = k;
+    for (std::size_t p = _lowerStart[k]; p < _lowerStart[k + 1]; ++p)
+      {
+	std::size_t length = 0;
+	for (std::size_t i = _lowerCol[p]; _mark[i] != k; i = _parent[i])
+	  {
+	    _stack[length++] = i;
+	    _mark[i] = k;
+	  }
+	while (length > 0) pattern[--top] = _stack[--length];
+      }
+    return top;
+  }
+};
+
+} // namespace
+
+// =========================================================
+// Class BasicSparseSolver
+// ---------------------------------------------------------
+
+/**
+   Reverse Cuthill-McKee ordering of the (symmetric) matrix graph.
+   Returns the permutation: result[new index] = old index.
+
+   Each connected component is started at a pseudo-peripheral node,
+   found by repeated breadth first searches from a node of minimal
+   degree.
+*/
+template <typename Real>
+std::vector<std::size_t> BasicSparseSolver<Real>::reverseCuthillMcKee(const BasicSMatrix<Real> &matrix)
+{
+  return reverseCuthillMcKeeOrder(matrix.rowStart(), matrix.colIndex());
+}
+
+/**
+   Reverse Cuthill-McKee ordering of a symmetric matrix given by its
+   upper triangle: the same permutation as for the full matrix.
+*/
+template <typename Real>
+std::vector<std::size_t> BasicSparseSolver<Real>::reverseCuthillMcKee(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::vector<std::size_t> rowStart, colIndex;
+  fullPattern(matrix.upper(), rowStart, colIndex);
+
+  return reverseCuthillMcKeeOrder(rowStart, colIndex);
+}
+
+template <typename Real>
+LinearSolverBase::Type BasicSparseSolver<Real>::type() const
+{
+  return LinearSolverBase::SPARSE;
+}
+
+/**
+   Compute and store the factor in single (true) or double precision.
+*/
+template <typename Real>
+void BasicSparseSolver<Real>::setSinglePrecision(bool single)
+{
+  _single = single;
+}
+
+/**
+   Number of nonzeros of the Cholesky factor.
+*/
+template <typename Real>
+std::size_t BasicSparseSolver<Real>::factorNonzeros() const
+{
+  return _single ? _singleValues.size() : _values.size();
+}
+
+/**
+   Reorder and factorize the matrix.
+*/
+template <typename Real>
+void BasicSparseSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  if (!factor(matrix, pivot, value)) error(pivot, value);
+}
+
+/**
+   Reorder and factorize a symmetric matrix given by its upper triangle.
+*/
+template <typename Real>
+void BasicSparseSolver<Real>::factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  if (!factor(matrix, pivot, value)) error(pivot, value);
+}
+
+/**
+   Report a matrix which is not positive definite.
+*/
+template <typename Real>
+void BasicSparseSolver<Real>::error(std::size_t pivot, double value) const
+{
+  std::cerr 
+    << "ERROR The matrix is not solvable!" << std::endl
+    << std::endl
+    << "The stiffness matrix is not positive definite (pivot " << pivot << ": " << value << ")." << std::endl
+    << "Is there a part of the assemblage without prescribed displacement?" << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+/**
+   Reorder and factorize the matrix.  Returns false when it turns out
+   not to be positive definite (in the precision of the factor).
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::tryFactor(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  return factor(matrix, pivot, value);
+}
+
+/**
+   Reorder and factorize the matrix.  When a pivot is not positive,
+   false is returned and `pivot' and `value' are set to the row
+   (in the original numbering) and the value of the pivot.
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::factor(const BasicSMatrix<Real> &matrix, std::size_t &pivot, double &value)
+{
+  ScopedTimer timer("sparse factorization");
+
+  _n = matrix.rows();
+  _permutation = reverseCuthillMcKee(matrix);
+  std::vector<std::size_t>().swap(_lowerPosition);
+
+  std::vector<std::size_t> inverse(_n);
+  for (std::size_t i = 0; i < _n; ++i) inverse[_permutation[i]] = i;
+
+  // The lower triangle of the reordered matrix, row by row
+  std::vector<std::size_t> lowerStart(_n + 1, 0);
+  std::vector<std::size_t> lowerCol;
+  std::vector<Real>      lowerValue;
+  lowerCol.reserve(matrix.nnz() / 2 + _n);
+  lowerValue.reserve(matrix.nnz() / 2 + _n);
+  for (std::size_t k = 0; k < _n; ++k)
+    {
+      std::size_t old = _permutation[k];
+      for (std::size_t p = matrix.rowStart()[old]; p < matrix.rowStart()[old + 1]; ++p)
+	{
+	  std::size_t j = inverse[matrix.colIndex()[p]];
+	  if (j <= k)
+	    {
+	      lowerCol.push_back(j);
+	      lowerValue.push_back(matrix.values()[p]);
+	    }
+	}
+      lowerStart[k + 1] = lowerCol.size();
+    }
+
+  return factor(lowerStart, lowerCol, lowerValue, pivot, value);
+}
+
+/**
+   Reorder and factorize a symmetric matrix given by its upper
+   triangle.  The reordered lower triangle is filled directly from
+   the upper triangle, in the same order as from the full matrix.
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::factor(const BasicSymmetricSMatrix<Real> &matrix, std::size_t &pivot, double &value)
+{
+  ScopedTimer timer("sparse factorization");
+
+  const BasicSMatrix<Real> &upper = matrix.upper();
+
+  _n = matrix.rows();
+  _permutation = reverseCuthillMcKee(matrix);
+
+  std::vector<std::size_t> inverse(_n);
+  for (std::size_t i = 0; i < _n; ++i) inverse[_permutation[i]] = i;
+
+  // Every stored element (i, j) is an element of the reordered
+  // lower triangle, in row max(inverse[i], inverse[j])
+  std::vector<std::size_t> lowerStart(_n + 1, 0);
+  for (std::size_t i = 0; i < _n; ++i)
+    for (std::size_t p = upper.rowStart()[i]; p < upper.rowStart()[i + 1]; ++p)
+      ++lowerStart[std::max(inverse[i], inverse[upper.colIndex()[p]]) + 1];
+  for (std::size_t k = 0; k < _n; ++k)
+    lowerStart[k + 1] += lowerStart[k];
+
+  std::vector<std::size_t> lowerCol(upper.nnz());
+  std::vector<Real>      lowerValue(upper.nnz());
+  std::vector<std::size_t> lowerPosition(upper.nnz());
+  std::vector<std::size_t> next(lowerStart.begin(), lowerStart.end() - 1);
+  for (std::size_t i = 0; i < _n; ++i)
+    for (std::size_t p = upper.rowStart()[i]; p < upper.rowStart()[i + 1]; ++p)
+      {
+	std::size_t a = inverse[i], b = inverse[upper.colIndex()[p]];
+	std::size_t q = next[std::max(a, b)]++;
+	lowerCol[q] = std::min(a, b);
+	lowerValue[q] = upper.values()[p];
+	lowerPosition[p] = q;
+      }
+
+  bool factorized = factor(lowerStart, lowerCol, lowerValue, pivot, value);
+
+  // The pattern for refactorSymmetric()
+  _lowerStart.swap(lowerStart);
+  _lowerCol.swap(lowerCol);
+  _lowerPosition.swap(lowerPosition);
+
+  return factorized;
+}
+
+/**
+   Factorize a matrix with the pattern of the matrix passed to the
+   last factorSymmetric() again: only the numeric factorization is
+   repeated.
+*/
+template <typename Real>
+void BasicSparseSolver<Real>::refactorSymmetric(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  if (!refactor(matrix, pivot, value)) error(pivot, value);
+}
+
+/**
+   Factorize a matrix with the pattern of the matrix passed to the
+   last factorSymmetric() again.  Returns false when it turns out not
+   to be positive definite (in the precision of the factor).
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::tryRefactor(const BasicSymmetricSMatrix<Real> &matrix)
+{
+  std::size_t pivot;
+  double value;
+  return refactor(matrix, pivot, value);
+}
+
+/**
+   The numeric factorization of a matrix with a known pattern: the
+   stored elements are scattered to their positions in the reordered
+   lower triangle.
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::refactor(const BasicSymmetricSMatrix<Real> &matrix, std::size_t &pivot, double &value)
+{
+  ScopedTimer timer("sparse refactorization");
+
+  if (_lowerPosition.empty() || matrix.rows() != _n || matrix.nnz() != _lowerPosition.size())
+    {
+      std::cerr << "ERROR The matrix does not have the pattern of the factorized matrix!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  const std::vector<Real> &values = matrix.upper().values();
+  std::vector<Real> lowerValue(values.size());
+  for (std::size_t p = 0; p < values.size(); ++p)
+    lowerValue[_lowerPosition[p]] = values[p];
+
+  return numericFactorization(_lowerStart, _lowerCol, lowerValue, _parent, pivot, value);
+}
+
+/**
+   Symbolic and numeric factorization of the reordered matrix given
+   by its lower triangle (row by row).
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::factor(const std::vector<std::size_t> &lowerStart,
+				     const std::vector<std::size_t> &lowerCol,
+				     const std::vector<Real> &lowerValue,
+				     std::size_t &pivot, double &value)
+{
+  const std::size_t none = (std::size_t) -1;
+
+  // The elimination tree
+  std::vector<std::size_t> parent(_n, none), ancestor(_n, none);
+  for (std::size_t k = 0; k < _n; ++k)
+    for (std::size_t p = lowerStart[k]; p < lowerStart[k + 1]; ++p)
+      for (std::size_t i = lowerCol[p]; i != none && i < k; )
+	{
+	  std::size_t next = ancestor[i];
+	  ancestor[i] = k;
+	  if (next == none) parent[i] = k;
+	  i = next;
+	}
+
+  // Symbolic factorization: the number of nonzeros in each column of L
+  RowPattern rowPattern(lowerStart, lowerCol, parent);
+  std::vector<std::size_t> count(_n, 1);
+  for (std::size_t k = 0; k < _n; ++k)
+    for (std::size_t p = rowPattern(k); p < _n; ++p)
+      ++count[rowPattern.pattern[p]];
+
+  _colStart.assign(_n + 1, 0);
+  for (std::size_t j = 0; j < _n; ++j)
+    _colStart[j + 1] = _colStart[j] + count[j];
+  _rowIndex.assign(_colStart[_n], 0);
+
+  bool factorized = numericFactorization(lowerStart, lowerCol, lowerValue, parent, pivot, value);
+  _parent.swap(parent);
+
+  return factorized;
+}
+
+/**
+   Numeric factorization in the precision of the factor,
+   with the structure of L computed by the symbolic factorization.
+*/
+template <typename Real>
+bool BasicSparseSolver<Real>::numericFactorization(const std::vector<std::size_t> &lowerStart,
+						   const std::vector<std::size_t> &lowerCol,
+						   const std::vector<Real> &lowerValue,
+						   const std::vector<std::size_t> &parent,
+						   std::size_t &pivot, double &value)
+{
+  // The factor is kept in one precision only
+  if (_single)
+    {
+      std::vector<Real>().swap(_values);
+      return numericFactorization(lowerStart, lowerCol, lowerValue, parent, _singleValues, pivot, value);
+    }
+  else
+    {
+      std::vector<float>().swap(_singleValues);
+      return numericFactorization(lowerStart, lowerCol, lowerValue, parent, _values, pivot, value);
+    }
+}
+
+/**
+   Numeric factorization, row by row: 
+   solve L(0:k-1, 0:k-1) x = A(0:k-1, k) for row k of L.
+*/
+template <typename Real>
+template <typename Factor>
+bool BasicSparseSolver<Real>::numericFactorization(const std::vector<std::size_t> &lowerStart,
+					const std::vector<std::size_t> &lowerCol,
+					const std::vector<Real> &lowerValue,
+					const std::vector<std::size_t> &parent,
+					std::vector<Factor> &values,
+					std::size_t &pivot, double &value)
+{
+  values.assign(_colStart[_n], Factor(0));
+
+  RowPattern rowPattern(lowerStart, lowerCol, parent);
+  std::vector<std::size_t> next(_colStart.begin(), _colStart.end() - 1);
+  std::vector<Factor> x(_n, Factor(0));
+  std::uint64_t flops = 0;
+  for (std::size_t k = 0; k < _n; ++k)
+    {
+      std::size_t top = rowPattern(k);
+
+      for (std::size_t p = lowerStart[k]; p < lowerStart[k + 1]; ++p)
+	x[lowerCol[p]] += Factor(lowerValue[p]);
+      Factor d = x[k];
+      x[k] = 0;
+
+      for (; top < _n; ++top)
+	{
+	  std::size_t i = rowPattern.pattern[top];
+	  Factor lki = x[i] / values[_colStart[i]];
+	  x[i] = 0;
+	  for (std::size_t q = _colStart[i] + 1; q < next[i]; ++q)
+	    x[_rowIndex[q]] -= values[q] * lki;
+	  flops += 2 * (next[i] - _colStart[i]) + 2;
+	  d -= lki * lki;
+
+	  std::size_t q = next[i]++;
+	  _rowIndex[q] = k;
+	  values[q] = lki;
+	}
+
+      if (!(d > 0))
+	{
+	  Profiler::countFlops(flops);
+	  pivot = _permutation[k];
+	  value = d;
+	  return false;
+	}
+
+      std::size_t q = next[k]++;
+      _rowIndex[q] = k;
+      values[q] = std::sqrt(d);
+    }
+  Profiler::countFlops(flops);
+
+  return true;
+}
+
+/**
+   Solve the system by forward and back substitution 
+   in the reordered numbering.
+*/
+template <typename Real>
+BasicVector<Real> BasicSparseSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  BasicVector<Real> x(_n);
+
+  if (_single)
+    {
+      std::vector<float> v(_n);
+      for (std::size_t i = 0; i < _n; ++i) v[i] = float(b(_permutation[i]));
+      substitute(_singleValues, v);
+      for (std::size_t i = 0; i < _n; ++i) x(_permutation[i]) = v[i];
+    }
+  else
+    {
+      std::vector<Real> v(_n);
+      for (std::size_t i = 0; i < _n; ++i) v[i] = b(_permutation[i]);
+      substitute(_values, v);
+      for (std::size_t i = 0; i < _n; ++i) x(_permutation[i]) = v[i];
+    }
+
+  return x;
+}
+
+/**
+   L L^T x = v, x overwriting v.
+*/
+template <typename Real>
+template <typename Factor>
+void BasicSparseSolver<Real>::substitute(const std::vector<Factor> &values, std::vector<Factor> &v) const
+{
+  // L y = b
+  for (std::size_t j = 0; j < _n; ++j)
+    {
+      v[j] /= values[_colStart[j]];
+      for (std::size_t q = _colStart[j] + 1; q < _colStart[j + 1]; ++q)
+	v[_rowIndex[q]] -= values[q] * v[j];
+    }
+
+  // L^T x = y
+  for (std::size_t j = _n; j-- > 0; )
+    {
+      Factor s = v[j];
+      for (std::size_t q = _colStart[j] + 1; q < _colStart[j + 1]; ++q)
+	s -= values[q] * v[_rowIndex[q]];
+      v[j] = s / values[_colStart[j]];
+    }
+  Profiler::countFlops(4 * values.size());
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicSparseSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,122 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SparseSolver.h
+
+   Class: BasicSparseSolver, SparseSolver
+
+   Sparse direct solver for symmetric positive definite matrices.
+   The unknowns are renumbered with the reverse Cuthill-McKee
+   algorithm, the nonzero structure of the Cholesky factor L is
+   derived from the elimination tree, and L is computed row by row
+   ("up-looking" Cholesky factorization) and stored column-wise.
+   Only the nonzeros of L are stored and touched.  A symmetric matrix
+   in half storage is reordered and factorized from its upper triangle
+   (factorSymmetric()), without expanding it.  With the reverse
+   Cuthill-McKee order the leaves of a tree are eliminated before
+   their parents, so that chains and trees are factorized without
+   any fill-in in linear time, independently of their node numbering.
+
+   refactorSymmetric() factorizes a matrix with the nonzero pattern of
+   the last one passed to factorSymmetric() (other values, e.g. other
+   spring constants) again: the ordering, the elimination tree and
+   the structure of L are kept, only the numeric factorization is
+   repeated.
+
+   With setSinglePrecision(true) the factor is computed and stored in
+   single precision (half the memory and memory traffic); see
+   RefinementSolver for recovering double precision accuracy.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __SparseSolver__
+#define __SparseSolver__
+
+#include <vector>
+
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicSparseSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicSparseSolver : public BasicLinearSolver<Real> {
+
+  std::size_t _n = 0;
+  bool _single = false;
+
+  // _permutation[new index] = old index
+  std::vector<std::size_t> _permutation;
+
+  // Column j of L is stored in [_colStart[j], _colStart[j + 1]),
+  // the diagonal element first
+  std::vector<std::size_t> _colStart;
+  std::vector<std::size_t> _rowIndex;
+  std::vector<Real>      _values;
+  std::vector<float>       _singleValues;  // Instead of _values in single precision
+
+  // Kept by factorSymmetric() for refactorSymmetric(): the pattern of
+  // the reordered lower triangle, the elimination tree and the
+  // position of every stored element of the matrix in the lower triangle
+  std::vector<std::size_t> _lowerStart;
+  std::vector<std::size_t> _lowerCol;
+  std::vector<std::size_t> _parent;
+  std::vector<std::size_t> _lowerPosition;
+  
+ public:
+  static std::vector<std::size_t> reverseCuthillMcKee(const BasicSMatrix<Real> &matrix);
+  static std::vector<std::size_t> reverseCuthillMcKee(const BasicSymmetricSMatrix<Real> &matrix);
+
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  void factorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  bool tryFactor(const BasicSymmetricSMatrix<Real> &matrix);
+  void refactorSymmetric(const BasicSymmetricSMatrix<Real> &matrix);
+  bool tryRefactor(const BasicSymmetricSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+
+  void setSinglePrecision(bool single);
+  std::size_t factorNonzeros() const;
+
+ private:
+  bool factor(const BasicSMatrix<Real> &matrix, std::size_t &pivot, double &value);
+  bool factor(const BasicSymmetricSMatrix<Real> &matrix, std::size_t &pivot, double &value);
+  bool factor(const std::vector<std::size_t> &lowerStart,
+	      const std::vector<std::size_t> &lowerCol,
+	      const std::vector<Real> &lowerValue,
+	      std::size_t &pivot, double &value);
+  bool refactor(const BasicSymmetricSMatrix<Real> &matrix, std::size_t &pivot, double &value);
+  bool numericFactorization(const std::vector<std::size_t> &lowerStart,
+			    const std::vector<std::size_t> &lowerCol,
+			    const std::vector<Real> &lowerValue,
+			    const std::vector<std::size_t> &parent,
+			    std::size_t &pivot, double &value);
+  void error(std::size_t pivot, double value) const;
+
+  template <typename Factor>
+  bool numericFactorization(const std::vector<std::size_t> &lowerStart,
+			    const std::vector<std::size_t> &lowerCol,
+			    const std::vector<Real> &lowerValue,
+			    const std::vector<std::size_t> &parent,
+			    std::vector<Factor> &values,
+			    std::size_t &pivot, double &value);
+
+  template <typename Factor>
+  void substitute(const std::vector<Factor> &values, std::vector<Factor> &v) const;
+};
+
+typedef BasicSparseSolver<double> SparseSolver;
+
+} // namespace nsl
+
+#endif /* defined(__SparseSolver__) */
+
+/* fin */
@@ -4,7 +4,7 @@
    
    Spring.cpp
 
-   Class: Spring
+   Class: BasicSpring
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -21,48 +21,61 @@
 namespace nsl {
 
 // =========================================================
-// Class Spring
+// Class BasicSpring
 // ---------------------------------------------------------
 
-Spring::Spring(const int index, const int id, 
-	       const Node *node1, const Node *node2, 
-	       const double springConstant)
+template <typename Real>
+BasicSpring<Real>::BasicSpring(const int index, const int id, 
+			       const BasicNode<Real> *node1, const BasicNode<Real> *node2, 
+			       const Real springConstant)
   : _index(index), _id(id),
     _node1(node1), _node2(node2),
     _springConstant(springConstant)
 {}
 
-Spring::~Spring() {}
+template <typename Real>
+BasicSpring<Real>::~BasicSpring() {}
 
 // =========================================================
 // Accessors
 // ---------------------------------------------------------
 
-const Node *Spring::getNode1() const
+template <typename Real>
+const BasicNode<Real> *BasicSpring<Real>::getNode1() const
 {
   return _node1;
 }
 
-const Node *Spring::getNode2() const
+template <typename Real>
+const BasicNode<Real> *BasicSpring<Real>::getNode2() const
 {
   return _node2;
 }
 
-int Spring::getIndex() const
+template <typename Real>
+int BasicSpring<Real>::getIndex() const
 {
   return _index;
 }
 
-int Spring::getID() const
+template <typename Real>
+int BasicSpring<Real>::getID() const
 {
   return _id;
 }
 
-double Spring::getSpringConstant() const
+template <typename Real>
+Real BasicSpring<Real>::getSpringConstant() const
 {
   return _springConstant;
 }
 
+template <typename Real>
+void BasicSpring<Real>::setSpringConstant(const Real springConstant)
+{
+  _springConstant = springConstant;
+}
+
 // =========================================================
 // Methods
 // ---------------------------------------------------------
@@ -70,11 +83,12 @@ double Spring::getSpringConstant() const
 /**
    Stiffness matrix.
 */
-DMatrix Spring::stiffnessMatrix()
+template <typename Real>
+BasicMatrix<Real> BasicSpring<Real>::stiffnessMatrix()
 {
-  double k = _springConstant;
+  Real k = _springConstant;
 
-  DMatrix stiffnessMatrix(2, 2);
+  BasicMatrix<Real> stiffnessMatrix(2, 2);
   stiffnessMatrix = { 
      k, -k, 
     -k,  k
@@ -86,7 +100,8 @@ DMatrix Spring::stiffnessMatrix()
 /**
    Dump the internals of the spring.
 */
-void Spring::dump()
+template <typename Real>
+void BasicSpring<Real>::dump()
 {
   std::cout 
     << ">>> spring " << _id << ":" << std::endl
@@ -106,7 +121,8 @@ void Spring::dump()
 // Friends
 // ---------------------------------------------------------
 
-std::ostream& operator<<(std::ostream& os, const Spring& spring)
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSpring<Real>& spring)
 {
   std::cout
     << "spring " << spring._id << "  " 
@@ -118,6 +134,17 @@ std::ostream& operator<<(std::ostream& os, const Spring& spring)
   return os;
 }
 
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicSpring)
+
+#define INSTANTIATE(Real)						\
+  template std::ostream& operator<<(std::ostream& os, const BasicSpring<Real>& spring);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
 } // namespace nsl
 
 /* fin */
@@ -4,7 +4,7 @@
    
    Spring.h
 
-   Class: Spring
+   Class: BasicSpring, Spring
    
    Copyright (c) 2015 Dietrich Bollmann
    
@@ -22,40 +22,49 @@
 
 namespace nsl {
 
+template <typename Real> class BasicSpring;
+
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSpring<Real>& spring);
+
 // =========================================================
-// class Spring
+// class BasicSpring
 // ---------------------------------------------------------
 
-class Spring
+template <typename Real>
+class BasicSpring
 {
 private:
   const int _index;
   const int _id;
-  const Node *_node1;
-  const Node *_node2;
-  const double _springConstant;
+  const BasicNode<Real> *_node1;
+  const BasicNode<Real> *_node2;
+  Real _springConstant;
   
 public:
-  Spring(const int index, const int id, 
-	 const Node *node1, const Node *node2, 
-	 const double springConstant);
-  ~Spring();
+  BasicSpring(const int index, const int id, 
+	      const BasicNode<Real> *node1, const BasicNode<Real> *node2, 
+	      const Real springConstant);
+  ~BasicSpring();
 
   // Accessors
-  const Node *getNode1() const;
-  const Node *getNode2() const;
+  const BasicNode<Real> *getNode1() const;
+  const BasicNode<Real> *getNode2() const;
   int getIndex() const;
   int getID() const;
-  double getSpringConstant() const;
+  Real getSpringConstant() const;
+  void setSpringConstant(const Real springConstant);
   
   // Methods
-  DMatrix stiffnessMatrix();
+  BasicMatrix<Real> stiffnessMatrix();
   void dump();
 
   // Friends  
-  friend std::ostream& operator<<(std::ostream& os, const Spring& spring);
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicSpring& spring);
 };
 
+typedef BasicSpring<double> Spring;
+
 } // namespace nsl
 
 #endif /* defined(__Spring__) */
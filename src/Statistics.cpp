@@ -0,0 +1,243 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Statistics.cpp
+
+   Class: RunningStatistics, P2Quantile
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+
+#include "Statistics.h"
+
+namespace nsl {
+
+// =========================================================
+// Class RunningStatistics
+// ---------------------------------------------------------
+
+/**
+   Add a value.
+*/
+void RunningStatistics::add(double x)
+{
+  if (_count == 0) _min = _max = x;
+  _min = std::min(_min, x);
+  _max = std::max(_max, x);
+
+  ++_count;
+  double delta = x - _mean;
+  _mean += delta / _count;
+  _m2 += delta * (x - _mean);
+}
+
+/**
+   Add the values of another estimator.
+*/
+void RunningStatistics::merge(const RunningStatistics &other)
+{
+  if (other._count == 0) return;
+  if (_count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+  double n = double(_count) + double(other._count);
+  double delta = other._mean - _mean;
+  _mean += delta * other._count / n;
+  _m2 += other._m2 + delta * delta * _count * other._count / n;
+  _min = std::min(_min, other._min);
+  _max = std::max(_max, other._max);
+  _count += other._count;
+}
+
+/**
+   Number of values.
+*/
+std::size_t RunningStatistics::count() const
+{
+  return _count;
+}
+
+/**
+   The mean of the values.
+*/
+double RunningStatistics::mean() const
+{
+  return _mean;
+}
+
+/**
+   The sample variance (divided by count - 1; 0 for less than two values).
+*/
+double RunningStatistics::variance() const
+{
+  return _count > 1 ? _m2 / (_count - 1) : 0.0;
+}
+
+/**
+   The sample standard deviation.
+*/
+double RunningStatistics::deviation() const
+{
+  return std::sqrt(variance());
+}
+
+/**
+   The smallest value.
+*/
+double RunningStatistics::minimum() const
+{
+  return _min;
+}
+
+/**
+   The largest value.
+*/
+double RunningStatistics::maximum() const
+{
+  return _max;
+}
+
+// =========================================================
+// Class P2Quantile
+// ---------------------------------------------------------
+
+/**
+   Constructor: an estimator of the p quantile, 0 < p < 1.
+*/
+P2Quantile::P2Quantile(double p)
+  : _p(p)
+{
+  assert(p > 0 && p < 1);
+
+  for (int i = 0; i < 5; ++i) _height[i] = _position[i] = 0;
+
+  _desired[0] = 0;
+  _desired[1] = 2 * p;
+  _desired[2] = 4 * p;
+  _desired[3] = 2 + 2 * p;
+  _desired[4] = 4;
+
+  _increment[0] = 0;
+  _increment[1] = p / 2;
+  _increment[2] = p;
+  _increment[3] = (1 + p) / 2;
+  _increment[4] = 1;
+}
+
+/**
+   Add a value.
+*/
+void P2Quantile::add(double x)
+{
+  // The first five values are the initial markers
+  if (_count < 5)
+    {
+      _height[_count++] = x;
+      std::sort(_height, _height + _count);
+      if (_count == 5)
+	for (int i = 0; i < 5; ++i) _position[i] = i;
+      return;
+    }
+  ++_count;
+
+  // The cell of x; the extreme markers follow the minimum and maximum
+  int k;
+  if (x < _height[0])
+    {
+      _height[0] = x;
+      k = 0;
+    }
+  else if (x >= _height[4])
+    {
+      _height[4] = x;
+      k = 3;
+    }
+  else
+    for (k = 0; !(x < _height[k + 1]); ++k) {}
+
+  for (int i = k + 1; i < 5; ++i) _position[i] += 1;
+  for (int i = 0; i < 5; ++i) _desired[i] += _increment[i];
+
+  // Move the middle markers by one position
+  // when they are off their desired position
+  for (int i = 1; i < 4; ++i)
+    {
+      double d = _desired[i] - _position[i];
+      if ((d >= 1 && _position[i + 1] - _position[i] > 1) ||
+	  (d <= -1 && _position[i - 1] - _position[i] < -1))
+	{
+	  int s = d > 0 ? 1 : -1;
+	  double h = parabolic(i, s);
+	  if (!(_height[i - 1] < h && h < _height[i + 1])) h = linear(i, s);
+	  _height[i] = h;
+	  _position[i] += s;
+	}
+    }
+}
+
+/**
+   The height of marker i moved by d by parabolic interpolation.
+*/
+double P2Quantile::parabolic(int i, double d) const
+{
+  const double *q = _height, *n = _position;
+
+  return q[i] + d / (n[i + 1] - n[i - 1])
+    * ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i])
+       + (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+}
+
+/**
+   The height of marker i moved by d towards marker i + d.
+*/
+double P2Quantile::linear(int i, int d) const
+{
+  return _height[i] + d * (_height[i + d] - _height[i]) / (_position[i + d] - _position[i]);
+}
+
+/**
+   The probability of the estimated quantile.
+*/
+double P2Quantile::probability() const
+{
+  return _p;
+}
+
+/**
+   Number of values.
+*/
+std::size_t P2Quantile::count() const
+{
+  return _count;
+}
+
+/**
+   The estimated quantile: the middle marker, or interpolated between
+   the sorted values while there are less than five (0 without values).
+*/
+double P2Quantile::quantile() const
+{
+  if (_count >= 5) return _height[2];
+  if (_count == 0) return 0;
+
+  double r = _p * (_count - 1);
+  std::size_t i = std::size_t(r);
+  if (i + 1 >= _count) return _height[_count - 1];
+
+  return _height[i] + (r - i) * (_height[i + 1] - _height[i]);
+}
+
+} // namespace nsl
+
+/* fin */
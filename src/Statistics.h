@@ -0,0 +1,92 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Statistics.h
+
+   Class: RunningStatistics, P2Quantile
+
+   One-pass estimators for streams of values: their memory does not
+   grow with the number of values.
+
+   RunningStatistics: mean and variance by Welford's update, which
+   avoids the cancellation of the sum of squares; two estimators are
+   merged by the formula of Chan et al.
+
+   P2Quantile: the P^2 algorithm (Jain and Chlamtac, "The P^2
+   algorithm for dynamic calculation of quantiles and histograms
+   without storing observations", CACM 1985).  Five markers follow
+   the minimum, the p/2, p, (1 + p)/2 quantiles and the maximum;
+   their heights are adjusted by piecewise parabolic interpolation.
+   The estimate depends on the order of the values.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Statistics__
+#define __Statistics__
+
+#include <cstddef>
+
+namespace nsl {
+
+// =========================================================
+// class RunningStatistics
+// ---------------------------------------------------------
+
+class RunningStatistics {
+
+  std::size_t _count = 0;
+  double _mean = 0;
+  double _m2 = 0;     // Sum of the squared differences from the mean
+  double _min = 0;
+  double _max = 0;
+
+ public:
+  void add(double x);
+  void merge(const RunningStatistics &other);
+
+  std::size_t count() const;
+  double mean() const;
+  double variance() const;
+  double deviation() const;
+  double minimum() const;
+  double maximum() const;
+};
+
+// =========================================================
+// class P2Quantile
+// ---------------------------------------------------------
+
+class P2Quantile {
+
+  double _p;
+  std::size_t _count = 0;
+
+  double _height[5];     // The marker heights (the first values until there are five)
+  double _position[5];   // The actual marker positions
+  double _desired[5];    // The desired marker positions
+  double _increment[5];  // Added to the desired positions for every value
+
+ public:
+  P2Quantile(double p = 0.5);
+
+  void add(double x);
+
+  double probability() const;
+  std::size_t count() const;
+  double quantile() const;
+
+ private:
+  double parabolic(int i, double d) const;
+  double linear(int i, int d) const;
+};
+
+} // namespace nsl
+
+#endif /* defined(__Statistics__) */
+
+/* fin */
@@ -0,0 +1,188 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Sweep.cpp
+
+   Class: BasicSweep
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include "Precision.h"
+#include "Sweep.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicSweep
+// ---------------------------------------------------------
+
+/**
+   Constructor: an empty sweep (a single point).
+*/
+template <typename Real>
+BasicSweep<Real>::BasicSweep() {}
+
+/**
+   Constructor: read the sweep file.
+*/
+template <typename Real>
+BasicSweep<Real>::BasicSweep(const std::string &file)
+{
+  std::ifstream in(file);
+  if (!in.good())
+    {
+      std::cerr << "ERROR: Could not open sweep file: " << file << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  parse(in, file);
+}
+
+/**
+   Parse the parameters and outputs (see Sweep.h).
+*/
+template <typename Real>
+void BasicSweep<Real>::parse(std::ifstream &in, const std::string &file)
+{
+  auto fail = [&file] (const std::string &what) {
+    std::cerr << "ERROR: " << file << ": " << what << std::endl;
+    exit(EXIT_FAILURE);
+  };
+
+  std::string token;
+  while (in >> token)
+    {
+      if (token.compare(0, 2, "//") == 0)
+	{
+	  // Skip the rest of the line
+	  std::getline(in, token);
+	}
+      else if (token.compare(0, 2, "/*") == 0)
+	{
+	  // Skip characters until the next "*/"
+	  if (token.size() >= 4 && token.compare(token.size() - 2, 2, "*/") == 0) continue;
+	  int c1 = in.get(), c2 = in.get();
+	  while (c2 != EOF && !(c1 == '*' && c2 == '/'))
+	    {
+	      c1 = c2;
+	      c2 = in.get();
+	    }
+	}
+      else if (token == "spring" || token == "node")
+	{
+	  int id;
+	  if (!(in >> id)) fail("Expected the tag of a " + token + ".");
+
+	  Kind kind = SPRING_CONSTANT;
+	  if (token == "node")
+	    {
+	      std::string what;
+	      in >> what;
+	      if (what == "f") kind = FORCE;
+	      else if (what == "d") kind = DISPLACEMENT;
+	      else fail("Expected d or f after node " + std::to_string(id) + ".");
+	    }
+
+	  Real from, to;
+	  long points;
+	  if (!(in >> from >> to >> points) || points < 1)
+	    fail("Expected <from> <to> <points> for " + token + " " + std::to_string(id) + ".");
+
+	  addParameter(kind, id, from, to, std::size_t(points));
+	}
+      else if (token == "output")
+	{
+	  std::string what;
+	  int id;
+	  if (!(in >> what >> id) || (what != "node" && what != "spring"))
+	    fail("Expected output node <tag> or output spring <tag>.");
+
+	  addOutput(what == "node" ? NODE : SPRING, id);
+	}
+      else
+	fail("Unexpected token: " + token);
+    }
+}
+
+/**
+   Add a parameter running from `from' to `to' in `points' equidistant values.
+*/
+template <typename Real>
+void BasicSweep<Real>::addParameter(Kind kind, int id, Real from, Real to, std::size_t points)
+{
+  _parameters.push_back({ kind, id, from, to, points });
+}
+
+/**
+   Add a result to tabulate (NODE or SPRING).
+*/
+template <typename Real>
+void BasicSweep<Real>::addOutput(Kind kind, int id)
+{
+  _outputs.push_back({ kind, id });
+}
+
+/**
+   The parameters, in the order of their definition.
+*/
+template <typename Real>
+const std::vector<typename BasicSweep<Real>::Parameter> &BasicSweep<Real>::parameters() const
+{
+  return _parameters;
+}
+
+/**
+   The results to tabulate (none: all nodes).
+*/
+template <typename Real>
+const std::vector<typename BasicSweep<Real>::Output> &BasicSweep<Real>::outputs() const
+{
+  return _outputs;
+}
+
+/**
+   Number of points: the product of the numbers of values.
+*/
+template <typename Real>
+std::size_t BasicSweep<Real>::points() const
+{
+  std::size_t n = 1;
+  for (const Parameter &parameter : _parameters) n *= parameter.points;
+
+  return n;
+}
+
+/**
+   The value of a parameter at a point.
+*/
+template <typename Real>
+Real BasicSweep<Real>::value(std::size_t parameter, std::size_t point) const
+{
+  // The values of the later parameters change faster
+  for (std::size_t j = _parameters.size(); j-- > parameter + 1; )
+    point /= _parameters[j].points;
+
+  const Parameter &p = _parameters[parameter];
+  std::size_t i = point % p.points;
+  if (p.points == 1) return p.from;
+
+  return p.from + (p.to - p.from) * Real(i) / Real(p.points - 1);
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicSweep)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,99 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Sweep.h
+
+   Class: BasicSweep, Sweep
+
+   A parameter sweep (see FEM::sweep()): spring constants, forces and
+   prescribed displacements, each running over a range of values, and
+   the results to tabulate at every point of the sweep.  The points
+   are all combinations of the values, the first parameter changing
+   slowest.
+
+   The sweep file has the syntax of the FEM definition files:
+
+     // Parameters:
+     // spring <tag> <from> <to> <points>
+     // node <tag> (d|f) <from> <to> <points>
+     // Results (default: all nodes):
+     // output node <tag>      (displacement and force)
+     // output spring <tag>    (force in the spring)
+
+     spring 2  1000 3000 5
+     node 4  f  0 10000 3
+     output node 4
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Sweep__
+#define __Sweep__
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace nsl {
+
+// =========================================================
+// class BasicSweep
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicSweep {
+
+ public:
+  enum Kind {
+    SPRING_CONSTANT,   // Parameter: the constant of a spring
+    FORCE,             // Parameter: the force at a node without prescribed displacement
+    DISPLACEMENT,      // Parameter: the prescribed displacement of a node
+    NODE,              // Output: the displacement and force at a node
+    SPRING             // Output: the force in a spring
+  };
+
+  struct Parameter {
+    Kind kind;
+    int id;            // The tag of the spring or node
+    Real from, to;
+    std::size_t points;
+  };
+
+  struct Output {
+    Kind kind;
+    int id;
+  };
+
+ private:
+  std::vector<Parameter> _parameters;
+  std::vector<Output> _outputs;
+
+ public:
+  BasicSweep();
+  explicit BasicSweep(const std::string &file);
+
+  void addParameter(Kind kind, int id, Real from, Real to, std::size_t points);
+  void addOutput(Kind kind, int id);
+
+  const std::vector<Parameter> &parameters() const;
+  const std::vector<Output> &outputs() const;
+
+  std::size_t points() const;
+  Real value(std::size_t parameter, std::size_t point) const;
+
+ private:
+  void parse(std::ifstream &in, const std::string &file);
+};
+
+typedef BasicSweep<double> Sweep;
+
+} // namespace nsl
+
+#endif /* defined(__Sweep__) */
+
+/* fin */
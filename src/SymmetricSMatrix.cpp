@@ -0,0 +1,318 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   SymmetricSMatrix.cpp
+
+   Class: BasicSymmetricSMatrix
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+
+#include "Profiler.h"
+#include "DVector.h"
+#include "DMatrix.h"
+#include "PMatrix.h"
+#include "SMatrix.h"
+#include "SymmetricSMatrix.h"
+
+namespace nsl {
+
+/**
+    Constructor: an empty (all zero) n x n matrix.
+*/
+template <typename Real>
+BasicSymmetricSMatrix<Real>::BasicSymmetricSMatrix(std::size_t n)
+  : _upper(n, n) {}
+
+/**
+    Constructor: build the matrix from (row, column, value) triplets.
+
+    Triplets below the diagonal are mirrored to (column, row); triplets
+    which end up at the same position are summed up.
+*/
+template <typename Real>
+BasicSymmetricSMatrix<Real>::BasicSymmetricSMatrix(std::size_t n, const std::vector<BasicTriplet<Real> > &triplets)
+{
+  bool lower = false;
+  for (const auto &t : triplets)
+    if (t.row > t.col) { lower = true; break; }
+
+  if (!lower)
+    {
+      _upper = BasicSMatrix<Real>(n, n, triplets);
+      return;
+    }
+
+  std::vector<BasicTriplet<Real> > mirrored(triplets);
+  for (auto &t : mirrored)
+    if (t.row > t.col) std::swap(t.row, t.col);
+  _upper = BasicSMatrix<Real>(n, n, mirrored);
+}
+
+/**
+    Constructor: the upper triangle of a full symmetric matrix.
+
+    The matrix is assumed to be symmetric: its lower triangle is ignored.
+*/
+template <typename Real>
+BasicSymmetricSMatrix<Real>::BasicSymmetricSMatrix(const BasicSMatrix<Real> &full)
+  : _upper(full.rows(), full.cols())
+{
+  assert(full.rows() == full.cols());
+
+  BasicSMatrix<Real> &u = _upper;
+  for (std::size_t i = 0; i < full.rows(); ++i)
+    {
+      for (std::size_t k = full._rowStart[i]; k < full._rowStart[i + 1]; ++k)
+	if (full._colIndex[k] >= i)
+	  {
+	    u._colIndex.push_back(full._colIndex[k]);
+	    u._values.push_back(full._values[k]);
+	  }
+      u._rowStart[i + 1] = u._colIndex.size();
+    }
+
+  Profiler::countAllocation(u._rowStart.size() * sizeof(std::size_t) +
+			    u._colIndex.size() * sizeof(std::size_t) +
+			    u._values.size() * sizeof(Real));
+}
+
+/**
+   Number of columns.
+*/
+template <typename Real>
+std::size_t BasicSymmetricSMatrix<Real>::cols() const
+{
+  return _upper.cols();
+}
+
+/**
+   Number of rows.
+*/
+template <typename Real>
+std::size_t BasicSymmetricSMatrix<Real>::rows() const
+{
+  return _upper.rows();
+}
+
+/**
+   Number of stored elements (the upper triangle only).
+*/
+template <typename Real>
+std::size_t BasicSymmetricSMatrix<Real>::nnz() const
+{
+  return _upper.nnz();
+}
+
+/**
+   Constant element accessor.
+
+   Elements which are not stored are 0.
+*/
+template <typename Real>
+Real BasicSymmetricSMatrix<Real>::operator() (std::size_t row, std::size_t col) const
+{
+  return row <= col ? _upper(row, col) : _upper(col, row);
+}
+
+/**
+   Stored element: (row, column) and (column, row) are the same
+   element.  Unlike operator(), the element has to be stored: the
+   pattern of the matrix does not change.
+*/
+template <typename Real>
+Real &BasicSymmetricSMatrix<Real>::element(std::size_t row, std::size_t col)
+{
+  return _upper._values[position(row, col)];
+}
+
+/**
+   The position of the stored element (row, column) or (column, row)
+   in the values of the upper triangle (see values()).
+*/
+template <typename Real>
+std::size_t BasicSymmetricSMatrix<Real>::position(std::size_t row, std::size_t col) const
+{
+  assert(row < rows());
+  assert(col < cols());
+
+  if (row > col) std::swap(row, col);
+
+  const BasicSMatrix<Real> &u = _upper;
+  std::vector<std::size_t>::const_iterator begin = u._colIndex.begin() + u._rowStart[row];
+  std::vector<std::size_t>::const_iterator end   = u._colIndex.begin() + u._rowStart[row + 1];
+  std::vector<std::size_t>::const_iterator it    = std::lower_bound(begin, end, col);
+
+  if (it == end || *it != col)
+    {
+      std::cerr << "ERROR The element (" << row << ", " << col << ") is not stored!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  return it - u._colIndex.begin();
+}
+
+/**
+   The values of the stored elements, row by row: they can be
+   changed, the pattern stays the same.
+*/
+template <typename Real>
+std::vector<Real> &BasicSymmetricSMatrix<Real>::values()
+{
+  return _upper._values;
+}
+
+/**
+   The stored upper triangle (column >= row).
+*/
+template <typename Real>
+const BasicSMatrix<Real> &BasicSymmetricSMatrix<Real>::upper() const
+{
+  return _upper;
+}
+
+/**
+   Expand to a full CSR matrix (both triangles).
+
+   Row i of the full matrix is the mirrored column i of the upper
+   triangle followed by row i of the upper triangle.  Walking the
+   rows in order appends the mirrored entries of every row before
+   its own ones, so that the columns stay sorted.
+*/
+template <typename Real>
+BasicSMatrix<Real> BasicSymmetricSMatrix<Real>::toFull() const
+{
+  const BasicSMatrix<Real> &u = _upper;
+  std::size_t n = u.rows();
+
+  BasicSMatrix<Real> f(n, n);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = u._rowStart[i]; k < u._rowStart[i + 1]; ++k)
+      {
+	++f._rowStart[i + 1];
+	if (u._colIndex[k] != i) ++f._rowStart[u._colIndex[k] + 1];
+      }
+  for (std::size_t i = 0; i < n; ++i)
+    f._rowStart[i + 1] += f._rowStart[i];
+
+  f._colIndex.resize(f._rowStart[n]);
+  f._values.resize(f._rowStart[n]);
+  std::vector<std::size_t> next(f._rowStart.begin(), f._rowStart.end() - 1);
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = u._rowStart[i]; k < u._rowStart[i + 1]; ++k)
+      {
+	std::size_t j = u._colIndex[k];
+	std::size_t q = next[i]++;
+	f._colIndex[q] = j;
+	f._values[q] = u._values[k];
+	if (j != i)
+	  {
+	    q = next[j]++;
+	    f._colIndex[q] = i;
+	    f._values[q] = u._values[k];
+	  }
+      }
+
+  Profiler::countAllocation(f._rowStart.size() * sizeof(std::size_t) +
+			    f._colIndex.size() * sizeof(std::size_t) +
+			    f._values.size() * sizeof(Real));
+
+  return f;
+}
+
+/**
+   Convert to a dense matrix (both triangles).
+*/
+template <typename Real>
+BasicMatrix<Real> BasicSymmetricSMatrix<Real>::toDense() const
+{
+  const BasicSMatrix<Real> &u = _upper;
+
+  BasicMatrix<Real> m(u.rows(), u.cols());
+  for (std::size_t row = 0; row < u.rows(); ++row)
+    for (std::size_t k = u._rowStart[row]; k < u._rowStart[row + 1]; ++k)
+      m(row, u._colIndex[k]) = m(u._colIndex[k], row) = u._values[k];
+
+  return m;
+}
+
+/**
+   Convert to a dense matrix in packed storage.
+*/
+template <typename Real>
+BasicPackedMatrix<Real> BasicSymmetricSMatrix<Real>::toPacked() const
+{
+  const BasicSMatrix<Real> &u = _upper;
+
+  BasicPackedMatrix<Real> m(u.rows());
+  for (std::size_t row = 0; row < u.rows(); ++row)
+    for (std::size_t k = u._rowStart[row]; k < u._rowStart[row + 1]; ++k)
+      m(row, u._colIndex[k]) = u._values[k];
+
+  return m;
+}
+
+/**
+   Multiplication operator: SymmetricSMatrix * DVector -> DVector
+
+   Every stored off-diagonal element contributes to two rows: row i
+   by the usual row product, row j by a scatter.
+*/
+template <typename Real>
+BasicVector<Real> operator* (const BasicSymmetricSMatrix<Real> &m, const BasicVector<Real> &v)
+{
+  assert(m.cols() == v.size());
+
+  const BasicSMatrix<Real> &u = m._upper;
+  const Real *vv = v.span().data();
+  std::vector<Real> r(u.rows(), 0.0);
+  for (std::size_t i = 0; i < u.rows(); ++i)
+    {
+      Real s = 0;
+      for (std::size_t k = u.rowStart()[i]; k < u.rowStart()[i + 1]; ++k)
+	{
+	  std::size_t j = u.colIndex()[k];
+	  s += u.values()[k] * vv[j];
+	  if (j != i) r[j] += u.values()[k] * vv[i];
+	}
+      r[i] += s;
+    }
+
+  Profiler::countFlops(4 * u.nnz());
+
+  return BasicVector<Real>(r);
+}
+
+/**
+      os <<
+*/
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSymmetricSMatrix<Real>& m)
+{
+  return os << m._upper;
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicSymmetricSMatrix)
+
+#define INSTANTIATE(Real)						\
+  template BasicVector<Real> operator* (const BasicSymmetricSMatrix<Real> &m, const BasicVector<Real> &v); \
+  template std::ostream& operator<<(std::ostream& os, const BasicSymmetricSMatrix<Real>& m);
+
+NSL_FOR_EACH_REAL(INSTANTIATE)
+
+} // namespace nsl
+
+/* fin */
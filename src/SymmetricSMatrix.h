@@ -0,0 +1,84 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   SymmetricSMatrix.h
+
+   Class: BasicSymmetricSMatrix, SymmetricSMatrix
+
+   Symmetric sparse matrix: only the upper triangle (column >= row)
+   is stored, as a CSR matrix (see SMatrix.h).  A(i, j) and A(j, i)
+   are the same element.  Used for the stiffness matrices: it needs
+   about half the memory of the full matrix and the direct solvers
+   factorize it without expanding it (see
+   BasicLinearSolver::factorSymmetric()).
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __SymmetricSMatrix__
+#define __SymmetricSMatrix__
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+#include "DVector.h"
+#include "DMatrix.h"
+#include "PMatrix.h"
+#include "SMatrix.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicSymmetricSMatrix
+// ---------------------------------------------------------
+
+template <typename Real> class BasicSymmetricSMatrix;
+
+template <typename Real>
+BasicVector<Real> operator* (const BasicSymmetricSMatrix<Real> &m, const BasicVector<Real> &v);
+template <typename Real>
+std::ostream& operator<<(std::ostream& os, const BasicSymmetricSMatrix<Real>& m);
+
+template <typename Real>
+class BasicSymmetricSMatrix {
+
+  BasicSMatrix<Real> _upper;
+
+ public:
+
+  BasicSymmetricSMatrix(std::size_t n = 0);
+  BasicSymmetricSMatrix(std::size_t n, const std::vector<BasicTriplet<Real> > &triplets);
+  explicit BasicSymmetricSMatrix(const BasicSMatrix<Real> &full);
+
+  std::size_t cols() const;
+  std::size_t rows() const;
+  std::size_t nnz() const;
+
+  Real operator() (std::size_t row, std::size_t column) const;
+  Real &element(std::size_t row, std::size_t column);
+  std::size_t position(std::size_t row, std::size_t column) const;
+  std::vector<Real> &values();
+
+  const BasicSMatrix<Real> &upper() const;
+
+  BasicSMatrix<Real> toFull() const;
+  BasicMatrix<Real> toDense() const;
+  BasicPackedMatrix<Real> toPacked() const;
+
+  friend BasicVector<Real> operator* <>(const BasicSymmetricSMatrix &m, const BasicVector<Real> &v);
+
+  friend std::ostream& operator<< <>(std::ostream& os, const BasicSymmetricSMatrix& m);
+};
+
+typedef BasicSymmetricSMatrix<double> SymmetricSMatrix;
+
+} // namespace nsl
+
+#endif /* defined(__SymmetricSMatrix__) */
+
+/* fin */
@@ -0,0 +1,178 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ThreadPool.cpp
+
+   Class: ThreadPool
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "Trace.h"
+#include "ThreadPool.h"
+
+namespace nsl {
+
+// =========================================================
+// Class ThreadPool
+// ---------------------------------------------------------
+
+/** 
+    Constructor.
+
+    With threads == 0 one thread per hardware thread is used.  The
+    calling thread takes part in the parallel loops, so only
+    threads - 1 workers are started.
+*/
+ThreadPool::ThreadPool(std::size_t threads) : _stop(false)
+{
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+
+  for (std::size_t i = 1; i < threads; ++i)
+    _workers.push_back(std::thread(&ThreadPool::work, this));
+}
+
+/** 
+    Destructor.
+*/
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _condition.notify_all();
+  
+  for (auto &worker : _workers)
+    worker.join();
+}
+
+// =========================================================
+// Methods
+// ---------------------------------------------------------
+
+/**
+   The thread pool shared by the whole program.
+*/
+ThreadPool &ThreadPool::instance()
+{
+  static ThreadPool pool;
+
+  return pool;
+}
+
+/**
+   Number of threads taking part in a parallel loop.
+*/
+std::size_t ThreadPool::size() const
+{
+  return _workers.size() + 1;
+}
+
+/**
+   Call body(begin, end) for consecutive chunks of [0, n).
+
+   The chunks have at least `grain' elements; when n is not larger
+   than grain, body(0, n) is called in the current thread.  Returns
+   after all chunks have been processed.
+*/
+void ThreadPool::parallelFor(std::size_t n, std::size_t grain,
+			     const std::function<void (std::size_t begin, std::size_t end)> &body)
+{
+  if (n == 0) return;
+
+  // Chunk size: at least `grain', at most 4 chunks per thread
+  std::size_t chunks = std::max<std::size_t>(1, std::min(n / std::max<std::size_t>(1, grain), 4 * size()));
+  if (chunks == 1 || _workers.empty())
+    {
+      body(0, n);
+      return;
+    }
+  std::size_t chunkSize = (n + chunks - 1) / chunks;
+  chunks = (n + chunkSize - 1) / chunkSize;
+
+  // The chunks still to be finished
+  std::shared_ptr<std::atomic<std::size_t> > pending(new std::atomic<std::size_t>(chunks));
+  
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (std::size_t c = 1; c < chunks; ++c)
+      {
+	std::size_t begin = c * chunkSize;
+	std::size_t end = std::min(n, begin + chunkSize);
+	_tasks.push_back([&body, begin, end, pending] () { 
+	    {
+	      TraceScope scope("thread pool task");
+	      body(begin, end); 
+	    }
+	    --*pending;
+	  });
+      }
+  }
+  _condition.notify_all();
+
+  // The first chunk is processed by the calling thread
+  {
+    TraceScope scope("thread pool task");
+    body(0, std::min(n, chunkSize));
+  }
+  --*pending;
+  
+  // Help with the pending tasks until all chunks are done
+  while (*pending > 0)
+    if (!runPendingTask())
+      std::this_thread::yield();
+}
+
+/**
+   Worker thread main loop.
+*/
+void ThreadPool::work()
+{
+  for (;;)
+    {
+      std::function<void ()> task;
+      {
+	std::unique_lock<std::mutex> lock(_mutex);
+	_condition.wait(lock, [this] () { return _stop || !_tasks.empty(); });
+	if (_stop && _tasks.empty()) return;
+
+	task = std::move(_tasks.front());
+	_tasks.pop_front();
+      }
+      task();
+    }
+}
+
+/**
+   Run one pending task in the current thread.
+
+   Returns false if no task was pending.
+*/
+bool ThreadPool::runPendingTask()
+{
+  std::function<void ()> task;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_tasks.empty()) return false;
+
+    task = std::move(_tasks.front());
+    _tasks.pop_front();
+  }
+  task();
+
+  return true;
+}
+
+} // namespace nsl
+
+/* fin */
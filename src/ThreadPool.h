@@ -0,0 +1,69 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ThreadPool.h
+
+   Class: ThreadPool
+
+   A fixed set of worker threads executing the chunks of parallel
+   loops.  A thread waiting for a parallel loop to finish executes
+   pending chunks itself, so parallel loops can be nested.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __ThreadPool__
+#define __ThreadPool__
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace nsl {
+
+// =========================================================
+// class ThreadPool
+// ---------------------------------------------------------
+
+class ThreadPool {
+
+  std::vector<std::thread> _workers;
+  std::deque<std::function<void ()> > _tasks;
+  
+  std::mutex _mutex;
+  std::condition_variable _condition;
+  bool _stop;
+
+ public:
+
+  ThreadPool(std::size_t threads = 0);
+  ~ThreadPool();
+
+  static ThreadPool &instance();
+
+  std::size_t size() const;
+
+  void parallelFor(std::size_t n, std::size_t grain,
+		   const std::function<void (std::size_t begin, std::size_t end)> &body);
+
+ private:
+  ThreadPool(const ThreadPool &);
+  ThreadPool &operator= (const ThreadPool &);
+
+  void work();
+  bool runPendingTask();
+};
+
+} // namespace nsl
+
+#endif /* defined(__ThreadPool__) */
+
+/* fin */
@@ -0,0 +1,149 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Trace.cpp
+
+   Class: Trace
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+
+#include "Trace.h"
+
+namespace nsl {
+
+namespace {
+
+/**
+   A recorded event.
+*/
+struct Event {
+  const char *name;
+  char phase;          // 'B' (begin) or 'E' (end)
+  std::uint64_t time;  // Nanoseconds since the start of the trace
+};
+
+/**
+   The ring buffer of a thread.
+   
+   Only the owning thread writes into it.
+*/
+struct Buffer {
+  std::size_t tid;
+  std::vector<Event> events;
+  std::atomic<std::size_t> recorded;  // Number of events recorded so far
+  Buffer *next;                       // Next buffer in the list of all buffers
+};
+
+// The list of all buffers (a buffer is never removed)
+std::atomic<Buffer *> buffers(nullptr);
+std::atomic<std::size_t> numberOfBuffers(0);
+
+// The buffer of the current thread
+thread_local Buffer *threadBuffer = nullptr;
+
+// Start of the trace
+std::chrono::steady_clock::time_point start;
+
+/**
+   Create the buffer of the current thread
+   and push it onto the list of all buffers.
+*/
+Buffer *createBuffer(std::size_t capacity)
+{
+  Buffer *buffer = new Buffer;
+  buffer->tid = numberOfBuffers.fetch_add(1);
+  buffer->events.resize(capacity);
+  buffer->recorded = 0;
+  
+  buffer->next = buffers.load();
+  while (!buffers.compare_exchange_weak(buffer->next, buffer))
+    ;
+
+  return buffer;
+}
+
+} // namespace
+
+// =========================================================
+// Class Trace
+// ---------------------------------------------------------
+
+bool Trace::_enabled = false;
+std::size_t Trace::_capacity = 0;
+
+/**
+   Switch tracing on.
+
+   eventsPerThread is the size of the ring buffer of each thread.
+*/
+void Trace::enable(std::size_t eventsPerThread)
+{
+  start     = std::chrono::steady_clock::now();
+  _capacity = eventsPerThread > 0 ? eventsPerThread : 1;
+  _enabled  = true;
+}
+
+/**
+   Record an event in the ring buffer of the current thread.
+*/
+void Trace::record(const char *name, char phase)
+{
+  if (!threadBuffer)
+    threadBuffer = createBuffer(_capacity);
+
+  std::uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>
+    (std::chrono::steady_clock::now() - start).count();
+
+  std::size_t i = threadBuffer->recorded.load(std::memory_order_relaxed);
+  Event &event = threadBuffer->events[i % threadBuffer->events.size()];
+  event.name  = name;
+  event.phase = phase;
+  event.time  = time;
+  threadBuffer->recorded.store(i + 1, std::memory_order_release);
+}
+
+/**
+   Write all recorded events in the Chrome trace event format.
+*/
+void Trace::write(std::ostream &os)
+{
+  os << "{\"traceEvents\": [";
+
+  bool first = true;
+  for (Buffer *buffer = buffers.load(); buffer; buffer = buffer->next)
+    {
+      std::size_t recorded = buffer->recorded.load(std::memory_order_acquire);
+      std::size_t capacity = buffer->events.size();
+      std::size_t begin    = recorded > capacity ? recorded - capacity : 0;
+
+      for (std::size_t i = begin; i < recorded; ++i)
+	{
+	  const Event &event = buffer->events[i % capacity];
+	  
+	  os << (first ? "" : ",") << std::endl
+	     << "  {\"name\": \"" << event.name << "\""
+	     << ", \"ph\": \"" << event.phase << "\""
+	     << ", \"ts\": " << std::fixed << std::setprecision(3) << event.time / 1e3
+	     << ", \"pid\": 1, \"tid\": " << buffer->tid << "}";
+	  first = false;
+	}
+    }
+  os.unsetf(std::ios_base::floatfield);
+  
+  os << std::endl << "]}" << std::endl;
+}
+
+} // namespace nsl
+
+/* fin */
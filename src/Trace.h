@@ -0,0 +1,119 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Trace.h
+
+   Class: Trace, TraceScope
+
+   Records begin / end events of the program stages and of the
+   thread pool tasks and writes them in the Chrome trace event format
+   (readable by chrome://tracing and Perfetto).
+
+   Each thread writes into its own ring buffer; recording an event
+   takes no lock.  When a buffer is full the oldest events of the
+   thread are overwritten.  The buffers must only be written out
+   (Trace::write()) when no other thread is recording anymore, for
+   example at the end of the program.
+
+   Event names have to be string literals (or otherwise live until
+   the trace has been written).
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __Trace__
+#define __Trace__
+
+#include <cstddef>
+#include <iostream>
+
+namespace nsl {
+
+// =========================================================
+// class Trace
+// ---------------------------------------------------------
+
+class Trace {
+
+  static bool _enabled;
+  static std::size_t _capacity;
+
+ public:
+  static void enable(std::size_t eventsPerThread = 1 << 16);
+  static bool enabled();
+
+  static void begin(const char *name);
+  static void end(const char *name);
+
+  static void write(std::ostream &os);
+
+ private:
+  static void record(const char *name, char phase);
+};
+
+// =========================================================
+// class TraceScope
+// ---------------------------------------------------------
+
+/**
+   Records a begin event on construction 
+   and the matching end event on destruction.
+*/
+class TraceScope {
+
+  const char *_name;
+  bool _active;
+
+ public:
+  TraceScope(const char *name) : _name(name), _active(Trace::enabled())
+  {
+    if (_active) Trace::begin(_name);
+  }
+  
+  ~TraceScope()
+  {
+    if (_active) Trace::end(_name);
+  }
+
+ private:
+  TraceScope(const TraceScope &);
+  TraceScope &operator= (const TraceScope &);
+};
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   True when tracing is switched on.
+*/
+inline bool Trace::enabled()
+{
+  return _enabled;
+}
+
+/**
+   Record a begin event in the current thread.
+*/
+inline void Trace::begin(const char *name)
+{
+  record(name, 'B');
+}
+
+/**
+   Record an end event in the current thread.
+*/
+inline void Trace::end(const char *name)
+{
+  record(name, 'E');
+}
+
+} // namespace nsl
+
+#endif /* defined(__Trace__) */
+
+/* fin */
@@ -0,0 +1,111 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   TreeCGSolver.cpp
+
+   Class: BasicTreeCGSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cmath>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "UnionFind.h"
+#include "TreeCGSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// Class BasicTreeCGSolver
+// ---------------------------------------------------------
+
+/**
+   The preconditioner: the off-diagonal elements of a maximum weight
+   spanning forest of the matrix graph and the full diagonal.
+*/
+template <typename Real>
+BasicSMatrix<Real> BasicTreeCGSolver<Real>::spanningTree(const BasicSMatrix<Real> &matrix)
+{
+  std::size_t n = matrix.rows();
+
+  // The off-diagonal elements of the upper triangle by decreasing weight
+  std::vector<std::size_t> rowOf;
+  std::vector<std::size_t> upper;
+  for (std::size_t i = 0; i < n; ++i)
+    for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+      if (matrix.colIndex()[k] > i)
+	{
+	  rowOf.push_back(i);
+	  upper.push_back(k);
+	}
+  std::vector<std::size_t> order(upper.size());
+  for (std::size_t e = 0; e < order.size(); ++e) order[e] = e;
+  const std::vector<Real> &values = matrix.values();
+  std::stable_sort(order.begin(), order.end(), [&] (std::size_t e1, std::size_t e2) {
+      return std::fabs(values[upper[e1]]) > std::fabs(values[upper[e2]]);
+    });
+
+  // Kruskal's algorithm
+  std::vector<BasicTriplet<Real>> triplets;
+  triplets.reserve(3 * n);
+  for (std::size_t i = 0; i < n; ++i)
+    triplets.push_back({ i, i, matrix(i, i) });
+  UnionFind forest(n);
+  for (std::size_t e : order)
+    {
+      std::size_t i = rowOf[e];
+      std::size_t j = matrix.colIndex()[upper[e]];
+      Real value = values[upper[e]];
+      if (forest.unite(i, j))
+	{
+	  triplets.push_back({ i, j, value });
+	  triplets.push_back({ j, i, value });
+	}
+    }
+
+  return BasicSMatrix<Real>(n, n, triplets);
+}
+
+template <typename Real>
+LinearSolverBase::Type BasicTreeCGSolver<Real>::type() const
+{
+  return LinearSolverBase::TREE_CG;
+}
+
+/**
+   Keep the matrix (see CGSolver::factor())
+   and factorize the spanning tree preconditioner.
+*/
+template <typename Real>
+void BasicTreeCGSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  BasicCGSolver<Real>::factor(matrix);
+
+  ScopedTimer timer("spanning tree");
+  _tree.factor(spanningTree(matrix));
+}
+
+/**
+   Solve B z = r with the spanning tree preconditioner B.
+*/
+template <typename Real>
+void BasicTreeCGSolver<Real>::precondition(const std::vector<Real> &r, std::vector<Real> &z) const
+{
+  _tree.solve(r.data(), z.data());
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicTreeCGSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,70 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   TreeCGSolver.h
+
+   Class: BasicTreeCGSolver, TreeCGSolver
+
+   Conjugate gradients preconditioned with a maximum weight spanning
+   tree of the matrix graph.
+
+   The stiffness matrix of a spring assemblage is a weighted graph
+   Laplacian (off-diagonal elements -k, diagonal elements the sum of
+   the incident k) plus the springs to the constrained nodes on the
+   diagonal.  The preconditioner B keeps the diagonal and the
+   off-diagonal elements of a spanning forest chosen by decreasing
+   stiffness (Kruskal's algorithm); the other springs are only
+   represented on the diagonal.  B is solved exactly in linear time
+   by the TreeSolver.  Without any springs in the forest, B would be
+   the Jacobi preconditioner.
+
+   The strongest springs, which make the matrix ill-conditioned, are
+   all represented in B.  For networks whose spring constants vary
+   over orders of magnitude this takes far fewer iterations than
+   Jacobi preconditioning.  (Dropping the other springs from the
+   diagonal as well, as in Vaidya's preconditioners, took several
+   times more iterations on our networks.)
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __TreeCGSolver__
+#define __TreeCGSolver__
+
+#include <vector>
+
+#include "CGSolver.h"
+#include "TreeSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicTreeCGSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicTreeCGSolver : public BasicCGSolver<Real> {
+
+  BasicTreeSolver<Real> _tree;
+
+ public:
+  static BasicSMatrix<Real> spanningTree(const BasicSMatrix<Real> &matrix);
+
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+
+ protected:
+  void precondition(const std::vector<Real> &r, std::vector<Real> &z) const;
+};
+
+typedef BasicTreeCGSolver<double> TreeCGSolver;
+
+} // namespace nsl
+
+#endif /* defined(__TreeCGSolver__) */
+
+/* fin */
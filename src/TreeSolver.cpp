@@ -0,0 +1,271 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   TreeSolver.cpp
+
+   Class: BasicTreeSolver
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <iostream>
+#include <algorithm>
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+#include "UnionFind.h"
+#include "TreeSolver.h"
+
+namespace nsl {
+
+namespace {
+
+// Subtrees with up to this many nodes are not split any further
+const std::size_t minTaskSize = 16 * 1024;
+
+} // namespace
+
+// =========================================================
+// Class BasicTreeSolver
+// ---------------------------------------------------------
+
+/**
+   True when the graph of the matrix has no cycles.  Stored zeros
+   (springs without stiffness) are no edges.
+*/
+template <typename Real>
+bool BasicTreeSolver<Real>::isForest(const BasicSMatrix<Real> &matrix)
+{
+  UnionFind sets(matrix.rows());
+  for (std::size_t i = 0; i < matrix.rows(); ++i)
+    for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+      if (matrix.colIndex()[k] > i && matrix.values()[k] != 0 && !sets.unite(i, matrix.colIndex()[k]))
+	return false;
+
+  return true;
+}
+
+template <typename Real>
+LinearSolverBase::Type BasicTreeSolver<Real>::type() const
+{
+  return LinearSolverBase::TREE;
+}
+
+/**
+   Root the trees, split them into independent subtrees
+   and eliminate the nodes from the leaves towards the roots.
+*/
+template <typename Real>
+void BasicTreeSolver<Real>::factor(const BasicSMatrix<Real> &matrix)
+{
+  ScopedTimer timer("tree factorization");
+
+  if (!isForest(matrix))
+    {
+      std::cerr
+	<< "ERROR The tree solver cannot solve this matrix!" << std::endl
+	<< std::endl
+	<< "The assemblage contains cycles: use another solver." << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  _n = matrix.rows();
+  const std::size_t none = _n;
+
+  // =====================================
+  // Root the trees: breadth first search from the first node of every tree
+  // -------------------------------------
+
+  std::vector<Real> diagonal(_n, 0.0), coupling(_n, 0.0);
+  std::vector<std::size_t> order;
+  order.reserve(_n);
+  _parent.assign(_n, none);
+  std::vector<char> visited(_n, 0);
+  for (std::size_t root = 0; root < _n; ++root)
+    {
+      if (visited[root]) continue;
+
+      visited[root] = 1;
+      order.push_back(root);
+      for (std::size_t q = order.size() - 1; q < order.size(); ++q)
+	{
+	  std::size_t i = order[q];
+	  for (std::size_t k = matrix.rowStart()[i]; k < matrix.rowStart()[i + 1]; ++k)
+	    {
+	      std::size_t j = matrix.colIndex()[k];
+	      if (j == i)
+		diagonal[i] = matrix.values()[k];
+	      else if (!visited[j] && matrix.values()[k] != 0)
+		{
+		  visited[j] = 1;
+		  _parent[j] = i;
+		  coupling[j] = matrix.values()[k];
+		  order.push_back(j);
+		}
+	    }
+	}
+    }
+
+  // The children of every node
+  _childStart.assign(_n + 1, 0);
+  for (std::size_t i = 0; i < _n; ++i)
+    if (_parent[i] != none) ++_childStart[_parent[i] + 1];
+  for (std::size_t i = 0; i < _n; ++i)
+    _childStart[i + 1] += _childStart[i];
+  _children.resize(_childStart[_n]);
+  std::vector<std::size_t> next(_childStart.begin(), _childStart.end() - 1);
+  for (std::size_t i : order)
+    if (_parent[i] != none) _children[next[_parent[i]]++] = i;
+
+  // =====================================
+  // Split the trees into independent subtrees
+  // -------------------------------------
+
+  // The size of the subtree below every node
+  std::vector<std::size_t> size(_n, 1);
+  for (std::size_t q = _n; q-- > 0; )
+    if (_parent[order[q]] != none) size[_parent[order[q]]] += size[order[q]];
+
+  // Maximal subtrees up to the threshold become tasks
+  std::size_t threshold = std::max(minTaskSize, _n / (4 * ThreadPool::instance().size()));
+  std::vector<std::size_t> task(_n, none);
+  std::vector<std::size_t> taskSize;
+  for (std::size_t i : order)
+    {
+      std::size_t p = _parent[i];
+      if (p != none && task[p] != none)
+	task[i] = task[p];
+      else if (size[i] <= threshold)
+	{
+	  task[i] = taskSize.size();
+	  taskSize.push_back(0);
+	}
+      if (task[i] != none) ++taskSize[task[i]];
+    }
+
+  _taskStart.assign(taskSize.size() + 1, 0);
+  for (std::size_t t = 0; t < taskSize.size(); ++t)
+    _taskStart[t + 1] = _taskStart[t] + taskSize[t];
+  _taskNodes.resize(_taskStart.back());
+  _topNodes.clear();
+  next.assign(_taskStart.begin(), _taskStart.end() - 1);
+  for (std::size_t i : order)
+    if (task[i] == none)
+      _topNodes.push_back(i);
+    else
+      _taskNodes[next[task[i]]++] = i;
+
+  // =====================================
+  // Eliminate the nodes from the leaves towards the roots
+  // -------------------------------------
+
+  _pivot.assign(_n, 0.0);
+  _multiplier.assign(_n, 0.0);
+
+  ThreadPool::instance().parallelFor(taskSize.size(), 1, [&] (std::size_t begin, std::size_t end) {
+      for (std::size_t t = begin; t < end; ++t)
+	for (std::size_t q = _taskStart[t + 1]; q-- > _taskStart[t]; )
+	  eliminate(_taskNodes[q], diagonal, coupling);
+    });
+  for (std::size_t q = _topNodes.size(); q-- > 0; )
+    eliminate(_topNodes[q], diagonal, coupling);
+
+  Profiler::countFlops(3 * _n);
+}
+
+/**
+   Eliminate node i after all of its children.
+*/
+template <typename Real>
+void BasicTreeSolver<Real>::eliminate(std::size_t i, const std::vector<Real> &diagonal,
+			   const std::vector<Real> &coupling)
+{
+  Real d = diagonal[i];
+  for (std::size_t k = _childStart[i]; k < _childStart[i + 1]; ++k)
+    {
+      std::size_t c = _children[k];
+      d -= _multiplier[c] * coupling[c];
+    }
+
+  if (d <= 0)
+    {
+      std::cerr
+	<< "ERROR The matrix is not solvable!" << std::endl
+	<< std::endl
+	<< "The stiffness matrix is not positive definite (pivot " << i << ": " << d << ")." << std::endl
+	<< "Is there a part of the assemblage without prescribed displacement?" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
+  _pivot[i] = d;
+  _multiplier[i] = coupling[i] / d;
+}
+
+/**
+   Solve the system: forward substitution from the leaves
+   to the roots, back substitution from the roots to the leaves.
+*/
+template <typename Real>
+BasicVector<Real> BasicTreeSolver<Real>::solve(const BasicVector<Real> &b) const
+{
+  std::vector<Real> v(_n);
+  solve(b.span().data(), v.data());
+
+  return BasicVector<Real>(v);
+}
+
+/**
+   Solve the system for the right hand side b[0 ... n - 1]
+   into x[0 ... n - 1] (b and x may be the same).
+*/
+template <typename Real>
+void BasicTreeSolver<Real>::solve(const Real *b, Real *x) const
+{
+  const std::size_t none = _n;
+
+  // L y = b
+  auto forward = [&] (std::size_t i) {
+    Real s = b[i];
+    for (std::size_t k = _childStart[i]; k < _childStart[i + 1]; ++k)
+      s -= _multiplier[_children[k]] * x[_children[k]];
+    x[i] = s;
+  };
+
+  // D L^T x = y
+  auto backward = [&] (std::size_t i) {
+    x[i] /= _pivot[i];
+    if (_parent[i] != none) x[i] -= _multiplier[i] * x[_parent[i]];
+  };
+
+  std::size_t tasks = _taskStart.size() - 1;
+  ThreadPool::instance().parallelFor(tasks, 1, [&] (std::size_t begin, std::size_t end) {
+      for (std::size_t t = begin; t < end; ++t)
+	for (std::size_t q = _taskStart[t + 1]; q-- > _taskStart[t]; )
+	  forward(_taskNodes[q]);
+    });
+  for (std::size_t q = _topNodes.size(); q-- > 0; )
+    forward(_topNodes[q]);
+
+  for (std::size_t i : _topNodes)
+    backward(i);
+  ThreadPool::instance().parallelFor(tasks, 1, [&] (std::size_t begin, std::size_t end) {
+      for (std::size_t t = begin; t < end; ++t)
+	for (std::size_t q = _taskStart[t]; q < _taskStart[t + 1]; ++q)
+	  backward(_taskNodes[q]);
+    });
+  Profiler::countFlops(5 * _n);
+}
+
+// =========================================================
+// Explicit instantiations
+// ---------------------------------------------------------
+
+NSL_INSTANTIATE(BasicTreeSolver)
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,87 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   TreeSolver.h
+
+   Class: BasicTreeSolver, TreeSolver
+
+   Direct solver for symmetric positive definite matrices whose graph
+   is a forest - the stiffness matrices of tree-shaped assemblages
+   after the constrained nodes have been removed.
+
+   Every tree is rooted and its nodes are eliminated from the leaves
+   towards the root: the pivot of a node is its diagonal element
+   minus the contributions of its (already eliminated) children
+
+     d(i) = K(i, i) - sum over the children c of K(c, i)^2 / d(c)
+
+   This is an L D L^T factorization without any fill-in; factorization
+   and solution take O(n) operations and memory.
+
+   Independent subtrees are eliminated concurrently on the thread
+   pool: the subtrees below a size threshold are processed as tasks,
+   the nodes above them (near the roots) sequentially afterwards.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __TreeSolver__
+#define __TreeSolver__
+
+#include <vector>
+
+#include "LinearSolver.h"
+
+namespace nsl {
+
+// =========================================================
+// class BasicTreeSolver
+// ---------------------------------------------------------
+
+template <typename Real>
+class BasicTreeSolver : public BasicLinearSolver<Real> {
+
+  std::size_t _n = 0;
+
+  // The parent of each node (_n for the roots)
+  // and its children: [_childStart[i], _childStart[i + 1]) in _children
+  std::vector<std::size_t> _parent;
+  std::vector<std::size_t> _childStart;
+  std::vector<std::size_t> _children;
+
+  // The pivots d(i) and the multipliers l(i) = K(i, parent) / d(i)
+  std::vector<Real> _pivot;
+  std::vector<Real> _multiplier;
+
+  // The subtrees processed as independent tasks,
+  // each in breadth first order: [_taskStart[t], _taskStart[t + 1]) in _taskNodes
+  std::vector<std::size_t> _taskStart;
+  std::vector<std::size_t> _taskNodes;
+
+  // The remaining nodes near the roots in breadth first order
+  std::vector<std::size_t> _topNodes;
+
+ public:
+  static bool isForest(const BasicSMatrix<Real> &matrix);
+
+  LinearSolverBase::Type type() const;
+  void factor(const BasicSMatrix<Real> &matrix);
+  BasicVector<Real> solve(const BasicVector<Real> &b) const;
+  void solve(const Real *b, Real *x) const;
+
+ private:
+  void eliminate(std::size_t i, const std::vector<Real> &diagonal,
+		 const std::vector<Real> &coupling);
+};
+
+typedef BasicTreeSolver<double> TreeSolver;
+
+} // namespace nsl
+
+#endif /* defined(__TreeSolver__) */
+
+/* fin */
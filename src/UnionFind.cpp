@@ -0,0 +1,79 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   UnionFind.cpp
+
+   Class: UnionFind
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <utility>
+
+#include "UnionFind.h"
+
+namespace nsl {
+
+// =========================================================
+// Class UnionFind
+// ---------------------------------------------------------
+
+/**
+   Constructor: n singleton sets.
+*/
+UnionFind::UnionFind(std::size_t n)
+  : _parent(n), _size(n, 1), _sets(n)
+{
+  for (std::size_t i = 0; i < n; ++i) _parent[i] = i;
+}
+
+/**
+   Number of elements.
+*/
+std::size_t UnionFind::size() const
+{
+  return _parent.size();
+}
+
+/**
+   Number of disjoint sets.
+*/
+std::size_t UnionFind::sets() const
+{
+  return _sets;
+}
+
+/**
+   Merge the sets containing i and j.
+   Returns false when they are in the same set already.
+*/
+bool UnionFind::unite(std::size_t i, std::size_t j)
+{
+  i = find(i);
+  j = find(j);
+  if (i == j) return false;
+
+  // The smaller tree is attached to the larger one
+  if (_size[i] < _size[j]) std::swap(i, j);
+  _parent[j] = i;
+  _size[i] += _size[j];
+  --_sets;
+
+  return true;
+}
+
+/**
+   Number of elements in the set containing i.
+*/
+std::size_t UnionFind::setSize(std::size_t i)
+{
+  return _size[find(i)];
+}
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,71 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   UnionFind.h
+
+   Class: UnionFind
+
+   Disjoint sets of the numbers 0 ... n - 1 with union by size and
+   path halving: a sequence of m operations takes O(m α(n)) time.
+   Used to find the connected components of the spring graph.
+
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#ifndef __UnionFind__
+#define __UnionFind__
+
+#include <cstddef>
+#include <vector>
+
+namespace nsl {
+
+// =========================================================
+// class UnionFind
+// ---------------------------------------------------------
+
+class UnionFind {
+
+  std::vector<std::size_t> _parent;
+  std::vector<std::size_t> _size;
+  std::size_t _sets;
+
+ public:
+  UnionFind(std::size_t n = 0);
+
+  std::size_t size() const;
+  std::size_t sets() const;
+
+  std::size_t find(std::size_t i);
+  bool unite(std::size_t i, std::size_t j);
+  std::size_t setSize(std::size_t i);
+};
+
+// =========================================================
+// Inline methods
+// ---------------------------------------------------------
+
+/**
+   The representative of the set containing i.
+*/
+inline std::size_t UnionFind::find(std::size_t i)
+{
+  while (_parent[i] != i)
+    {
+      // Path halving: point to the grandparent
+      _parent[i] = _parent[_parent[i]];
+      i = _parent[i];
+    }
+
+  return i;
+}
+
+} // namespace nsl
+
+#endif /* defined(__UnionFind__) */
+
+/* fin */
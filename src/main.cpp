@@ -13,10 +13,33 @@
 */
 
 #include "FEM.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "MemoryTracker.h"
 
 #include <vector>
 #include <string>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+
+// Chrome trace output file (written at exit)
+static std::string traceFile;
+
+/**
+   Write the Chrome trace (registered with atexit).
+ */
+void writeTrace()
+{
+  std::ofstream out(traceFile);
+  if (!out.good())
+    {
+      std::cerr << "ERROR: Could not open trace file: " << traceFile << std::endl;
+      return;
+    }
+  nsl::Trace::write(out);
+}
 
 /**
    Print help text.
@@ -24,10 +47,84 @@
 void help()
 {
   std::cout 
-    << "Usage: nslfem-spring1d <fem definition file>" << std::endl
+    << "Usage: nslfem-spring1d [options] <fem definition file>..." << std::endl
+    << std::endl
+    << "Options:" << std::endl
+    << std::endl
+    << "  -h, --help                Print this help text" << std::endl
+    << "  --profile                 Print the time and counters of each phase" << std::endl
+    << "  --profile-json=<file>     Also write the profile as JSON to <file>" << std::endl
+    << "  --trace=<file>            Write a Chrome trace of the run to <file>" << std::endl
+    << "  --solver=<solver>         dense, band, sparse, cg, tree, tree-cg, amg," << std::endl
+    << "                            amg-cg or auto (default)" << std::endl
+    << "  --stabilize               Fix the first node of each part of the assemblage" << std::endl
+    << "                            without prescribed displacement (default: reject)" << std::endl
+    << "  --reduce                  Merge parallel springs and springs in series" << std::endl
+    << "                            before solving" << std::endl
+    << "  --contingency             Also print the worst case of removing each" << std::endl
+    << "                            single spring (N-1 contingency analysis)" << std::endl
+    << "  --monte-carlo=<samples>   Also print the statistics of the displacements" << std::endl
+    << "                            for random (lognormal) spring constants" << std::endl
+    << "  --variation=<cov>         Coefficient of variation of the spring constants" << std::endl
+    << "                            (default: 0.1)" << std::endl
+    << "  --seed=<seed>             Seed of the random spring constants (default: 1)" << std::endl
+    << "  --sweep=<file>            Also solve the model for each point of the" << std::endl
+    << "                            parameter sweep defined in <file> and print" << std::endl
+    << "                            the results as a table" << std::endl
+    << "  --sweep-output=<file>     Write the table of the sweep to <file>" << std::endl
+    << "  --mixed-precision         Factorize in single precision and refine the" << std::endl
+    << "                            solution in the working precision (band, sparse)" << std::endl
+    << "  --precision=<precision>   Working precision: float, double (default)" << std::endl
+    << "                            or long-double" << std::endl
+    << "  --memory                  Track the heap: allocations, bytes and peak usage" << std::endl
+    << "                            of each phase (implies --profile)" << std::endl
+    << "  --memory-budget=<MB>      Warn before allocating dense matrices" << std::endl
+    << "                            which would exceed <MB> megabytes" << std::endl
     ;
 }
 
+/**
+   Solve the model in the working precision Real and print the results.
+ */
+template <typename Real>
+void run(const std::vector<std::string> &files, nsl::LinearSolver::Type solver,
+	 bool stabilize, bool reduce, bool mixedPrecision, bool contingency,
+	 std::size_t samples, double variation, std::uint64_t seed,
+	 const std::string &sweepFile, const std::string &sweepOutput)
+{
+  // Processing the input file
+  nsl::BasicFEM<Real> fem(files);
+  fem.setSolver(solver);
+  fem.setStabilize(stabilize);
+  fem.setReduce(reduce);
+  fem.setMixedPrecision(mixedPrecision);
+  fem.solve();
+  fem.printResults();
+  if (contingency) fem.printContingencyAnalysis();
+  if (samples > 0) fem.printMonteCarlo(samples, variation, seed);
+
+  if (!sweepFile.empty())
+    {
+      nsl::BasicSweep<Real> sweep(sweepFile);
+      if (sweepOutput.empty())
+	{
+	  std::cout << "Parameter sweep (" << sweep.points() << " points):" << std::endl << std::endl;
+	  fem.sweep(sweep, std::cout);
+	  std::cout << std::endl;
+	}
+      else
+	{
+	  std::ofstream out(sweepOutput);
+	  if (!out.good())
+	    {
+	      std::cerr << "ERROR: Could not open sweep output file: " << sweepOutput << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  fem.sweep(sweep, out);
+	}
+    }
+}
+
 /**
    Main.
  */
@@ -36,6 +133,29 @@ int main(int argc, char* argv[])
   // List of FEM definition files
   std::vector<std::string> files;
 
+  // Solver backend
+  nsl::LinearSolver::Type solver = nsl::LinearSolver::AUTO;
+  bool stabilize = false;
+  bool reduce = false;
+  bool mixedPrecision = false;
+  bool contingency = false;
+
+  // Monte Carlo analysis (0 samples: none)
+  std::size_t samples = 0;
+  double variation = 0.1;
+  std::uint64_t seed = 1;
+
+  // Parameter sweep
+  std::string sweepFile;
+  std::string sweepOutput;
+
+  // Working precision
+  nsl::Precision::Type precision = nsl::Precision::DOUBLE;
+
+  // Profile output
+  bool profile = false;
+  std::string profileJSONFile;
+
   // Parse command-line arguments
   for(int i = 1; i < argc; ++i )
     {
@@ -45,17 +165,133 @@ int main(int argc, char* argv[])
 	  help();
 	  exit(EXIT_SUCCESS);
 	}
+      else if (strcmp(argv[i], "--profile") == 0)
+	profile = true;
+      else if (strncmp(argv[i], "--profile-json=", 15) == 0)
+	{
+	  profile = true;
+	  profileJSONFile = argv[i] + 15;
+	}
+      else if (strncmp(argv[i], "--trace=", 8) == 0)
+	traceFile = argv[i] + 8;
+      else if (strncmp(argv[i], "--solver=", 9) == 0)
+	{
+	  if (!nsl::LinearSolver::parseType(argv[i] + 9, solver))
+	    {
+	      std::cerr << "ERROR Unknown solver: " << argv[i] + 9 << std::endl;
+	      help();
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (strcmp(argv[i], "--stabilize") == 0)
+	stabilize = true;
+      else if (strcmp(argv[i], "--reduce") == 0)
+	reduce = true;
+      else if (strcmp(argv[i], "--contingency") == 0)
+	contingency = true;
+      else if (strncmp(argv[i], "--monte-carlo=", 14) == 0)
+	{
+	  long n = atol(argv[i] + 14);
+	  if (n <= 0)
+	    {
+	      std::cerr << "ERROR: Invalid number of samples: " << argv[i] + 14 << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  samples = std::size_t(n);
+	}
+      else if (strncmp(argv[i], "--variation=", 12) == 0)
+	{
+	  variation = atof(argv[i] + 12);
+	  if (variation < 0)
+	    {
+	      std::cerr << "ERROR: Invalid coefficient of variation: " << argv[i] + 12 << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (strncmp(argv[i], "--seed=", 7) == 0)
+	seed = std::strtoull(argv[i] + 7, nullptr, 10);
+      else if (strncmp(argv[i], "--sweep=", 8) == 0)
+	sweepFile = argv[i] + 8;
+      else if (strncmp(argv[i], "--sweep-output=", 15) == 0)
+	sweepOutput = argv[i] + 15;
+      else if (strcmp(argv[i], "--mixed-precision") == 0)
+	mixedPrecision = true;
+      else if (strncmp(argv[i], "--precision=", 12) == 0)
+	{
+	  if (!nsl::Precision::parseType(argv[i] + 12, precision))
+	    {
+	      std::cerr << "ERROR Unknown precision: " << argv[i] + 12 << std::endl;
+	      help();
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (strcmp(argv[i], "--memory") == 0)
+	{
+	  profile = true;
+	  nsl::MemoryTracker::enable();
+	}
+      else if (strncmp(argv[i], "--memory-budget=", 16) == 0)
+	{
+	  double megabytes = atof(argv[i] + 16);
+	  if (megabytes <= 0)
+	    {
+	      std::cerr << "ERROR: Invalid memory budget: " << argv[i] + 16 << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  nsl::MemoryTracker::setBudget(std::uint64_t(megabytes * (1 << 20)));
+	}
       else 
 	files.push_back(argv[i]);
     }
   
+  // Switch on profiling
+  if (profile)
+    nsl::Profiler::enable();
+
+  // Switch on tracing,
+  // the trace is written at exit (also when exiting on an error)
+  if (!traceFile.empty())
+    {
+      nsl::Trace::enable();
+      std::atexit(writeTrace);
+    }
+
   // Header
   std::cout << std::endl << "FEM: Spring Assemblage (1D)" << std::endl << std::endl;
   
-  // Processing the input file
-  nsl::FEM fem(files);
-  fem.solve();
-  fem.printResults();
+  // Solve the model in the working precision
+  switch (precision)
+    {
+    case nsl::Precision::FLOAT:
+      run<float>(files, solver, stabilize, reduce, mixedPrecision, contingency, samples, variation, seed,
+		   sweepFile, sweepOutput);
+      break;
+    case nsl::Precision::DOUBLE:
+      run<double>(files, solver, stabilize, reduce, mixedPrecision, contingency, samples, variation, seed,
+		   sweepFile, sweepOutput);
+      break;
+    case nsl::Precision::LONG_DOUBLE:
+      run<long double>(files, solver, stabilize, reduce, mixedPrecision, contingency, samples, variation, seed,
+		   sweepFile, sweepOutput);
+      break;
+    }
+
+  // Profile
+  if (profile)
+    {
+      nsl::Profiler::printTable(std::cout);
+
+      if (!profileJSONFile.empty())
+	{
+	  std::ofstream out(profileJSONFile);
+	  if (!out.good())
+	    {
+	      std::cerr << "ERROR: Could not open profile file: " << profileJSONFile << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	  nsl::Profiler::writeJSON(out);
+	}
+    }
 
   // Footer
   std::cout << "fin." << std::endl << std::endl;
@@ -0,0 +1,77 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Constraints-test.h
+
+   Unit tests for class: Constraints
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "Constraints.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Constraints)
+
+// Test the flags, values and index lists
+BOOST_AUTO_TEST_CASE(Test_Constraints_lists)
+{
+  Constraints c(5, {3, 0}, {2.5, -1});
+
+  BOOST_REQUIRE( c.size() == 5 );
+  BOOST_REQUIRE( c.numberOfFree() == 3 );
+  BOOST_REQUIRE( c.numberOfConstrained() == 2 );
+
+  BOOST_REQUIRE( c.isConstrained(0) );
+  BOOST_REQUIRE( !c.isConstrained(1) );
+  BOOST_REQUIRE( c.isConstrained(3) );
+  BOOST_REQUIRE( c.value(0) == -1 );
+  BOOST_REQUIRE( c.value(1) == 0 );
+  BOOST_REQUIRE( c.value(3) == 2.5 );
+
+  BOOST_REQUIRE( c.freeDofs() == std::vector<std::size_t>({1, 2, 4}) );
+  BOOST_REQUIRE( c.constrainedDofs() == std::vector<std::size_t>({0, 3}) );
+  BOOST_REQUIRE( c.freeIndex() == std::vector<std::size_t>({5, 0, 1, 5, 2}) );
+
+  Constraints none(3);
+  BOOST_REQUIRE( none.numberOfFree() == 3 );
+  BOOST_REQUIRE( none.constrainedDofs().empty() );
+}
+
+// Test the bits across word boundaries
+BOOST_AUTO_TEST_CASE(Test_Constraints_words)
+{
+  Constraints c(130, {63, 64, 129}, {1, 2, 3});
+
+  for (std::size_t i = 0; i < c.size(); ++i)
+    BOOST_REQUIRE( c.isConstrained(i) == (i == 63 || i == 64 || i == 129) );
+  BOOST_REQUIRE( c.numberOfFree() == 127 );
+  BOOST_REQUIRE( c.freeIndex()[65] == 63 );
+  BOOST_REQUIRE( c.freeIndex()[128] == 126 );
+}
+
+// Test gathering the free and scattering back all elements
+BOOST_AUTO_TEST_CASE(Test_Constraints_gatherScatter)
+{
+  Constraints c(5, {0, 3}, {-1, 2.5});
+
+  BOOST_REQUIRE( c.gather(DVector({10, 11, 12, 13, 14})) == DVector({11, 12, 14}) );
+  BOOST_REQUIRE( c.scatter(DVector({7, 8, 9})) == DVector({-1, 7, 8, 2.5, 9}) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
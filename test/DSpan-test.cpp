@@ -0,0 +1,69 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   DSpan-test.h
+
+   Unit tests for class: DSpan
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "DVector.h"
+#include "DMatrix.h"
+#include "DSpan.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_DSpan)
+
+// Test the view on the elements of a vector
+BOOST_AUTO_TEST_CASE(Test_DSpan_vector)
+{
+  DVector v({1, 2, 3});
+  DSpan s = v.span();
+
+  BOOST_REQUIRE( s.size() == 3 );
+  BOOST_REQUIRE( s.contiguous() );
+  BOOST_REQUIRE( s(0) == 1 && s(1) == 2 && s(2) == 3 );
+
+  // Writing through the view changes the vector
+  s(1) = 5;
+  BOOST_REQUIRE( v == DVector({1, 5, 3}) );
+}
+
+// Test the row and column views on a matrix
+BOOST_AUTO_TEST_CASE(Test_DSpan_matrix)
+{
+  DMatrix m({{1, 2, 3}, 
+	     {4, 5, 6}});
+
+  DConstSpan r = static_cast<const DMatrix &>(m).row(1);
+  BOOST_REQUIRE( r.size() == 3 );
+  BOOST_REQUIRE( r.contiguous() );
+  BOOST_REQUIRE( r(0) == 4 && r(1) == 5 && r(2) == 6 );
+
+  DSpan c = m.col(2);
+  BOOST_REQUIRE( c.size() == 2 );
+  BOOST_REQUIRE( c.stride() == 3 );
+  BOOST_REQUIRE( c(0) == 3 && c(1) == 6 );
+
+  // Writing through the view changes the matrix
+  c(1) = 9;
+  BOOST_REQUIRE( m(1, 2) == 9 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -20,8 +20,12 @@
 #include <boost/test/unit_test.hpp>
 
 #include <cmath>
+#include <set>
+#include <sstream>
 
 #include "Spring.h"
+#include "Random.h"
+#include "Statistics.h"
 
 #include "FEM.h"
 
@@ -462,6 +466,703 @@ BOOST_AUTO_TEST_CASE(Test_testCases)
   	   );
 }
 
+BOOST_AUTO_TEST_CASE(Test_solveAgain)
+{
+  //        100         50
+  //   1 ========= 2 ------ 3 ---- 4
+  //        100                 25
+  FEM fem;
+  addNode(fem, {1, 'd', 0});
+  addNode(fem, {2});
+  addNode(fem, {3, 'f', 10});
+  addNode(fem, {4, 'd', 0});
+  addSpring(fem, {1, 1, 2, 100});
+  addSpring(fem, {2, 2, 1, 100});
+  addSpring(fem, {3, 2, 3, 50});
+  addSpring(fem, {4, 3, 4, 25});
+
+  for (bool reduce : { false, true, false })
+    {
+      fem.setReduce(reduce);
+      fem.addForce(3, 10);
+      fem.addDisplacement(4, 0);
+      fem.solve();
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(1) + fem.getGlobalForce(4) + 10) < 1e-12 );
+      double reaction1 = fem.getGlobalForce(1);
+
+      // A new load
+      fem.addForce(3, 30);
+      fem.solve();
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(1) - 3 * reaction1) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(1) + fem.getGlobalForce(4) + 30) < 1e-12 );
+
+      // A new prescribed displacement: node 4 pulled, no load
+      fem.addForce(3, 0);
+      fem.addDisplacement(4, 0.5);
+      fem.solve();
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(4) - 0.5) < 1e-15 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(1) + fem.getGlobalForce(4)) < 1e-12 );
+      BOOST_CHECK( fem.getGlobalForce(4) > 0 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Test_elementResults)
+{
+  // Example 2.3 (see above)
+  FEM fem;
+  addNode(fem, {1, 'd', 0});
+  addNode(fem, {2, 'f', 6});
+  addNode(fem, {3, 'd', 0});
+  addNode(fem, {4, 'd', 0});
+  addSpring(fem, {1,  1, 2,  1});
+  addSpring(fem, {2,  2, 3,  2});
+  addSpring(fem, {3,  2, 4,  3});
+  fem.solve();
+
+  ElementResults results;
+  fem.calculateElementResults(results);
+
+  // The bulk results match the results of getLocalForces()
+  for (int id = 1; id <= 3; ++id)
+    {
+      DVector forces = fem.getLocalForces(id);
+      BOOST_CHECK( results.localForce1(id - 1) == forces(0) );
+      BOOST_CHECK( results.localForce2(id - 1) == forces(1) );
+    }
+
+  // d2 = 1, all other displacements are 0
+  BOOST_CHECK( results.elongation == DVector({ 1, -1, -1 }) );
+  BOOST_CHECK( results.strainEnergy == DVector({ 0.5, 1, 1.5 }) );
+}
+
+BOOST_AUTO_TEST_CASE(Test_solvers)
+{
+  // Example 2.1 (see above) solved by each backend
+  for (LinearSolver::Type type : { LinearSolver::DENSE, LinearSolver::BAND, 
+	                           LinearSolver::SPARSE, LinearSolver::CG })
+    {
+      FEM fem;
+      addNode(fem, {1, 'd', 0});
+      addNode(fem, {2, 'd', 0});
+      addNode(fem, {3});
+      addNode(fem, {4, 'f', 5000});
+      addSpring(fem, {1,  1, 3,  1000});
+      addSpring(fem, {2,  3, 4,  2000});
+      addSpring(fem, {3,  4, 2,  3000});
+      fem.setSolver(type);
+      fem.solve();
+
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(3) - 10.0 / 11.0) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(4) - 15.0 / 11.0) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(2) + 45000.0 / 11.0) < 1e-8 );
+    }
+}
+
+// Example 2.1 (see above) in single and extended precision
+template <typename Real>
+void solveExample21(double tolerance)
+{
+  BasicFEM<Real> fem;
+  for (int id = 1; id <= 4; ++id) fem.addNode(id);
+  fem.addDisplacement(1, 0);
+  fem.addDisplacement(2, 0);
+  fem.addForce(4, 5000);
+  fem.addSpring(1,  1, 3,  1000);
+  fem.addSpring(2,  3, 4,  2000);
+  fem.addSpring(3,  4, 2,  3000);
+  fem.solve();
+
+  BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(3) - Real(10) / 11) < tolerance );
+  BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(4) - Real(15) / 11) < tolerance );
+  BOOST_CHECK( std::fabs(fem.getGlobalForce(2) + Real(45000) / 11) < 5000 * tolerance );
+}
+
+BOOST_AUTO_TEST_CASE(Test_precision)
+{
+  solveExample21<float>(1e-6);
+  solveExample21<long double>(1e-17);
+
+  Precision::Type type;
+  BOOST_REQUIRE( Precision::parseType("long-double", type) && type == Precision::LONG_DOUBLE );
+  BOOST_REQUIRE( Precision::parseType("float", type) && type == Precision::FLOAT );
+  BOOST_REQUIRE( !Precision::parseType("quad", type) );
+  BOOST_REQUIRE( std::string(Precision::typeName(Precision::DOUBLE)) == "double" );
+}
+
+BOOST_AUTO_TEST_CASE(Test_independentParts)
+{
+  // The fixed nodes 3 and 7 cut the model into the parts {1, 2}, {4, 5} and {6}
+  for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::DENSE, LinearSolver::BAND, 
+	                           LinearSolver::SPARSE, LinearSolver::CG })
+    {
+      FEM fem;
+      addNode(fem, {1, 'f', 10});
+      addNode(fem, {2});
+      addNode(fem, {3, 'd', 0});
+      addNode(fem, {4});
+      addNode(fem, {5, 'f', 20});
+      addNode(fem, {6, 'f', 5});
+      addNode(fem, {7, 'd', 0});
+      addSpring(fem, {1,  1, 2,  100});
+      addSpring(fem, {2,  2, 3,  100});
+      addSpring(fem, {3,  3, 4,  100});
+      addSpring(fem, {4,  4, 5,  100});
+      addSpring(fem, {5,  6, 7,  50});
+      fem.setSolver(type);
+      fem.solve();
+
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(1) - 0.2) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(2) - 0.1) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(4) - 0.2) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(5) - 0.4) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(6) - 0.1) < 1e-12 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(3) + 30) < 1e-9 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(7) + 5) < 1e-9 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Test_reduce)
+{
+  //        100           50     200     100         100
+  //   1 ========= 2 ---- 3 ---- 4 ---- 5 ---- 6      
+  //        100                         |
+  //                                    +----- 7
+  //                                       40
+  // Springs 1 and 2 are parallel, 2 - 3 - 4 are in series
+  auto build = [] (FEM &fem) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', 10});
+    addNode(fem, {6, 'd', 0.1});
+    addNode(fem, {7, 'f', 4});
+    addSpring(fem, {1,  1, 2,  100});
+    addSpring(fem, {2,  2, 1,  100});
+    addSpring(fem, {3,  2, 3,  50});
+    addSpring(fem, {4,  3, 4,  200});
+    addSpring(fem, {5,  4, 5,  100});
+    addSpring(fem, {6,  5, 6,  100});
+    addSpring(fem, {7,  5, 7,  40});
+  };
+
+  FEM fem;
+  build(fem);
+  fem.solve();
+
+  FEM reduced;
+  build(reduced);
+  reduced.setReduce(true);
+  reduced.solve();
+
+  for (int id = 1; id <= 7; ++id)
+    {
+      BOOST_CHECK( std::fabs(reduced.getGlobalDisplacement(id) - fem.getGlobalDisplacement(id)) < 1e-12 );
+      BOOST_CHECK( std::fabs(reduced.getGlobalForce(id) - fem.getGlobalForce(id)) < 1e-10 );
+      BOOST_CHECK( euclideanDistance(reduced.getLocalForces(id), fem.getLocalForces(id)) < 1e-10 );
+    }
+  BOOST_CHECK( euclideanDistance(reduced.getGlobalStiffnessMatrix(), fem.getGlobalStiffnessMatrix()) == 0 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_updateSpringConstant)
+{
+  // The model of Test_reduce with the spring constants k
+  auto build = [] (FEM &fem, const std::vector<double> &k) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', 10});
+    addNode(fem, {6, 'd', 0.1});
+    addNode(fem, {7, 'f', 4});
+    addSpring(fem, {1,  1, 2,  k[0]});
+    addSpring(fem, {2,  2, 1,  k[1]});
+    addSpring(fem, {3,  2, 3,  k[2]});
+    addSpring(fem, {4,  3, 4,  k[3]});
+    addSpring(fem, {5,  4, 5,  k[4]});
+    addSpring(fem, {6,  5, 6,  k[5]});
+    addSpring(fem, {7,  5, 7,  k[6]});
+  };
+
+  // Spring, new spring constant: springs at constrained nodes (1, 2, 6)
+  // and a spring changed twice (3)
+  std::vector<std::pair<int, double> > changes = { {3, 80}, {6, 150}, {1, 20}, {3, 60}, {7, 10} };
+
+  for (bool reduce : { false, true })
+    for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::DENSE, LinearSolver::SPARSE })
+      {
+	std::vector<double> k = { 100, 100, 50, 200, 100, 100, 40 };
+	FEM fem;
+	build(fem, k);
+	fem.setSolver(type);
+	fem.setReduce(reduce);
+	fem.solve();
+
+	for (const auto &change : changes)
+	  {
+	    fem.updateSpringConstant(change.first, change.second);
+	    k[change.first - 1] = change.second;
+
+	    FEM expected;
+	    build(expected, k);
+	    expected.setSolver(type);
+	    expected.solve();
+
+	    for (int id = 1; id <= 7; ++id)
+	      {
+		BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(id) - expected.getGlobalDisplacement(id)) < 1e-12 );
+		BOOST_CHECK( std::fabs(fem.getGlobalForce(id) - expected.getGlobalForce(id)) < 1e-10 );
+		BOOST_CHECK( euclideanDistance(fem.getLocalForces(id), expected.getLocalForces(id)) < 1e-10 );
+	      }
+	    BOOST_CHECK( euclideanDistance(fem.getGlobalStiffnessMatrix(), expected.getGlobalStiffnessMatrix()) == 0 );
+	  }
+      }
+
+  // More changed springs than maxUpdateRank: the matrix is factorized again
+  std::size_t n = 50;
+  auto chain = [n] (FEM &fem, const std::vector<double> &k) {
+    for (std::size_t i = 0; i <= n; ++i) fem.addNode(i);
+    fem.addDisplacement(0, 0);
+    fem.addForce(n, 1);
+    for (std::size_t i = 0; i < n; ++i) fem.addSpring(i, i, i + 1, k[i]);
+  };
+
+  std::vector<double> k(n, 1);
+  FEM fem;
+  chain(fem, k);
+  fem.solve();
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      k[i] = 1 + i;
+      fem.updateSpringConstant(i, k[i]);
+    }
+
+  FEM expected;
+  chain(expected, k);
+  expected.solve();
+  for (std::size_t i = 0; i <= n; ++i)
+    BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(i) - expected.getGlobalDisplacement(i)) < 1e-10 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_tryUpdateSpringConstant)
+{
+  //        k1          k3        k4
+  //   1 ========= 2 ------ 3 ------ 4 -> 10
+  //        k2
+  auto build = [] (FEM &fem, const std::vector<double> &k) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4, 'f', 10});
+    addSpring(fem, {1, 1, 2, k[0]});
+    addSpring(fem, {2, 2, 1, k[1]});
+    addSpring(fem, {3, 2, 3, k[2]});
+    addSpring(fem, {4, 3, 4, k[3]});
+  };
+
+  for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::DENSE, LinearSolver::CG })
+    {
+      std::vector<double> k = { 100, 100, 50, 25 };
+      FEM fem;
+      build(fem, k);
+      fem.setSolver(type);
+      fem.solve();
+      double u4 = fem.getGlobalDisplacement(4);
+
+      // Springs 3 and 4 alone hold nodes 3 and 4: refused, nothing changes
+      BOOST_CHECK( !fem.tryUpdateSpringConstant(4, 0) );
+      BOOST_CHECK( !fem.tryUpdateSpringConstant(3, 0) );
+      BOOST_CHECK( !fem.tryUpdateSpringConstant(3, -50) );
+      BOOST_CHECK( fem.getGlobalDisplacement(4) == u4 );
+      BOOST_CHECK( std::fabs(fem.getGlobalForce(1) + 10) < 1e-12 );
+
+      // Softened by any factor they still hold (the low-rank update
+      // loses about as many digits as the spring is softened by)
+      k[3] = 25e-9;
+      BOOST_CHECK( fem.tryUpdateSpringConstant(4, k[3]) );
+
+      // Parallel springs: the first one may go, then the second one holds
+      k[0] = 0;
+      BOOST_CHECK( fem.tryUpdateSpringConstant(1, k[0]) );
+      BOOST_CHECK( !fem.tryUpdateSpringConstant(2, 0) );
+
+      FEM expected;
+      build(expected, k);
+      expected.solve();
+      for (int id = 1; id <= 4; ++id)
+	{
+	  BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(id) - expected.getGlobalDisplacement(id))
+		       <= 1e-6 * std::fabs(expected.getGlobalDisplacement(id)) );
+	  BOOST_CHECK( std::fabs(fem.getGlobalForce(id) - expected.getGlobalForce(id)) < 1e-5 );
+	}
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Test_contingencyAnalysis)
+{
+  // The model of Test_reduce; removing spring 7 leaves node 7 floating
+  std::vector<std::vector<double> > springs = {
+    {1,  1, 2,  100}, {2,  2, 1,  100}, {3,  2, 3,  50}, {4,  3, 4,  200},
+    {5,  4, 5,  100}, {6,  5, 6,  100}, {7,  5, 7,  40}
+  };
+  auto build = [&springs] (FEM &fem, std::size_t removed) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', 10});
+    addNode(fem, {6, 'd', 0.1});
+    addNode(fem, {7, 'f', 4});
+    for (std::size_t s = 0; s < springs.size(); ++s)
+      if (s != removed) addSpring(fem, springs[s]);
+  };
+
+  // The results of each case solved on its own (case 7: the base case)
+  std::size_t cases = springs.size();
+  std::vector<std::vector<double> > u(cases + 1), f(cases + 1), fs(cases + 1);
+  for (std::size_t c = 0; c <= cases; ++c)
+    {
+      if (c == 6) continue;
+
+      FEM fem;
+      build(fem, c);
+      fem.solve();
+      for (int id = 1; id <= 7; ++id)
+	{
+	  u[c].push_back(fem.getGlobalDisplacement(id));
+	  f[c].push_back(fem.getGlobalForce(id));
+	}
+      for (std::size_t s = 0; s < cases; ++s)
+	fs[c].push_back(s == c ? 0 : fem.getLocalForces(s + 1)(1));
+    }
+
+  // The worst case has the largest absolute value and its value
+  auto check = [&] (const std::vector<std::vector<double> > &values, std::size_t i,
+		    double worst, std::size_t which) {
+    BOOST_REQUIRE( which <= cases && which != 6 );
+    BOOST_CHECK( std::fabs(worst - values[which][i]) < 1e-9 );
+    for (std::size_t c = 0; c <= cases; ++c)
+      if (c != 6) BOOST_CHECK( std::fabs(values[c][i]) < std::fabs(worst) + 1e-9 );
+  };
+
+  for (bool reduce : { false, true })
+    for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::DENSE, LinearSolver::CG })
+      {
+	FEM fem;
+	build(fem, cases);
+	fem.setSolver(type);
+	fem.setReduce(reduce);
+	fem.solve();
+
+	ContingencyResults results;
+	fem.contingencyAnalysis(results);
+
+	BOOST_REQUIRE( results.unstable == std::vector<std::size_t>({ 6 }) );
+	for (std::size_t i = 0; i < 7; ++i)
+	  {
+	    check(u, i, results.displacement(i), results.displacementCase[i]);
+	    check(f, i, results.force(i), results.forceCase[i]);
+	  }
+	for (std::size_t s = 0; s < cases; ++s)
+	  check(fs, s, results.springForce(s), results.springForceCase[s]);
+
+	// The prescribed displacements are the same in every case: the base case
+	BOOST_CHECK( results.displacementCase[0] == cases );
+	BOOST_CHECK( results.displacementCase[5] == cases );
+
+	// The model is still usable afterwards
+	fem.updateSpringConstant(3, 80);
+      }
+}
+
+BOOST_AUTO_TEST_CASE(Test_sensitivity)
+{
+  // The model of Test_reduce with the spring constants k
+  auto build = [] (FEM &fem, const std::vector<double> &k) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', 10});
+    addNode(fem, {6, 'd', 0.1});
+    addNode(fem, {7, 'f', 4});
+    addSpring(fem, {1,  1, 2,  k[0]});
+    addSpring(fem, {2,  2, 1,  k[1]});
+    addSpring(fem, {3,  2, 3,  k[2]});
+    addSpring(fem, {4,  3, 4,  k[3]});
+    addSpring(fem, {5,  4, 5,  k[4]});
+    addSpring(fem, {6,  5, 6,  k[5]});
+    addSpring(fem, {7,  5, 7,  k[6]});
+  };
+  std::vector<double> k = { 100, 100, 50, 200, 100, 100, 40 };
+
+  // The objectives: displacement of node 4, reaction at node 6, compliance
+  auto objectives = [] (FEM &fem) -> std::vector<double> {
+    double compliance = 10 * fem.getGlobalDisplacement(5) + 4 * fem.getGlobalDisplacement(7);
+    return { fem.getGlobalDisplacement(4), fem.getGlobalForce(6), compliance };
+  };
+
+  for (bool reduce : { false, true })
+    {
+      FEM fem;
+      build(fem, k);
+      fem.setReduce(reduce);
+      fem.solve();
+
+      std::vector<DVector> gradients = { fem.displacementSensitivity(4), 
+					 fem.reactionSensitivity(6),
+					 fem.complianceSensitivity() };
+
+      // Central differences
+      for (std::size_t s = 0; s < k.size(); ++s)
+	{
+	  double h = 1e-4 * k[s];
+	  std::vector<double> kp(k), km(k);
+	  kp[s] += h;
+	  km[s] -= h;
+	  FEM plus, minus;
+	  build(plus, kp);
+	  build(minus, km);
+	  plus.solve();
+	  minus.solve();
+	  std::vector<double> jp = objectives(plus), jm = objectives(minus);
+
+	  for (std::size_t o = 0; o < gradients.size(); ++o)
+	    {
+	      double difference = (jp[o] - jm[o]) / (2 * h);
+	      BOOST_CHECK( std::fabs(gradients[o](s) - difference) < 1e-6 * (1 + std::fabs(difference)) );
+	    }
+	}
+
+      // No sensitivity at a prescribed displacement
+      BOOST_CHECK( fem.displacementSensitivity(1) == DVector(7) );
+
+      // The general form: J = u_4 + 2 u_7
+      DVector weights(7);
+      weights(3) = 1;
+      weights(6) = 2;
+      DVector combined = fem.sensitivity(weights);
+      DVector u7 = fem.displacementSensitivity(7);
+      for (std::size_t s = 0; s < k.size(); ++s)
+	BOOST_CHECK( std::fabs(combined(s) - gradients[0](s) - 2 * u7(s)) < 1e-12 );
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Test_monteCarlo)
+{
+  // A chain fixed at node 1 and pulled at node 5, with a branch to
+  // node 6 with a prescribed displacement
+  std::vector<double> k = { 100, 50, 200, 80, 40 };
+  auto build = [] (FEM &fem, const std::vector<double> &k) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', 10});
+    addNode(fem, {6, 'd', 0.1});
+    addSpring(fem, {1, 1, 2, k[0]});
+    addSpring(fem, {2, 2, 3, k[1]});
+    addSpring(fem, {3, 3, 4, k[2]});
+    addSpring(fem, {4, 4, 5, k[3]});
+    addSpring(fem, {5, 3, 6, k[4]});
+  };
+
+  // Without variation every sample is the model itself
+  FEM fem;
+  build(fem, k);
+  fem.solve();
+  MonteCarloResults fixed;
+  fem.monteCarlo(fixed, 10, 0);
+  for (int id = 1; id <= 6; ++id)
+    {
+      double u = fem.getGlobalDisplacement(id);
+      BOOST_CHECK( std::fabs(fixed.mean(id - 1) - u) < 1e-12 );
+      BOOST_CHECK( fixed.deviation(id - 1) < 1e-12 );
+      for (std::size_t j = 0; j < 3; ++j)
+	BOOST_CHECK( std::fabs(fixed.quantiles[j](id - 1) - u) < 1e-12 );
+    }
+
+  // The samples solved one by one: sample n draws the spring
+  // constants from stream n
+  std::size_t samples = 50;
+  double variation = 0.3;
+  std::vector<RunningStatistics> exact(6);
+  for (std::size_t n = 0; n < samples; ++n)
+    {
+      Random random(11, n);
+      std::vector<double> kn;
+      for (double ks : k) kn.push_back(random.lognormal(ks, variation));
+
+      FEM sample;
+      build(sample, kn);
+      sample.solve();
+      for (int id = 1; id <= 6; ++id)
+	exact[id - 1].add(sample.getGlobalDisplacement(id));
+    }
+
+  for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::CG })
+    {
+      FEM fem;
+      build(fem, k);
+      fem.setSolver(type);
+      fem.solve();
+
+      MonteCarloResults results;
+      fem.monteCarlo(results, samples, variation, 11);
+      BOOST_CHECK( results.samples == samples );
+      BOOST_CHECK( results.fallbacks == (type == LinearSolver::CG ? samples : 0) );
+      for (std::size_t i = 0; i < 6; ++i)
+	{
+	  BOOST_CHECK( std::fabs(results.mean(i) - exact[i].mean()) < 1e-9 );
+	  BOOST_CHECK( std::fabs(results.deviation(i) - exact[i].deviation()) < 1e-9 );
+	  BOOST_CHECK( results.quantiles[0](i) <= results.quantiles[1](i) );
+	  BOOST_CHECK( results.quantiles[1](i) <= results.quantiles[2](i) );
+	}
+    }
+
+  // The force of node 5 passes through the springs 3 and 4:
+  // E[u_5 - u_3] = 10 (E[1 / k_3] + E[1 / k_4]) with 
+  // E[1 / k_s] = (1 + variation^2) / mean(k_s)
+  MonteCarloResults results;
+  fem.monteCarlo(results, 20000, variation, 3);
+  BOOST_CHECK( std::fabs(results.mean(4) - results.mean(2) 
+			 - 10 * (1 + variation * variation) * (1 / k[2] + 1 / k[3])) < 2e-3 );
+
+  // The same seed, the same results
+  MonteCarloResults again;
+  fem.monteCarlo(again, 20000, variation, 3);
+  BOOST_CHECK( again.mean == results.mean );
+  BOOST_CHECK( again.quantiles[1] == results.quantiles[1] );
+}
+
+BOOST_AUTO_TEST_CASE(Test_sweep)
+{
+  // The model of Test_monteCarlo with the force at node 5 and the
+  // displacement of node 6 as arguments
+  auto build = [] (FEM &fem, const std::vector<double> &k, double force, double displacement) {
+    addNode(fem, {1, 'd', 0});
+    addNode(fem, {2});
+    addNode(fem, {3});
+    addNode(fem, {4});
+    addNode(fem, {5, 'f', force});
+    addNode(fem, {6, 'd', displacement});
+    for (std::size_t s = 0; s < k.size(); ++s)
+      addSpring(fem, {double(s + 1), double(s == 4 ? 3 : s + 1), double(s == 4 ? 6 : s + 2), k[s]});
+  };
+  std::vector<double> k = { 100, 50, 200, 80, 40 };
+
+  // Read the table: one vector per row, without the header
+  auto table = [] (const std::string &text) {
+    std::istringstream in(text);
+    std::string line;
+    std::getline(in, line);
+    std::vector<std::vector<double> > rows;
+    while (std::getline(in, line))
+      {
+	std::istringstream fields(line);
+	std::vector<double> row;
+	double value;
+	while (fields >> value) row.push_back(value);
+	rows.push_back(row);
+      }
+    return rows;
+  };
+
+  for (bool springs : { true, false })
+    for (LinearSolver::Type type : { LinearSolver::AUTO, LinearSolver::CG })
+      {
+	Sweep sweep;
+	if (springs) sweep.addParameter(Sweep::SPRING_CONSTANT, 2, 20, 80, 3);
+	sweep.addParameter(Sweep::FORCE, 5, 0, 20, 2);
+	sweep.addParameter(Sweep::DISPLACEMENT, 6, 0, 0.2, 2);
+	sweep.addOutput(Sweep::NODE, 3);
+	sweep.addOutput(Sweep::NODE, 6);
+	sweep.addOutput(Sweep::SPRING, 5);
+
+	FEM fem;
+	build(fem, k, 10, 0.1);
+	fem.setSolver(type);
+	fem.solve();
+
+	std::ostringstream out;
+	fem.sweep(sweep, out);
+	BOOST_CHECK( out.str().compare(0, out.str().find('\n'), 
+				       springs ? "point\tparam.k:2\tparam.f:5\tparam.d:6\tu:3\tf:3\tu:6\tf:6\ts:5"
+				       : "point\tparam.f:5\tparam.d:6\tu:3\tf:3\tu:6\tf:6\ts:5") == 0 );
+
+	// Every column has its own name, also the force at node 5 when
+	// it is swept and tabulated
+	Sweep both;
+	both.addParameter(Sweep::FORCE, 5, 0, 10, 2);
+	both.addOutput(Sweep::NODE, 5);
+	std::ostringstream all;
+	fem.sweep(both, all);
+	std::istringstream header(all.str().substr(0, all.str().find('\n')));
+	std::set<std::string> names;
+	std::size_t count = 0;
+	for (std::string name; std::getline(header, name, '\t'); ++count)
+	  names.insert(name);
+	BOOST_CHECK( names.count("param.f:5") == 1 && names.count("f:5") == 1 );
+	BOOST_CHECK( names.size() == count );
+
+	std::vector<std::vector<double> > rows = table(out.str());
+	BOOST_REQUIRE( rows.size() == sweep.points() );
+	for (std::size_t point = 0; point < rows.size(); ++point)
+	  {
+	    const std::vector<double> &row = rows[point];
+	    std::size_t p = springs ? 2 : 1;
+	    BOOST_REQUIRE( row.size() == p + 2 + 5 );
+	    BOOST_CHECK( row[0] == point );
+
+	    // The point solved on its own
+	    std::vector<double> kp(k);
+	    if (springs) kp[1] = row[1];
+	    FEM single;
+	    build(single, kp, row[p], row[p + 1]);
+	    single.solve();
+
+	    std::vector<double> expected = { 
+	      single.getGlobalDisplacement(3), single.getGlobalForce(3),
+	      single.getGlobalDisplacement(6), single.getGlobalForce(6),
+	      single.getLocalForces(5)(1) };
+	    for (std::size_t l = 0; l < expected.size(); ++l)
+	      BOOST_CHECK( std::fabs(row[p + 2 + l] - expected[l]) < 1e-4 * (1 + std::fabs(expected[l])) );
+	  }
+      }
+}
+
+BOOST_AUTO_TEST_CASE(Test_floatingComponents)
+{
+  // 1 - 2 - 3 is fixed at node 1, 4 - 5 and 6 are floating
+  FEM fem;
+  addNode(fem, {1, 'd', 0});
+  addNode(fem, {2});
+  addNode(fem, {3, 'f', 10});
+  addNode(fem, {4});
+  addNode(fem, {5, 'f', 2});
+  addNode(fem, {6});
+  addNode(fem, {7, 'd', 1});
+  addSpring(fem, {1,  1, 2,  100});
+  addSpring(fem, {2,  2, 3,  100});
+  addSpring(fem, {3,  4, 5,  50});
+  addSpring(fem, {4,  6, 7,  0});     // Does not connect anything
+
+  std::vector<std::vector<int> > floating = fem.floatingComponents();
+  BOOST_REQUIRE( floating.size() == 2 );
+  BOOST_REQUIRE( floating[0] == std::vector<int>({ 4, 5 }) );
+  BOOST_REQUIRE( floating[1] == std::vector<int>({ 6 }) );
+
+  // Stabilizing fixes nodes 4 and 6
+  fem.setStabilize(true);
+  fem.solve();
+
+  BOOST_CHECK( fem.floatingComponents().empty() );
+  BOOST_CHECK( fem.getGlobalDisplacement(4) == 0 );
+  BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(5) - 0.04) < 1e-15 );
+  BOOST_CHECK( fem.getGlobalDisplacement(6) == 0 );
+  BOOST_CHECK( std::fabs(fem.getGlobalDisplacement(3) - 0.2) < 1e-15 );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace nsl
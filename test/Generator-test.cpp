@@ -0,0 +1,109 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Generator-test.h
+
+   Unit tests for class: Generator
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Generator.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Generator)
+
+// Count the lines starting with the given keyword
+std::size_t countLines(const std::string &text, const std::string &keyword)
+{
+  std::istringstream in(text);
+  std::string line;
+  std::size_t n = 0;
+  while (std::getline(in, line))
+    if (line.compare(0, keyword.size(), keyword) == 0) ++n;
+
+  return n;
+}
+
+// The number of written nodes and springs is the announced one
+BOOST_AUTO_TEST_CASE(Test_Generator_counts)
+{
+  for (int t = Generator::CHAIN; t <= Generator::RANDOM; ++t)
+    for (std::size_t nodes : { 2, 3, 10, 99, 1000 })
+      {
+	Generator generator((Generator::Topology) t, nodes);
+	
+	std::ostringstream out;
+	generator.write(out);
+
+	BOOST_CHECK( countLines(out.str(), "node ")   == generator.numberOfNodes() );
+	BOOST_CHECK( countLines(out.str(), "spring ") == generator.numberOfSprings() );
+      }
+}
+
+// Shuffled node numbers are a permutation of 1..n
+BOOST_AUTO_TEST_CASE(Test_Generator_shuffle)
+{
+  for (std::size_t nodes : { 2, 10, 97, 1000 })
+    {
+      Generator generator(Generator::GRID, nodes, 7);
+      generator.setShuffle(true);
+      generator.setConstraintDensity(0.5);
+      generator.setLoadPattern(Generator::UNIFORM);
+	
+      std::ostringstream out;
+      generator.write(out);
+
+      std::istringstream in(out.str());
+      std::string line;
+      std::vector<int> seen(nodes + 1, 0);
+      std::size_t fixed = 0, loaded = 0;
+      while (std::getline(in, line))
+	if (line.compare(0, 5, "node ") == 0)
+	  {
+	    std::size_t number = std::stoul(line.substr(5));
+	    BOOST_REQUIRE( 1 <= number && number <= nodes );
+	    ++seen[number];
+	    if (line.find(" d ") != std::string::npos) ++fixed;
+	    if (line.find(" f ") != std::string::npos) ++loaded;
+	  }
+
+      for (std::size_t i = 1; i <= nodes; ++i)
+	BOOST_CHECK( seen[i] == 1 );
+      
+      // Each node is either fixed or loaded
+      BOOST_CHECK( fixed >= 1 );
+      BOOST_CHECK( fixed + loaded == nodes );
+    }
+}
+
+// Topology names
+BOOST_AUTO_TEST_CASE(Test_Generator_topologyNames)
+{
+  Generator::Topology topology;
+
+  BOOST_REQUIRE( Generator::parseTopology("grid", topology) );
+  BOOST_REQUIRE( topology == Generator::GRID );
+  BOOST_REQUIRE( !Generator::parseTopology("mesh", topology) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,431 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   LinearSolver-test.h
+
+   Unit tests for class: LinearSolver and its backends
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "LinearSolver.h"
+#include "SparseSolver.h"
+#include "TreeSolver.h"
+#include "CGSolver.h"
+#include "TreeCGSolver.h"
+#include "AMGSolver.h"
+#include "AMGCGSolver.h"
+#include "RefinementSolver.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_LinearSolver)
+
+/**
+   Stiffness matrix of a chain of n springs (spring constant 1 + i)
+   fixed at one end; the nodes are numbered i * step mod n + 1 along
+   the chain, so that the matrix has a large bandwidth for step > 1.
+*/
+SMatrix chain(std::size_t n, std::size_t step)
+{
+  std::vector<Triplet> triplets;
+  std::size_t previous = n;          // The fixed node (not in the matrix)
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      std::size_t node = (i * step) % n;
+      double k = 1.0 + i;
+      triplets.push_back({ node, node, k });
+      if (previous < n)
+	{
+	  triplets.push_back({ previous, previous, k });
+	  triplets.push_back({ previous, node, -k });
+	  triplets.push_back({ node, previous, -k });
+	}
+      previous = node;
+    }
+
+  return SMatrix(n, n, triplets);
+}
+
+// All backends solve the same system
+BOOST_AUTO_TEST_CASE(Test_LinearSolver_backends)
+{
+  for (std::size_t step : { 1, 7 })
+    {
+      SMatrix A = chain(50, step);
+      DVector x(50);
+      for (std::size_t i = 0; i < 50; ++i) x(i) = 0.5 * i - 3;
+      DVector b = A * x;
+
+      for (LinearSolver::Type type : { LinearSolver::DENSE, LinearSolver::BAND, 
+	                               LinearSolver::SPARSE, LinearSolver::CG, LinearSolver::TREE, 
+	                               LinearSolver::TREE_CG, LinearSolver::AMG, LinearSolver::AMG_CG })
+	{
+	  LinearSolver *solver = LinearSolver::create(type);
+	  BOOST_REQUIRE( solver->type() == type );
+
+	  solver->factor(A);
+	  DVector y = solver->solve(b);
+	  BOOST_CHECK_MESSAGE( euclideanDistance(x, y) < 1e-8, 
+			       LinearSolver::typeName(type) << ", step " << step );
+
+	  // The factorization is reused for another right hand side
+	  DVector z = solver->solve(A * y);
+	  BOOST_CHECK( euclideanDistance(y, z) < 1e-8 );
+
+	  delete solver;
+	}
+    }
+}
+
+// The matrix in half storage gives the same solutions
+BOOST_AUTO_TEST_CASE(Test_LinearSolver_factorSymmetric)
+{
+  SMatrix A = chain(50, 7);
+  SymmetricSMatrix S(A);
+  BOOST_REQUIRE( S.nnz() == (A.nnz() + 50) / 2 );
+
+  DVector x(50);
+  for (std::size_t i = 0; i < 50; ++i) x(i) = 0.5 * i - 3;
+  DVector b = A * x;
+
+  for (LinearSolver::Type type : { LinearSolver::DENSE, LinearSolver::BAND, 
+	                           LinearSolver::SPARSE, LinearSolver::CG, LinearSolver::TREE, 
+	                           LinearSolver::TREE_CG, LinearSolver::AMG, LinearSolver::AMG_CG })
+    {
+      LinearSolver *full = LinearSolver::create(type);
+      LinearSolver *half = LinearSolver::create(type);
+      full->factor(A);
+      half->factorSymmetric(S);
+      DVector y = full->solve(b);
+      DVector z = half->solve(b);
+      BOOST_CHECK_MESSAGE( euclideanDistance(x, z) < 1e-8, LinearSolver::typeName(type) );
+
+      // The direct solvers do the same operations in both cases
+      if (type == LinearSolver::DENSE || type == LinearSolver::BAND || type == LinearSolver::SPARSE)
+	BOOST_CHECK_MESSAGE( y == z, LinearSolver::typeName(type) );
+
+      delete full;
+      delete half;
+    }
+
+  RefinementSolver refinement(LinearSolver::SPARSE);
+  refinement.factorSymmetric(S);
+  BOOST_CHECK( euclideanDistance(x, refinement.solve(b)) < 1e-8 );
+}
+
+// All backends in single and extended precision (|x| is about 100)
+template <typename Real>
+void checkBackends(double tolerance)
+{
+  SMatrix A = chain(50, 7);
+  std::vector<BasicTriplet<Real> > triplets;
+  for (std::size_t i = 0; i < A.rows(); ++i)
+    for (std::size_t k = A.rowStart()[i]; k < A.rowStart()[i + 1]; ++k)
+      triplets.push_back({ i, A.colIndex()[k], Real(A.values()[k]) });
+  BasicSMatrix<Real> B(A.rows(), A.cols(), triplets);
+
+  BasicVector<Real> x(50);
+  for (std::size_t i = 0; i < 50; ++i) x(i) = Real(0.5) * i - 3;
+  BasicVector<Real> b = B * x;
+
+  for (LinearSolverBase::Type type : { LinearSolverBase::DENSE, LinearSolverBase::BAND, 
+	                               LinearSolverBase::SPARSE, LinearSolverBase::CG, LinearSolverBase::TREE, 
+	                               LinearSolverBase::TREE_CG, LinearSolverBase::AMG, LinearSolverBase::AMG_CG })
+    {
+      BasicLinearSolver<Real> *solver = BasicLinearSolver<Real>::create(type);
+      solver->factor(B);
+      BasicVector<Real> y = solver->solve(b);
+      BOOST_CHECK_MESSAGE( double(euclideanDistance(x, y)) < tolerance, 
+			   LinearSolverBase::typeName(type) << ": " << double(euclideanDistance(x, y)) );
+      delete solver;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Test_LinearSolver_precision)
+{
+  checkBackends<float>(5e-2);
+  checkBackends<long double>(1e-9);
+
+  // The iterative solvers stop at a tolerance the precision can reach
+  BOOST_CHECK( Precision::iterativeTolerance<double>() == 1e-12 );
+  BOOST_CHECK( Precision::iterativeTolerance<float>() > 1e-6 );
+}
+
+// The names used by --solver
+BOOST_AUTO_TEST_CASE(Test_LinearSolver_parseType)
+{
+  LinearSolver::Type type;
+
+  BOOST_REQUIRE( LinearSolver::parseType("band", type) && type == LinearSolver::BAND );
+  BOOST_REQUIRE( LinearSolver::parseType("auto", type) && type == LinearSolver::AUTO );
+  BOOST_REQUIRE( !LinearSolver::parseType("lu", type) );
+  BOOST_REQUIRE( std::string(LinearSolver::typeName(LinearSolver::CG)) == "cg" );
+}
+
+// A chain is factorized without fill-in whatever its numbering
+BOOST_AUTO_TEST_CASE(Test_SparseSolver_noFillIn)
+{
+  SparseSolver solver;
+  solver.factor(chain(1000, 7));
+
+  // n diagonal elements + n - 1 off-diagonal elements
+  BOOST_REQUIRE( solver.factorNonzeros() == 1999 );
+}
+
+// New values with the same pattern: only the numeric factorization is repeated
+BOOST_AUTO_TEST_CASE(Test_SparseSolver_refactorSymmetric)
+{
+  std::size_t n = 200;
+  SymmetricSMatrix A(chain(n, 7));
+  SparseSolver solver;
+  solver.factorSymmetric(A);
+  std::size_t nonzeros = solver.factorNonzeros();
+
+  // Stiffer, and every node held by a spring of its own
+  SymmetricSMatrix B(A);
+  for (std::size_t p = 0; p < B.values().size(); ++p)
+    B.values()[p] *= 2;
+  for (std::size_t i = 0; i < n; ++i)
+    B.element(i, i) += 1.0 + i % 5;
+
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = std::cos(0.1 * i);
+  DVector b = B * x;
+
+  SparseSolver fresh;
+  fresh.factorSymmetric(B);
+  BOOST_REQUIRE( solver.tryRefactor(B) );
+  BOOST_CHECK( solver.factorNonzeros() == nonzeros );
+  BOOST_CHECK( euclideanDistance(solver.solve(b), x) < 1e-9 );
+  BOOST_CHECK( euclideanDistance(solver.solve(b), fresh.solve(b)) < 1e-12 );
+
+  // Not positive definite
+  SymmetricSMatrix C(A);
+  C.element(n / 2, n / 2) = -1;
+  BOOST_CHECK( !solver.tryRefactor(C) );
+}
+
+// A binary tree large enough to be split into independent subtrees
+BOOST_AUTO_TEST_CASE(Test_TreeSolver_binaryTree)
+{
+  // Node i hangs at node (i - 1) / 2, node 0 at a fixed node
+  std::size_t n = 100000;
+  std::vector<Triplet> triplets;
+  triplets.push_back({ 0, 0, 1.0 });
+  for (std::size_t i = 1; i < n; ++i)
+    {
+      std::size_t p = (i - 1) / 2;
+      double k = 1.0 + i % 10;
+      triplets.push_back({ i, i, k });
+      triplets.push_back({ p, p, k });
+      triplets.push_back({ p, i, -k });
+      triplets.push_back({ i, p, -k });
+    }
+  SMatrix A(n, n, triplets);
+  BOOST_REQUIRE( TreeSolver::isForest(A) );
+
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = (i % 17) * 0.25 - 1;
+  DVector b = A * x;
+
+  TreeSolver tree;
+  tree.factor(A);
+  SparseSolver sparse;
+  sparse.factor(A);
+  BOOST_CHECK( euclideanDistance(tree.solve(b), x) < 1e-8 );
+  BOOST_CHECK( euclideanDistance(tree.solve(b), sparse.solve(b)) < 1e-6 );
+
+  // A spring without stiffness does not close a cycle
+  std::vector<Triplet> zero(triplets);
+  zero.push_back({ 1, 2, 0.0 });
+  zero.push_back({ 2, 1, 0.0 });
+  SMatrix Z(n, n, zero);
+  BOOST_REQUIRE( TreeSolver::isForest(Z) );
+  tree.factor(Z);
+  BOOST_CHECK( euclideanDistance(tree.solve(b), x) < 1e-8 );
+
+  // Closing a cycle
+  triplets.push_back({ 1, 2, -1.0 });
+  triplets.push_back({ 2, 1, -1.0 });
+  BOOST_REQUIRE( !TreeSolver::isForest(SMatrix(n, n, triplets)) );
+}
+
+// Spring constants over eight orders of magnitude stall Jacobi
+// preconditioning, but not the spanning tree preconditioner
+BOOST_AUTO_TEST_CASE(Test_TreeCGSolver_heterogeneous)
+{
+  // A ring of n nodes with chords, grounded at node 0
+  std::size_t n = 2000;
+  std::vector<Triplet> triplets;
+  triplets.push_back({ 0, 0, 1.0 });
+  auto spring = [&] (std::size_t a, std::size_t b, double k) {
+    triplets.push_back({ a, a, k });
+    triplets.push_back({ b, b, k });
+    triplets.push_back({ a, b, -k });
+    triplets.push_back({ b, a, -k });
+  };
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      spring(i, (i + 1) % n, std::pow(10.0, int(i % 9) - 4));
+      if (i % 3 == 0) spring(i, (i * 37 + 11) % n, std::pow(10.0, int(i % 5) - 2));
+    }
+  SMatrix A(n, n, triplets);
+
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = std::sin(0.01 * i);
+  DVector b = A * x;
+
+  CGSolver jacobi;
+  jacobi.factor(A);
+  jacobi.solve(b);
+
+  TreeCGSolver tree;
+  tree.factor(A);
+  DVector y = tree.solve(b);
+
+  BOOST_CHECK( tree.residual() <= 1e-12 );
+  BOOST_CHECK( tree.iterations() * 5 < jacobi.iterations() );
+  BOOST_CHECK( euclideanDistance(x, y) < 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_RefinementSolver)
+{
+  std::size_t n = 500;
+  SMatrix A = chain(n, 7);
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = std::sin(0.1 * i);
+  DVector b = A * x;
+
+  for (LinearSolver::Type type : { LinearSolver::BAND, LinearSolver::SPARSE })
+    {
+      // A single precision factorization alone is off by far more than 
+      // the refined solution
+      SparseSolver single;
+      single.setSinglePrecision(true);
+      single.factor(A);
+      double singleError = euclideanDistance(x, single.solve(b));
+
+      RefinementSolver solver(type);
+      solver.factor(A);
+      DVector y = solver.solve(b);
+
+      BOOST_CHECK_MESSAGE( !solver.fellBack(), LinearSolver::typeName(type) );
+      BOOST_CHECK( solver.iterations() >= 1 && solver.iterations() <= 10 );
+      BOOST_CHECK( solver.backwardError() <= std::sqrt(double(n)) * 2.3e-16 );
+      BOOST_CHECK( euclideanDistance(x, y) < 1e-8 );
+      BOOST_CHECK( euclideanDistance(x, y) * 1e3 < singleError );
+
+      // The factorization is reused for another right hand side
+      DVector z = solver.solve(A * y);
+      BOOST_CHECK( euclideanDistance(y, z) < 1e-8 );
+    }
+
+  // Positive definite in double, but singular in single precision:
+  // factorized in double precision instead
+  SMatrix B(2, 2, {{0, 0, 1}, {0, 1, 1 - 1e-9}, {1, 0, 1 - 1e-9}, {1, 1, 1}});
+  DVector c = B * DVector({ 1, 2 });
+
+  RefinementSolver solver(LinearSolver::SPARSE);
+  solver.factor(B);
+  DVector y = solver.solve(c);
+  BOOST_CHECK( solver.fellBack() );
+  BOOST_CHECK( euclideanDistance(y, DVector({ 1, 2 })) < 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_AMGSolver_grid)
+{
+  // A square grid of m x m nodes, grounded at node 0
+  std::size_t m = 100, n = m * m;
+  std::vector<Triplet> triplets;
+  triplets.push_back({ 0, 0, 1.0 });
+  auto spring = [&] (std::size_t a, std::size_t b, double k) {
+    triplets.push_back({ a, a, k });
+    triplets.push_back({ b, b, k });
+    triplets.push_back({ a, b, -k });
+    triplets.push_back({ b, a, -k });
+  };
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (i % m + 1 < m) spring(i, i + 1, 1 + (i * 7) % 10);
+      if (i + m < n)     spring(i, i + m, 1 + (i * 3) % 10);
+    }
+  SMatrix A(n, n, triplets);
+
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = std::sin(0.01 * i);
+  DVector b = A * x;
+
+  CGSolver jacobi;
+  jacobi.factor(A);
+  jacobi.solve(b);
+
+  AMGSolver amg;
+  amg.factor(A);
+  BOOST_CHECK( amg.hierarchy().levels() > 2 );
+  BOOST_CHECK( amg.hierarchy().operatorComplexity() < 2 );
+
+  DVector y = amg.solve(b);
+  BOOST_CHECK( amg.residual() <= 1e-12 );
+  BOOST_CHECK( euclideanDistance(x, y) < 1e-6 );
+
+  AMGCGSolver amgcg;
+  amgcg.factor(A);
+  DVector z = amgcg.solve(b);
+  BOOST_CHECK( amgcg.residual() <= 1e-12 );
+  BOOST_CHECK( amgcg.iterations() * 10 < jacobi.iterations() );
+  BOOST_CHECK( euclideanDistance(x, z) < 1e-6 );
+
+  // The hierarchy is reused for another load case
+  DVector w = amgcg.solve(A * y);
+  BOOST_CHECK( euclideanDistance(y, w) < 1e-6 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_AMGSolver_chain)
+{
+  // A long chain with varying spring constants, grounded at node 0:
+  // the plain V-cycles stall and are continued with CG
+  std::size_t n = 20000;
+  std::vector<Triplet> triplets;
+  triplets.push_back({ 0, 0, 1.0 });
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+      double k = 1 + (i * 7) % 10;
+      triplets.push_back({ i, i, k });
+      triplets.push_back({ i + 1, i + 1, k });
+      triplets.push_back({ i, i + 1, -k });
+      triplets.push_back({ i + 1, i, -k });
+    }
+  SMatrix A(n, n, triplets);
+
+  DVector x(n);
+  for (std::size_t i = 0; i < n; ++i) x(i) = std::sin(0.001 * i);
+  DVector b = A * x;
+
+  AMGSolver amg;
+  amg.factor(A);
+  DVector y = amg.solve(b);
+  BOOST_CHECK( amg.accelerated() );
+  BOOST_CHECK( amg.residual() <= 1e-12 );
+  BOOST_CHECK( amg.iterations() < 100 );
+  BOOST_CHECK( euclideanDistance(x, y) < 1e-6 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
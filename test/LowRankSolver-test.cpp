@@ -0,0 +1,80 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   LowRankSolver-test.h
+
+   Unit tests for class: LowRankSolver
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "DMatrix.h"
+#include "SMatrix.h"
+#include "LinearSolver.h"
+#include "LowRankSolver.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_LowRankSolver)
+
+// Test the solution after changing springs against a direct solution
+BOOST_AUTO_TEST_CASE(Test_LowRankSolver_update)
+{
+  // A chain 0 - 1 - 2 - 3 (free) fixed through a spring of 2 at
+  // a constrained node c before node 0, with springs of 1, 2, 3
+  DMatrix k({{ 3, -1,  0,  0},
+	     {-1,  3, -2,  0},
+	     { 0, -2,  5, -3},
+	     { 0,  0, -3,  3}});
+  DVector b({0, 0, 0, 1});
+
+  LinearSolver *solver = LinearSolver::create(LinearSolver::DENSE);
+  std::vector<Triplet> entries;
+  for (std::size_t i = 0; i < 4; ++i)
+    for (std::size_t j = 0; j < 4; ++j)
+      if (k(i, j) != 0) entries.push_back({ i, j, k(i, j) });
+  solver->factor(SMatrix(4, 4, entries));
+  LowRankSolver lowRank(solver, solver->solve(b));
+
+  BOOST_REQUIRE( lowRank.size() == 4 );
+  BOOST_REQUIRE( lowRank.rank() == 0 );
+  BOOST_REQUIRE( euclideanDistance(lowRank.solve(), k.gaussianElimination(b)) < 1e-12 );
+
+  // Spring 1 - 2: 2 -> 4
+  lowRank.update(1, 1, 2, 2, 0);
+  k(1, 1) += 2; k(2, 2) += 2; k(1, 2) -= 2; k(2, 1) -= 2;
+  BOOST_REQUIRE( euclideanDistance(lowRank.solve(), k.gaussianElimination(b)) < 1e-12 );
+
+  // Spring 1 - 2 again: 4 -> 3
+  lowRank.update(1, 1, 2, -1, 0);
+  k(1, 1) -= 1; k(2, 2) -= 1; k(1, 2) += 1; k(2, 1) += 1;
+  BOOST_REQUIRE( lowRank.rank() == 1 );
+  BOOST_REQUIRE( lowRank.contains(1) );
+  BOOST_REQUIRE( !lowRank.contains(0) );
+  BOOST_REQUIRE( euclideanDistance(lowRank.solve(), k.gaussianElimination(b)) < 1e-12 );
+
+  // Spring c - 0 with the prescribed displacement 0.5 at c: 2 -> 6;
+  // the right side gains 2 * 0.5 at node 0 (the constrained end is
+  // the second one: v = e_0 - e_c, c = -0.5)
+  lowRank.update(0, 0, 4, 4, -0.5);
+  k(0, 0) += 4;
+  DVector shifted({2, 0, 0, 1});
+  BOOST_REQUIRE( lowRank.rank() == 2 );
+  BOOST_REQUIRE( euclideanDistance(lowRank.solve(), k.gaussianElimination(shifted)) < 1e-12 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
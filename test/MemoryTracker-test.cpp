@@ -0,0 +1,70 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   MemoryTracker-test.h
+
+   Unit tests for class: MemoryTracker
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include "Profiler.h"
+#include "MemoryTracker.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_MemoryTracker)
+
+// Allocations are tracked and the peak of a phase is recorded
+BOOST_AUTO_TEST_CASE(Test_MemoryTracker_peak)
+{
+  MemoryTracker::enable();
+  Profiler::enable();
+  Profiler::reset();
+
+  std::uint64_t before = MemoryTracker::current();
+  {
+    ScopedTimer timer("allocate");
+    std::vector<double> *v = new std::vector<double>(1 << 16);
+    BOOST_REQUIRE( MemoryTracker::current() >= before + (1 << 16) * sizeof(double) );
+    delete v;
+  }
+
+  BOOST_REQUIRE( MemoryTracker::current() < before + (1 << 16) * sizeof(double) );
+  BOOST_REQUIRE( MemoryTracker::peak() >= before + (1 << 16) * sizeof(double) );
+  BOOST_REQUIRE( Profiler::phasePeakBytes("allocate") >= before + (1 << 16) * sizeof(double) );
+  BOOST_REQUIRE( Profiler::phaseCounter("allocate", Profiler::HEAP_ALLOCATIONS) >= 2 );
+
+  Profiler::reset();
+}
+
+// Projected allocations are checked against the budget
+BOOST_AUTO_TEST_CASE(Test_MemoryTracker_budget)
+{
+  MemoryTracker::setBudget(0);
+  BOOST_REQUIRE( MemoryTracker::checkBudget(std::uint64_t(1) << 40, "nothing") );
+
+  MemoryTracker::setBudget(MemoryTracker::current() + (1 << 20));
+  BOOST_REQUIRE(  MemoryTracker::checkBudget(1 << 10, "a small block") );
+  BOOST_REQUIRE( !MemoryTracker::checkBudget(1 << 21, "a large block") );
+
+  MemoryTracker::setBudget(0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,154 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ModelAnalysis-test.h
+
+   Unit tests for struct: ModelAnalysis
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#include "ModelAnalysis.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_ModelAnalysis)
+
+// A chain with a parallel spring and a separate triangle
+BOOST_AUTO_TEST_CASE(Test_ModelAnalysis_structure)
+{
+  //   0 - 1 = 2 - 3      4 - 5
+  //                       \ /
+  //                        6
+  std::vector<int> node1 = { 0, 1, 1, 2, 4, 5, 6 };
+  std::vector<int> node2 = { 1, 2, 2, 3, 5, 6, 4 };
+  std::vector<bool> constrained = { true, false, false, false, true, false, false };
+
+  ModelAnalysis analysis(7, node1, node2, constrained);
+
+  BOOST_REQUIRE( analysis.nodes == 7 );
+  BOOST_REQUIRE( analysis.springs == 7 );
+  BOOST_REQUIRE( analysis.constrainedNodes == 2 );
+  BOOST_REQUIRE( analysis.dofs == 5 );
+  BOOST_REQUIRE( analysis.nnz == 5 + 2 * 3 );   // 1-2, 2-3, 5-6
+  BOOST_REQUIRE( analysis.bandwidth == 1 );
+  BOOST_REQUIRE( analysis.maxDegree == 2 );
+  BOOST_REQUIRE( analysis.degreeHistogram == std::vector<std::size_t>({ 0, 2, 5 }) );
+  BOOST_REQUIRE( analysis.components == 2 );
+  BOOST_REQUIRE( !analysis.forest );
+  BOOST_REQUIRE( !analysis.chains );
+  BOOST_REQUIRE( analysis.freeForest );   // The constrained node 4 cuts the triangle
+
+  // A spring constant of 0 for 6 - 4: the triangle is open,
+  // node 6 held by 5 alone
+  ModelAnalysis open(7, node1, node2, constrained, { 1, 2, 2, 3, 1, 1, 0 });
+  BOOST_REQUIRE( open.springs == 7 );
+  BOOST_REQUIRE( open.nnz == 5 + 2 * 3 );
+  BOOST_REQUIRE( open.degreeHistogram == std::vector<std::size_t>({ 0, 4, 3 }) );
+  BOOST_REQUIRE( open.components == 2 );
+  BOOST_REQUIRE( open.forest );
+  BOOST_REQUIRE( open.chains );
+
+  // ... and for 0 - 1: node 0 comes loose
+  ModelAnalysis loose(7, node1, node2, constrained, { 0, 2, 2, 3, 1, 1, 0 });
+  BOOST_REQUIRE( loose.components == 3 );
+  BOOST_REQUIRE( loose.degreeHistogram == std::vector<std::size_t>({ 1, 4, 2 }) );
+}
+
+// The choice of the solver
+BOOST_AUTO_TEST_CASE(Test_ModelAnalysis_recommendSolver)
+{
+  std::string reason;
+
+  // A small model
+  ModelAnalysis small(3, { 0, 1 }, { 1, 2 }, { true, false, false });
+  BOOST_REQUIRE( small.chains );
+  BOOST_REQUIRE( small.recommendSolver(reason) == LinearSolver::DENSE );
+
+  // A long chain
+  std::size_t n = 10000;
+  std::vector<int> node1, node2;
+  std::vector<bool> constrained(n, false);
+  constrained[0] = true;
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+      node1.push_back(i);
+      node2.push_back((i + 1) % n);
+    }
+  ModelAnalysis chain(n, node1, node2, constrained);
+  BOOST_REQUIRE( chain.chains );
+  BOOST_REQUIRE( chain.recommendSolver(reason) == LinearSolver::TREE );
+
+  // Closing the chain to a ring: the constrained node 0 cuts it again
+  node1.push_back(n - 1);
+  node2.push_back(0);
+  ModelAnalysis ring(n, node1, node2, constrained);
+  BOOST_REQUIRE( !ring.forest );
+  BOOST_REQUIRE( ring.freeForest );
+  BOOST_REQUIRE( ring.recommendSolver(reason) == LinearSolver::TREE );
+
+  // Springs to the next but one node make it a slim cyclic structure
+  for (std::size_t i = 0; i + 2 < n; ++i)
+    {
+      node1.push_back(i);
+      node2.push_back(i + 2);
+    }
+  ModelAnalysis ladder(n, node1, node2, constrained);
+  BOOST_REQUIRE( !ladder.freeForest );
+  BOOST_REQUIRE( ladder.bandwidth == 2 );
+  BOOST_REQUIRE( ladder.recommendSolver(reason) == LinearSolver::BAND );
+
+  // Long chords make a large, well connected network: 
+  // the preconditioner depends on the spread of the spring constants
+  std::vector<double> k;
+  for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+      node1.push_back(i);
+      node2.push_back((i * 7919) % n);
+    }
+  k.assign(node1.size(), 1.0);
+  ModelAnalysis network(n, node1, node2, constrained, k);
+  BOOST_REQUIRE( network.stiffnessSpread == 1 );
+  BOOST_REQUIRE( network.recommendSolver(reason) == LinearSolver::CG );
+
+  k[0] = 1e4;
+  ModelAnalysis stiff(n, node1, node2, constrained, k);
+  BOOST_REQUIRE( stiff.stiffnessSpread == 1e4 );
+  BOOST_REQUIRE( stiff.recommendSolver(reason) == LinearSolver::TREE_CG );
+
+  // A large grid: too much fill-in for the sparse solver, too many
+  // Jacobi iterations
+  std::size_t m = 600;
+  n = m * m;
+  node1.clear();
+  node2.clear();
+  constrained.assign(n, false);
+  constrained[0] = true;
+  for (std::size_t i = 0; i < n; ++i)
+    {
+      if (i % m + 1 < m) { node1.push_back(i); node2.push_back(i + 1); }
+      if (i + m < n)     { node1.push_back(i); node2.push_back(i + m); }
+    }
+  ModelAnalysis grid(n, node1, node2, constrained);
+  BOOST_REQUIRE( grid.bandwidth == m );
+  BOOST_REQUIRE( grid.recommendSolver(reason) == LinearSolver::AMG_CG );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
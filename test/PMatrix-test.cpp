@@ -0,0 +1,78 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   PMatrix-test.h
+
+   Unit tests for class: PMatrix
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "PMatrix.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_PMatrix)
+
+// Test the symmetric element access
+BOOST_AUTO_TEST_CASE(Test_PMatrix_access)
+{
+  PMatrix m(3);
+  m(0, 0) = 1;
+  m(0, 1) = 2;
+  m(2, 1) = 3;
+  m(2, 2) = 4;
+
+  BOOST_REQUIRE( m.values().size() == 6 );
+  BOOST_REQUIRE( m(1, 0) == 2 );
+  BOOST_REQUIRE( m(1, 2) == 3 );
+  BOOST_REQUIRE( m.toDense() == DMatrix({{1, 2, 0}, {2, 0, 3}, {0, 3, 4}}) );
+
+  BOOST_REQUIRE( m * DVector({1, 2, 3}) == DVector({5, 11, 18}) );
+}
+
+// Test solving a system
+BOOST_AUTO_TEST_CASE(Test_PMatrix_eliminate)
+{
+  DMatrix dense({{ 4, -2,  0},
+		 {-2,  5, -3},
+		 { 0, -3,  7}});
+  PMatrix m(3);
+  for (std::size_t i = 0; i < 3; ++i)
+    for (std::size_t j = i; j < 3; ++j)
+      m(i, j) = dense(i, j);
+
+  DVector b({2, 0, 4});
+  PMatrix u(m);
+  std::size_t pivot;
+  double value;
+  BOOST_REQUIRE( u.eliminate(pivot, value) );
+
+  // The same solution as Gaussian elimination of the full matrix
+  BOOST_REQUIRE( u.eliminateSolve(b) == dense.gaussianElimination(b) );
+  BOOST_REQUIRE( euclideanDistance(m * u.eliminateSolve(b), b) < 1e-14 );
+
+  // A matrix which is not positive definite
+  PMatrix singular(2);
+  singular(0, 0) = 1;
+  singular(0, 1) = -1;
+  singular(1, 1) = 1;
+  BOOST_REQUIRE( !singular.eliminate(pivot, value) );
+  BOOST_REQUIRE( pivot == 1 && value == 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,62 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Profiler-test.h
+
+   Unit tests for class: Profiler
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include "Profiler.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Profiler)
+
+// Counters are attributed to the running phases
+BOOST_AUTO_TEST_CASE(Test_Profiler_phases)
+{
+  Profiler::enable();
+  Profiler::reset();
+
+  {
+    ScopedTimer outer("outer");
+    Profiler::countFlops(3);
+    {
+      ScopedTimer inner("inner");
+      Profiler::countAllocation(16);
+    }
+  }
+
+  BOOST_REQUIRE( Profiler::counter(Profiler::FLOPS) == 3 );
+  BOOST_REQUIRE( Profiler::counter(Profiler::ALLOCATIONS) == 1 );
+  BOOST_REQUIRE( Profiler::counter(Profiler::BYTES) == 16 );
+
+  std::ostringstream json;
+  Profiler::writeJSON(json);
+  
+  BOOST_REQUIRE( json.str().find("\"name\": \"inner\", \"calls\": 1") != std::string::npos );
+  BOOST_REQUIRE( json.str().find("\"bytes\": 16, \"flops\": 0") != std::string::npos );
+  BOOST_REQUIRE( json.str().find("\"bytes\": 16, \"flops\": 3") != std::string::npos );
+
+  Profiler::reset();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,97 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Random-test.h
+
+   Unit tests for class: Random
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <cstdint>
+
+#include "Random.h"
+#include "Statistics.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Random)
+
+// The known answers of the reference implementation (Random123)
+BOOST_AUTO_TEST_CASE(Test_Random_philox)
+{
+  std::uint32_t key[2] = { 0, 0 };
+  std::uint32_t counter[4] = { 0, 0, 0, 0 };
+  Random::philox(key, counter);
+  BOOST_CHECK( counter[0] == 0x6627e8d5 && counter[1] == 0xe169c58d &&
+	       counter[2] == 0xbc57ac4c && counter[3] == 0x9b00dbd8 );
+
+  std::uint32_t ones[2] = { 0xffffffff, 0xffffffff };
+  std::uint32_t counter1[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+  Random::philox(ones, counter1);
+  BOOST_CHECK( counter1[0] == 0x408f276d && counter1[1] == 0x41c83b0e &&
+	       counter1[2] == 0xa20bc7c6 && counter1[3] == 0x6d5451fd );
+
+  std::uint32_t pi[2] = { 0xa4093822, 0x299f31d0 };
+  std::uint32_t counter2[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  Random::philox(pi, counter2);
+  BOOST_CHECK( counter2[0] == 0xd16cfe09 && counter2[1] == 0x94fdcceb &&
+	       counter2[2] == 0x5001e420 && counter2[3] == 0x24126ea1 );
+}
+
+// A stream depends on the seed and its number only
+BOOST_AUTO_TEST_CASE(Test_Random_streams)
+{
+  Random a(42, 7), b(42, 7), c(42, 8), d(43, 7);
+  bool differentStream = false, differentSeed = false;
+  for (int i = 0; i < 100; ++i)
+    {
+      std::uint32_t x = a.next();
+      BOOST_REQUIRE( x == b.next() );
+      differentStream |= x != c.next();
+      differentSeed |= x != d.next();
+    }
+  BOOST_CHECK( differentStream );
+  BOOST_CHECK( differentSeed );
+}
+
+BOOST_AUTO_TEST_CASE(Test_Random_distributions)
+{
+  Random random(1);
+  RunningStatistics uniform, normal, lognormal;
+  for (int i = 0; i < 200000; ++i)
+    {
+      double u = random.uniform();
+      BOOST_REQUIRE( u > 0 && u < 1 );
+      uniform.add(u);
+      normal.add(random.normal());
+      lognormal.add(random.lognormal(5, 0.2));
+    }
+
+  BOOST_CHECK( std::fabs(uniform.mean() - 0.5) < 0.005 );
+  BOOST_CHECK( std::fabs(uniform.variance() - 1.0 / 12) < 0.002 );
+  BOOST_CHECK( std::fabs(normal.mean()) < 0.01 );
+  BOOST_CHECK( std::fabs(normal.deviation() - 1) < 0.01 );
+  BOOST_CHECK( std::fabs(lognormal.mean() - 5) < 0.01 );
+  BOOST_CHECK( std::fabs(lognormal.deviation() - 1) < 0.01 );
+  BOOST_CHECK( lognormal.minimum() > 0 );
+
+  BOOST_CHECK( random.lognormal(0, 0.2) == 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
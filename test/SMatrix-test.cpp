@@ -0,0 +1,80 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SMatrix-test.h
+
+   Unit tests for class: SMatrix
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "SMatrix.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_SMatrix)
+
+// Test building a matrix from triplets
+BOOST_AUTO_TEST_CASE(Test_SMatrix_triplets)
+{
+  // Duplicates are summed up, the order of the triplets does not matter
+  SMatrix m(3, 3, {{2, 2, 1}, {0, 1, 2}, {0, 0, 1}, {2, 2, 4}, {1, 0, 3}, {0, 1, 5}});
+
+  BOOST_REQUIRE( m.nnz() == 4 );
+  BOOST_REQUIRE( m(0, 0) == 1 );
+  BOOST_REQUIRE( m(0, 1) == 7 );
+  BOOST_REQUIRE( m(1, 0) == 3 );
+  BOOST_REQUIRE( m(1, 1) == 0 );
+  BOOST_REQUIRE( m(2, 2) == 5 );
+
+  BOOST_REQUIRE( m.toDense() == DMatrix({{1, 7, 0}, {3, 0, 0}, {0, 0, 5}}) );
+}
+
+// Test matrix vector multiplication
+BOOST_AUTO_TEST_CASE(Test_SMatrix_multiplication_operator)
+{
+  SMatrix m(2, 3, {{0, 0, 1}, {0, 2, 2}, {1, 1, 3}});
+  DVector v({1, 2, 3});
+
+  BOOST_REQUIRE( m * v == DVector({7, 6}) );
+  BOOST_REQUIRE( m.rowProduct(0, v) == 7 );
+  BOOST_REQUIRE( m.rowProduct(1, v) == 6 );
+}
+
+// Test transposition
+BOOST_AUTO_TEST_CASE(Test_SMatrix_transpose)
+{
+  SMatrix m(2, 3, {{0, 0, 1}, {0, 2, 2}, {1, 1, 3}, {1, 2, 4}});
+  SMatrix t = m.transpose();
+
+  BOOST_REQUIRE( t.rows() == 3 && t.cols() == 2 );
+  BOOST_REQUIRE( t.toDense() == DMatrix({{1, 0}, {0, 3}, {2, 4}}) );
+}
+
+// Test matrix matrix multiplication
+BOOST_AUTO_TEST_CASE(Test_SMatrix_matrix_multiplication_operator)
+{
+  SMatrix a(2, 3, {{0, 0, 1}, {0, 2, 2}, {1, 1, 3}});
+  SMatrix b(3, 2, {{0, 1, 1}, {1, 0, 2}, {2, 0, 3}, {2, 1, 4}});
+  SMatrix c = a * b;
+
+  BOOST_REQUIRE( c.rows() == 2 && c.cols() == 2 );
+  BOOST_REQUIRE( c.nnz() == 3 );
+  BOOST_REQUIRE( c.toDense() == DMatrix({{6, 9}, {6, 0}}) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,98 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Statistics-test.h
+
+   Unit tests for class: RunningStatistics, P2Quantile
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "Random.h"
+#include "Statistics.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Statistics)
+
+BOOST_AUTO_TEST_CASE(Test_RunningStatistics)
+{
+  // A large offset: the sum of squares would cancel
+  std::vector<double> values = { 4, 7, 13, 16 };
+  RunningStatistics all, first, second;
+  for (std::size_t i = 0; i < values.size(); ++i)
+    {
+      double x = 1e9 + values[i];
+      all.add(x);
+      (i < 2 ? first : second).add(x);
+    }
+
+  BOOST_CHECK( all.count() == 4 );
+  BOOST_CHECK( all.mean() == 1e9 + 10 );
+  BOOST_CHECK( std::fabs(all.variance() - 30) < 1e-6 );
+  BOOST_CHECK( all.minimum() == 1e9 + 4 );
+  BOOST_CHECK( all.maximum() == 1e9 + 16 );
+
+  first.merge(second);
+  BOOST_CHECK( first.count() == 4 );
+  BOOST_CHECK( first.mean() == all.mean() );
+  BOOST_CHECK( std::fabs(first.variance() - 30) < 1e-6 );
+
+  RunningStatistics none;
+  BOOST_CHECK( none.variance() == 0 );
+  none.merge(all);
+  BOOST_CHECK( none.mean() == all.mean() );
+}
+
+BOOST_AUTO_TEST_CASE(Test_P2Quantile)
+{
+  // Less than five values: interpolated between the sorted values
+  P2Quantile median;
+  BOOST_CHECK( median.quantile() == 0 );
+  for (double x : { 3.0, 1.0, 2.0 }) median.add(x);
+  BOOST_CHECK( median.quantile() == 2 );
+
+  // The quantiles of a normal distribution
+  Random random(7);
+  std::vector<double> probabilities = { 0.05, 0.5, 0.95 };
+  std::vector<P2Quantile> estimators;
+  for (double p : probabilities) estimators.push_back(P2Quantile(p));
+
+  std::vector<double> values;
+  for (int i = 0; i < 100000; ++i)
+    {
+      double x = random.normal();
+      values.push_back(x);
+      for (P2Quantile &estimator : estimators) estimator.add(x);
+    }
+  std::sort(values.begin(), values.end());
+
+  for (std::size_t j = 0; j < probabilities.size(); ++j)
+    {
+      double exact = values[std::size_t(probabilities[j] * values.size())];
+      BOOST_CHECK( estimators[j].count() == values.size() );
+      BOOST_CHECK( std::fabs(estimators[j].quantile() - exact) < 0.02 );
+    }
+  BOOST_CHECK( std::fabs(estimators[0].quantile() + 1.645) < 0.03 );
+  BOOST_CHECK( std::fabs(estimators[2].quantile() - 1.645) < 0.03 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
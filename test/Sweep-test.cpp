@@ -0,0 +1,73 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Sweep-test.h
+
+   Unit tests for class: Sweep
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+
+#include "Sweep.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Sweep)
+
+BOOST_AUTO_TEST_CASE(Test_Sweep_file)
+{
+  Sweep sweep("input-files/example-2-1.sweep");
+
+  BOOST_REQUIRE( sweep.parameters().size() == 2 );
+  BOOST_CHECK( sweep.parameters()[0].kind == Sweep::SPRING_CONSTANT );
+  BOOST_CHECK( sweep.parameters()[0].id == 2 );
+  BOOST_CHECK( sweep.parameters()[1].kind == Sweep::FORCE );
+  BOOST_CHECK( sweep.parameters()[1].id == 4 );
+
+  BOOST_REQUIRE( sweep.outputs().size() == 3 );
+  BOOST_CHECK( sweep.outputs()[0].kind == Sweep::NODE && sweep.outputs()[0].id == 3 );
+  BOOST_CHECK( sweep.outputs()[2].kind == Sweep::SPRING && sweep.outputs()[2].id == 2 );
+
+  // The second parameter changes faster
+  BOOST_REQUIRE( sweep.points() == 15 );
+  BOOST_CHECK( sweep.value(0, 0) == 1000 && sweep.value(1, 0) == 0 );
+  BOOST_CHECK( sweep.value(0, 1) == 1000 && sweep.value(1, 1) == 5000 );
+  BOOST_CHECK( sweep.value(0, 3) == 1500 && sweep.value(1, 3) == 0 );
+  BOOST_CHECK( sweep.value(0, 14) == 3000 && sweep.value(1, 14) == 10000 );
+}
+
+BOOST_AUTO_TEST_CASE(Test_Sweep_points)
+{
+  Sweep sweep;
+  BOOST_CHECK( sweep.points() == 1 );
+
+  sweep.addParameter(Sweep::DISPLACEMENT, 1, 0.5, 0.5, 1);
+  sweep.addParameter(Sweep::FORCE, 2, -1, 1, 4);
+  sweep.addParameter(Sweep::SPRING_CONSTANT, 3, 10, 20, 2);
+  BOOST_REQUIRE( sweep.points() == 8 );
+
+  for (std::size_t point = 0; point < 8; ++point)
+    {
+      BOOST_CHECK( sweep.value(0, point) == 0.5 );
+      BOOST_CHECK( std::fabs(sweep.value(1, point) - (-1 + 2.0 / 3 * (point / 2))) < 1e-15 );
+      BOOST_CHECK( sweep.value(2, point) == (point % 2 ? 20 : 10) );
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,75 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   SymmetricSMatrix-test.h
+
+   Unit tests for class: SymmetricSMatrix
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "SymmetricSMatrix.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_SymmetricSMatrix)
+
+// Test building a matrix from triplets
+BOOST_AUTO_TEST_CASE(Test_SymmetricSMatrix_triplets)
+{
+  // Triplets below the diagonal are mirrored and summed up with the others
+  SymmetricSMatrix m(3, {{0, 0, 1}, {1, 0, 2}, {0, 1, 3}, {2, 1, 4}, {2, 2, 5}});
+
+  BOOST_REQUIRE( m.nnz() == 4 );
+  BOOST_REQUIRE( m.upper().nnz() == 4 );
+  BOOST_REQUIRE( m(0, 1) == 5 && m(1, 0) == 5 );
+  BOOST_REQUIRE( m(1, 2) == 4 && m(2, 1) == 4 );
+  BOOST_REQUIRE( m(1, 1) == 0 );
+
+  DMatrix dense({{1, 5, 0}, {5, 0, 4}, {0, 4, 5}});
+  BOOST_REQUIRE( m.toDense() == dense );
+  BOOST_REQUIRE( m.toPacked().toDense() == dense );
+}
+
+// Test the conversions between full and half storage
+BOOST_AUTO_TEST_CASE(Test_SymmetricSMatrix_full)
+{
+  SMatrix full(4, 4, {{0, 0, 2}, {0, 3, -1}, {1, 1, 3}, {1, 2, -2}, 
+		      {2, 1, -2}, {2, 2, 4}, {3, 0, -1}, {3, 3, 5}});
+  SymmetricSMatrix m(full);
+
+  BOOST_REQUIRE( m.nnz() == 6 );
+  BOOST_REQUIRE( m.toDense() == full.toDense() );
+
+  // The full matrix has sorted rows again
+  SMatrix expanded = m.toFull();
+  BOOST_REQUIRE( expanded.rowStart() == full.rowStart() );
+  BOOST_REQUIRE( expanded.colIndex() == full.colIndex() );
+  BOOST_REQUIRE( expanded.values() == full.values() );
+}
+
+// Test matrix vector multiplication
+BOOST_AUTO_TEST_CASE(Test_SymmetricSMatrix_multiplication_operator)
+{
+  SymmetricSMatrix m(3, {{0, 0, 1}, {0, 1, 2}, {1, 2, 3}, {2, 2, 4}});
+  DVector v({1, 2, 3});
+
+  BOOST_REQUIRE( m * v == m.toFull() * v );
+  BOOST_REQUIRE( m * v == DVector({5, 11, 18}) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
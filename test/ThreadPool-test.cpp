@@ -0,0 +1,64 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   ThreadPool-test.h
+
+   Unit tests for class: ThreadPool
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+#include <atomic>
+
+#include "ThreadPool.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_ThreadPool)
+
+// Every index is visited exactly once
+BOOST_AUTO_TEST_CASE(Test_ThreadPool_parallelFor)
+{
+  ThreadPool pool(4);
+  
+  std::vector<int> visited(10000, 0);
+  pool.parallelFor(visited.size(), 100, [&visited] (std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i) ++visited[i];
+    });
+
+  for (auto v : visited)
+    BOOST_REQUIRE( v == 1 );
+}
+
+// Parallel loops can be nested
+BOOST_AUTO_TEST_CASE(Test_ThreadPool_nested)
+{
+  ThreadPool pool(4);
+
+  std::atomic<int> sum(0);
+  pool.parallelFor(16, 1, [&pool, &sum] (std::size_t begin, std::size_t end) {
+      for (std::size_t i = begin; i < end; ++i)
+	pool.parallelFor(100, 1, [&sum] (std::size_t begin, std::size_t end) {
+	    sum += end - begin;
+	  });
+    });
+
+  BOOST_REQUIRE( sum == 1600 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
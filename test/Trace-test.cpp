@@ -0,0 +1,62 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   Trace-test.h
+
+   Unit tests for class: Trace
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <thread>
+
+#include "Trace.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_Trace)
+
+// Events of all threads are written
+BOOST_AUTO_TEST_CASE(Test_Trace_write)
+{
+  Trace::enable(4);
+
+  {
+    TraceScope scope("main thread scope");
+  }
+
+  // More events than fit into the ring buffer:
+  // only the last four are kept
+  std::thread thread([] () {
+      for (int i = 0; i < 8; ++i)
+	{
+	  TraceScope scope(i < 6 ? "overwritten" : "other thread scope");
+	}
+    });
+  thread.join();
+
+  std::ostringstream trace;
+  Trace::write(trace);
+
+  BOOST_REQUIRE( trace.str().find("{\"name\": \"main thread scope\", \"ph\": \"B\"") != std::string::npos );
+  BOOST_REQUIRE( trace.str().find("{\"name\": \"main thread scope\", \"ph\": \"E\"") != std::string::npos );
+  BOOST_REQUIRE( trace.str().find("{\"name\": \"other thread scope\", \"ph\": \"B\"") != std::string::npos );
+  BOOST_REQUIRE( trace.str().find("overwritten") == std::string::npos );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
@@ -0,0 +1,49 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+   
+   UnionFind-test.h
+
+   Unit tests for class: UnionFind
+   
+   Copyright (c) 2015 Dietrich Bollmann
+   
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+#include <boost/test/unit_test.hpp>
+
+#include "UnionFind.h"
+
+namespace nsl {
+
+BOOST_AUTO_TEST_SUITE(TestSuite_UnionFind)
+
+BOOST_AUTO_TEST_CASE(Test_UnionFind_unite)
+{
+  UnionFind sets(6);
+  BOOST_REQUIRE( sets.size() == 6 );
+  BOOST_REQUIRE( sets.sets() == 6 );
+
+  BOOST_REQUIRE( sets.unite(0, 1) );
+  BOOST_REQUIRE( sets.unite(2, 3) );
+  BOOST_REQUIRE( sets.unite(1, 3) );
+  BOOST_REQUIRE( !sets.unite(0, 2) );      // Already in the same set
+
+  BOOST_REQUIRE( sets.sets() == 3 );
+  BOOST_REQUIRE( sets.find(0) == sets.find(3) );
+  BOOST_REQUIRE( sets.find(0) != sets.find(4) );
+  BOOST_REQUIRE( sets.setSize(2) == 4 );
+  BOOST_REQUIRE( sets.setSize(5) == 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace nsl
+
+/* fin */
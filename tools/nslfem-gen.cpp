@@ -0,0 +1,168 @@
+// -*- mode: C++ -*-
+/**
+   Dietrich Bollmann, Kamakura, 2015/01/01
+
+   nslfem-gen.cpp
+
+   nslfem-gen: generator of synthetic FEM definition files.
+
+   Usage: see help() or `bin/nslfem-gen --help'.
+
+   Copyright (c) 2015 Dietrich Bollmann
+
+   This software may be modified and distributed under the terms
+   of the MIT license.  See the LICENSE file for details.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+
+#include "Generator.h"
+
+/**
+   Print help text.
+ */
+void help()
+{
+  std::cout
+    << "Usage: nslfem-gen [options]" << std::endl
+    << std::endl
+    << "Writes a synthetic spring assemblage as FEM definition file." << std::endl
+    << std::endl
+    << "Options:" << std::endl
+    << std::endl
+    << "  -h, --help                Print this help text" << std::endl
+    << "  --topology=<t>            chain, bundle, tree, grid or random (default: chain)" << std::endl
+    << "  --nodes=<n>               Number of nodes (default: 100)" << std::endl
+    << "  --seed=<n>                Seed of the random numbers (default: 1)" << std::endl
+    << "  --bundle-width=<n>        Parallel springs per link of a bundle (default: 3)" << std::endl
+    << "  --branching=<n>           Children per node of a tree (default: 2)" << std::endl
+    << "  --degree=<d>              Average node degree of a random network (default: 4)" << std::endl
+    << "  --constraints=<p>         Probability of a node to be fixed (default: 0;" << std::endl
+    << "                            the first node is always fixed)" << std::endl
+    << "  --loads=<pattern>         end, uniform or random (default: end)" << std::endl
+    << "  --shuffle                 Permute the node numbers randomly" << std::endl
+    << "  --format=fem              Output format (only the FEM definition file" << std::endl
+    << "                            format is supported)" << std::endl
+    << "  --output=<file>           Output file (default: stdout)" << std::endl
+    ;
+}
+
+/**
+   Value of an option of the form --name=value.
+*/
+bool option(const char *arg, const char *name, std::string &value)
+{
+  std::size_t n = strlen(name);
+  if (strncmp(arg, name, n) != 0 || arg[n] != '=') return false;
+
+  value = arg + n + 1;
+  return true;
+}
+
+/**
+   Main.
+ */
+int main(int argc, char* argv[])
+{
+  nsl::Generator::Topology topology = nsl::Generator::CHAIN;
+  nsl::Generator::LoadPattern loads = nsl::Generator::END;
+  std::size_t nodes       = 100;
+  unsigned long long seed = 1;
+  std::size_t bundleWidth = 3;
+  std::size_t branching   = 2;
+  double degree           = 4;
+  double constraints      = 0;
+  bool shuffle            = false;
+  std::string output;
+
+  // Parse command-line arguments
+  std::string value;
+  for (int i = 1; i < argc; ++i)
+    {
+      const char *arg = argv[i];
+
+      if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0)
+	{
+	  help();
+	  exit(EXIT_SUCCESS);
+	}
+      else if (option(arg, "--topology", value))
+	{
+	  if (!nsl::Generator::parseTopology(value, topology))
+	    {
+	      std::cerr << "ERROR: Unknown topology: " << value << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (option(arg, "--loads", value))
+	{
+	  if (!nsl::Generator::parseLoadPattern(value, loads))
+	    {
+	      std::cerr << "ERROR: Unknown load pattern: " << value << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (option(arg, "--format", value))
+	{
+	  if (value != "fem")
+	    {
+	      std::cerr << "ERROR: Unsupported output format: " << value << std::endl;
+	      exit(EXIT_FAILURE);
+	    }
+	}
+      else if (option(arg, "--nodes", value))        nodes       = std::stoull(value);
+      else if (option(arg, "--seed", value))         seed        = std::stoull(value);
+      else if (option(arg, "--bundle-width", value)) bundleWidth = std::stoull(value);
+      else if (option(arg, "--branching", value))    branching   = std::stoull(value);
+      else if (option(arg, "--degree", value))       degree      = std::stod(value);
+      else if (option(arg, "--constraints", value))  constraints = std::stod(value);
+      else if (option(arg, "--output", value))       output      = value;
+      else if (strcmp(arg, "--shuffle") == 0)        shuffle     = true;
+      else
+	{
+	  std::cerr << "ERROR: Unknown option: " << arg << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+    }
+
+  // Configure the generator
+  nsl::Generator generator(topology, nodes, seed);
+  generator.setBundleWidth(bundleWidth);
+  generator.setBranching(branching);
+  generator.setAverageDegree(degree);
+  generator.setConstraintDensity(constraints);
+  generator.setLoadPattern(loads);
+  generator.setShuffle(shuffle);
+
+  // Write the model
+  // (with a large buffer - the model is written in one pass)
+  std::vector<char> buffer(1 << 20);
+  if (output.empty())
+    {
+      std::cout.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+      std::ios_base::sync_with_stdio(false);
+      generator.write(std::cout);
+      std::cout.flush();
+    }
+  else
+    {
+      std::ofstream out;
+      out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+      out.open(output);
+      if (!out.good())
+	{
+	  std::cerr << "ERROR: Could not open output file: " << output << std::endl;
+	  exit(EXIT_FAILURE);
+	}
+      generator.write(out);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+/* fin */